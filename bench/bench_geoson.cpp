@@ -0,0 +1,280 @@
+// Throughput benchmarks over synthetic field files, from 1k up to 10M coordinates.
+//
+//   bench_geoson [max_coordinates] [results.json]
+//
+// `max_coordinates` caps the size ladder (default 10M); with `results.json` the measurements are also written in
+// nanobench's JSON format, for comparing one build against another.
+
+#include <nanobench.h>
+
+#include "geoson/geoson.hpp"
+#include "geoson/vector.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    const concord::Datum datum{52.0, 5.0, 0.0};
+
+    constexpr size_t ring_size = 32; // vertices per polygon and per path
+    constexpr double spacing = 20.0; // metres between neighbouring features
+
+    /// A field boundary followed by rows (paths), obstacles (polygons) and markers (points) laid out on a grid,
+    /// in that rotation, until the collection holds about `coordinates` positions.
+    geoson::FeatureCollection makeCollection(size_t coordinates) {
+        const size_t features = std::max<size_t>(3, coordinates / ((2 * ring_size + 1) / 3));
+        const size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(features))));
+        const double extent = side * spacing;
+
+        geoson::FeatureCollection fc;
+        fc.datum = datum;
+        fc.heading = concord::Euler{0, 0, 0};
+        fc.global_properties["name"] = "bench";
+        fc.features.reserve(features + 1);
+
+        fc.features.push_back({concord::Polygon({{0, 0, 0}, {extent, 0, 0}, {extent, extent, 0}, {0, extent, 0}}),
+                               {{"type", "field"}}});
+
+        for (size_t i = 0; i < features; ++i) {
+            const double cx = (i % side) * spacing + spacing / 2, cy = (i / side) * spacing + spacing / 2;
+            geoson::Properties props;
+            props["id"] = static_cast<int64_t>(i);
+            switch (i % 3) {
+            case 0: {
+                std::vector<concord::Point> pts;
+                for (size_t k = 0; k < ring_size; ++k)
+                    pts.push_back({cx - 8 + 16.0 * k / ring_size, cy + 0.5 * std::sin(0.3 * k), 0.1 * k});
+                props["type"] = "row";
+                props["width"] = 0.75;
+                fc.features.push_back({concord::Path(std::move(pts)), std::move(props)});
+                break;
+            }
+            case 1: {
+                std::vector<concord::Point> pts;
+                for (size_t k = 0; k < ring_size; ++k) {
+                    const double a = 2 * M_PI * k / ring_size;
+                    pts.push_back({cx + 4 * std::cos(a), cy + 4 * std::sin(a), 0.0});
+                }
+                props["type"] = "obstacle";
+                props["kind"] = (i % 2) ? "tree" : "pole";
+                fc.features.push_back({concord::Polygon(std::move(pts)), std::move(props)});
+                break;
+            }
+            default:
+                props["type"] = "marker";
+                props["visited"] = (i % 4) == 0;
+                fc.features.push_back({concord::Point{cx, cy, 0.0}, std::move(props)});
+            }
+        }
+        return fc;
+    }
+
+    size_t countCoordinates(const geoson::FeatureCollection &fc) {
+        size_t n = 0;
+        for (const auto &f : fc.features)
+            std::visit(
+                [&](const auto &g) {
+                    using T = std::decay_t<decltype(g)>;
+                    if constexpr (std::is_same_v<T, concord::Point>)
+                        n += 1;
+                    else if constexpr (std::is_same_v<T, concord::Line>)
+                        n += 2;
+                    else
+                        n += g.getPoints().size();
+                },
+                f.geometry);
+        return n;
+    }
+
+    std::string slurp(const std::filesystem::path &path) {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    /// results are reported per coordinate; the big collections are measured over fewer epochs
+    void configure(ankerl::nanobench::Bench &bench, const std::string &title, size_t coordinates) {
+        bench.title(title).unit("coordinate").batch(static_cast<double>(coordinates));
+        bench.epochs(coordinates >= 1000000 ? 3 : 11);
+    }
+
+    void benchReadWrite(ankerl::nanobench::Bench &bench, const geoson::FeatureCollection &fc,
+                        const std::filesystem::path &dir) {
+        using namespace geoson;
+        const auto enu_file = dir / "enu.geojson", wgs_file = dir / "wgs.geojson", out_file = dir / "out.geojson";
+        WriteFeatureCollection(fc, enu_file, CRS::ENU, WriteOptions::compact());
+        WriteFeatureCollection(fc, wgs_file, CRS::WGS, WriteOptions::compact());
+        const std::string enu_text = slurp(enu_file), wgs_text = slurp(wgs_file);
+
+        bench.run("read ENU (buffer)", [&] { ankerl::nanobench::doNotOptimizeAway(read_from_buffer(enu_text)); });
+        bench.run("read WGS (buffer)", [&] { ankerl::nanobench::doNotOptimizeAway(read_from_buffer(wgs_text)); });
+        bench.run("read ENU (file)", [&] { ankerl::nanobench::doNotOptimizeAway(read(enu_file)); });
+        bench.run("read ENU (file, all threads)", [&] {
+            ReadOptions opts;
+            opts.threads = 0;
+            ankerl::nanobench::doNotOptimizeAway(read(enu_file, opts));
+        });
+        bench.run("stream ENU (FeatureReader)", [&] {
+            FeatureReader reader(enu_file);
+            Feature feature;
+            size_t n = 0;
+            while (reader.next(feature))
+                ++n;
+            ankerl::nanobench::doNotOptimizeAway(n);
+        });
+        bench.run("header only", [&] { ankerl::nanobench::doNotOptimizeAway(ReadCollectionHeader(enu_file)); });
+        bench.run("lazy index ENU (file)", [&] {
+            auto lc = LazyCollection::open(enu_file);
+            ankerl::nanobench::doNotOptimizeAway(lc.features(lc.size() / 2));
+        });
+
+        bench.run("write ENU (compact)", [&] { write(fc, out_file, CRS::ENU, WriteOptions::compact()); });
+        bench.run("write WGS (compact)", [&] { write(fc, out_file, CRS::WGS, WriteOptions::compact()); });
+        bench.run("write ENU (pretty)", [&] { write(fc, out_file, CRS::ENU); });
+        bench.run("write ENU (string)", [&] {
+            std::ostringstream os;
+            WriteFeatureCollection(fc, os);
+            ankerl::nanobench::doNotOptimizeAway(os);
+        });
+
+        const auto bin_file = dir / "collection.gsb";
+        bench.run("write binary", [&] { WriteBinaryCollection(fc, bin_file); });
+        bench.run("open binary", [&] { ankerl::nanobench::doNotOptimizeAway(BinaryCollection::open(bin_file)); });
+        bench.run("read binary (FeatureCollection)",
+                  [&] { ankerl::nanobench::doNotOptimizeAway(ReadBinaryCollection(bin_file)); });
+    }
+
+    void benchTransform(ankerl::nanobench::Bench &bench, size_t coordinates) {
+        const geoson::DatumTransform tf(datum);
+        std::vector<concord::Point> pts(coordinates);
+        for (size_t i = 0; i < coordinates; ++i)
+            pts[i] = concord::Point{(i % 1000) * 0.5, (i / 1000) * 0.5, 1.0};
+
+        // each pass converts the points back, so every run starts from the same coordinates
+        bench.run("CRS ENU -> WGS -> ENU", [&] {
+            tf.toWGS(pts.data(), pts.size());
+            tf.toENU(pts.data(), pts.size());
+            ankerl::nanobench::doNotOptimizeAway(pts.front());
+        });
+    }
+
+    void benchVector(ankerl::nanobench::Bench &bench, const geoson::FeatureCollection &fc,
+                     const std::filesystem::path &dir) {
+        using namespace geoson;
+        const auto in_file = dir / "vector.geojson", out_file = dir / "vector_out.geojson";
+        write(fc, in_file, CRS::ENU, WriteOptions::compact());
+
+        bench.run("Vector::fromFile", [&] { ankerl::nanobench::doNotOptimizeAway(Vector::fromFile(in_file)); });
+        const Vector vector = Vector::fromFile(in_file);
+        bench.run("Vector::toFile", [&] { vector.toFile(out_file, CRS::ENU, WriteOptions::compact()); });
+
+        Vector bulk = vector;
+        const concord::Datum corrected{datum.lat + 1e-5, datum.lon - 1e-5, datum.alt + 0.5};
+        bench.run("Vector::reproject", [&] {
+            bulk.reproject(bulk.getDatum().lat == datum.lat ? corrected : datum);
+        });
+        bench.run("Vector::reproject (1 thread)", [&] {
+            bulk.reproject(bulk.getDatum().lat == datum.lat ? corrected : datum, 1);
+        });
+        bench.run("Vector::translate", [&] { bulk.translate(0.5, -0.5); });
+        bench.run("Vector::bounds", [&] { ankerl::nanobench::doNotOptimizeAway(bulk.bounds()); });
+        bench.run("Vector::simplify (5 cm)", [&] {
+            Vector copy = vector;
+            copy.simplify(0.05);
+            ankerl::nanobench::doNotOptimizeAway(copy);
+        });
+    }
+
+    /// per-query costs, reported per call rather than per coordinate
+    void benchQueries(ankerl::nanobench::Bench &bench, const geoson::FeatureCollection &fc) {
+        using namespace geoson;
+        const Vector vector = Vector::fromFeatureCollection(fc);
+        const auto &field = vector.getFieldBoundary().getPoints();
+        const double extent = field.empty() ? 0.0 : field[2].x;
+        const concord::Point centre{extent / 2, extent / 2, 0};
+
+        bench.batch(1).unit("query");
+        (void)vector.elementsInBox(centre, centre); // build the R-tree outside the timings
+
+        bench.run("elementsInBox (100 m)", [&] {
+            ankerl::nanobench::doNotOptimizeAway(vector.elementsInBox({centre.x - 50, centre.y - 50, 0},
+                                                                      {centre.x + 50, centre.y + 50, 0}));
+        });
+        bench.run("elementsWithin (25 m)",
+                  [&] { ankerl::nanobench::doNotOptimizeAway(vector.elementsWithin(centre, 25.0)); });
+        bench.run("nearestElements (k=10)",
+                  [&] { ankerl::nanobench::doNotOptimizeAway(vector.nearestElements(centre, 10)); });
+        bench.run("indicesOfType", [&] { ankerl::nanobench::doNotOptimizeAway(vector.indicesOfType("marker")); });
+        bench.run("getElementsByType", [&] {
+            ankerl::nanobench::doNotOptimizeAway(vector.getElementsByType("obstacle"));
+        });
+        bench.run("indicesWithProperty (scan)", [&] {
+            ankerl::nanobench::doNotOptimizeAway(vector.indicesWithProperty("kind", "tree"));
+        });
+        bench.run("viewElementsByType (count)", [&] {
+            size_t n = 0;
+            for (const auto &e : vector.viewElementsByType("row"))
+                n += e.properties.size();
+            ankerl::nanobench::doNotOptimizeAway(n);
+        });
+
+        // a live map: drop the oldest detection, add a fresh one, query; the indexes are updated, not rebuilt
+        Vector live = vector;
+        std::deque<ElementHandle> detections;
+        for (size_t i = 0; i < live.elementCount() && detections.size() < 1000; ++i)
+            detections.push_back(live.handleAt(i));
+        (void)live.elementsInBox(centre, centre);
+        (void)live.indicesOfType("obstacle");
+        double t = 0.0;
+        bench.run("remove + add + query", [&] {
+            if (!detections.empty()) {
+                live.removeElement(detections.front());
+                detections.pop_front();
+            }
+            t += 1.0;
+            detections.push_back(live.addPoint({std::fmod(t, extent + 1.0), centre.y, 0}, "obstacle"));
+            ankerl::nanobench::doNotOptimizeAway(live.elementsWithin(centre, 25.0));
+            ankerl::nanobench::doNotOptimizeAway(live.indicesOfType("obstacle"));
+        });
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const size_t max_coordinates = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "geoson_bench";
+    std::filesystem::create_directories(dir);
+
+    ankerl::nanobench::Bench bench;
+    for (size_t target = 1000; target <= max_coordinates; target *= 10) {
+        const auto fc = makeCollection(target);
+        const size_t coordinates = countCoordinates(fc);
+        const std::string size = std::to_string(target);
+
+        configure(bench, "io " + size, coordinates);
+        benchReadWrite(bench, fc, dir);
+        benchVector(bench, fc, dir);
+
+        configure(bench, "transform " + size, coordinates);
+        benchTransform(bench, coordinates);
+
+        configure(bench, "query " + size, coordinates);
+        benchQueries(bench, fc);
+    }
+
+    std::filesystem::remove_all(dir);
+
+    if (argc > 2) {
+        std::ofstream out(argv[2]);
+        ankerl::nanobench::render(ankerl::nanobench::templates::json(), bench, out);
+    }
+    return 0;
+}
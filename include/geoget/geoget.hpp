@@ -1,19 +1,32 @@
 #pragma once
 
 #include "concord/concord.hpp"
+#include "geoson/transform.hpp"
 #include <arpa/inet.h>
-#include <condition_variable>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <functional>
 #include <iostream>
-#include <mutex>
+#include <map>
+#include <memory>
 #include <netinet/in.h>
 #include <nlohmann/json.hpp>
+#include <poll.h>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <strings.h>
 #include <sys/socket.h>
-#include <thread>
 #include <unistd.h>
 #include <vector>
 
+#if GEOSON_USE_ZLIB
+#include <zlib.h>
+#endif
+
 namespace geoget {
 
     using json = nlohmann::json;
@@ -23,28 +36,337 @@ namespace geoget {
         double lon;
     };
 
+    namespace http {
+        /// One parsed request. `keep_alive` follows HTTP/1.1 defaults and the Connection header.
+        struct Request {
+            std::string method;
+            std::string path;
+            std::string body;
+            bool keep_alive = true;
+            bool accepts_gzip = false;
+            std::string if_none_match;
+        };
+
+        /// A handler's answer; `serialize` adds the framing headers.
+        struct Response {
+            std::string status = "200 OK";
+            std::string content_type = "application/json";
+            std::string body;
+            std::string headers; // extra header lines, each ending in \r\n
+
+            static Response json(std::string body) { return {"200 OK", "application/json", std::move(body), {}}; }
+            static Response error(std::string status, std::string body) {
+                return {std::move(status), "text/plain", std::move(body), {}};
+            }
+
+            std::string serialize(bool keep_alive) const {
+                std::string out = "HTTP/1.1 " + status + "\r\nContent-Type: " + content_type +
+                                  "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n" + headers +
+                                  (keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
+                out += body;
+                return out;
+            }
+        };
+
+        enum class Parse { incomplete, complete, bad };
+
+        inline bool iequals(std::string_view a, std::string_view b) {
+            return a.size() == b.size() && strncasecmp(a.data(), b.data(), a.size()) == 0;
+        }
+
+        inline std::string_view trim(std::string_view s) {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+                s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+                s.remove_suffix(1);
+            return s;
+        }
+
+        /// Whether an Accept-Encoding value allows gzip: a `gzip` (or `x-gzip`) coding, or else `*`, with a
+        /// weight above 0. Codings are matched whole, so `x-gzip-foo` does not count.
+        inline bool accepts_gzip(std::string_view value) {
+            int gzip = -1, any = -1; // -1 not listed, 0 refused (q=0), 1 accepted
+            while (!value.empty()) {
+                const auto comma = value.find(',');
+                std::string_view item = value.substr(0, comma);
+                value = comma == std::string_view::npos ? std::string_view{} : value.substr(comma + 1);
+
+                const auto semi = item.find(';');
+                const std::string_view coding = trim(item.substr(0, semi));
+                bool allowed = true;
+                for (auto params = semi == std::string_view::npos ? std::string_view{} : item.substr(semi + 1);
+                     !params.empty();) {
+                    const auto next = params.find(';');
+                    const std::string_view param = trim(params.substr(0, next));
+                    params = next == std::string_view::npos ? std::string_view{} : params.substr(next + 1);
+                    if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+                        allowed = std::strtod(std::string(param.substr(2)).c_str(), nullptr) > 0.0;
+                }
+                if (iequals(coding, "gzip") || iequals(coding, "x-gzip"))
+                    gzip = allowed;
+                else if (coding == "*")
+                    any = allowed;
+            }
+            return gzip >= 0 ? gzip == 1 : any == 1;
+        }
+
+        /// Whether an If-None-Match value names `etag`: `*`, or any tag in the list under weak comparison
+        /// (a `W/` prefix on either side is ignored).
+        inline bool matches_etag(std::string_view value, std::string_view etag) {
+            if (etag.substr(0, 2) == "W/")
+                etag.remove_prefix(2);
+            if (trim(value) == "*")
+                return true;
+            for (value = trim(value); !value.empty();) {
+                if (value.substr(0, 2) == "W/")
+                    value.remove_prefix(2);
+                if (value.empty() || value.front() != '"')
+                    return false;
+                const auto close = value.find('"', 1); // entity tags cannot contain quotes, but may contain commas
+                if (close == std::string_view::npos)
+                    return false;
+                if (value.substr(0, close + 1) == etag)
+                    return true;
+                value = trim(value.substr(close + 1));
+                if (!value.empty() && value.front() != ',')
+                    return false;
+                while (!value.empty() && (value.front() == ',' || value.front() == ' ' || value.front() == '\t'))
+                    value.remove_prefix(1);
+            }
+            return false;
+        }
+
+        /// Takes the first complete request off the front of `in`. Requests may arrive split across any number
+        /// of reads, or several in one read; whatever follows a complete request is left in `in`.
+        inline Parse take_request(std::string &in, Request &req) {
+            constexpr std::size_t max_head = 16 * 1024, max_body = 1024 * 1024;
+            auto head_end = in.find("\r\n\r\n");
+            if (head_end == std::string::npos)
+                return in.size() > max_head ? Parse::bad : Parse::incomplete;
+
+            std::string_view head(in.data(), head_end);
+            auto line_end = head.find("\r\n");
+            std::istringstream request_line(std::string(head.substr(0, line_end)));
+            std::string version;
+            req = Request{};
+            if (!(request_line >> req.method >> req.path >> version))
+                return Parse::bad;
+            req.keep_alive = version != "HTTP/1.0";
+
+            std::size_t content_length = 0;
+            while (line_end != std::string_view::npos) {
+                auto start = line_end + 2;
+                line_end = head.find("\r\n", start);
+                auto line = head.substr(start, line_end == std::string_view::npos ? head.size() - start
+                                                                                  : line_end - start);
+                auto colon = line.find(':');
+                if (colon == std::string_view::npos)
+                    continue;
+                auto name = line.substr(0, colon);
+                auto value = line.substr(colon + 1);
+                while (!value.empty() && value.front() == ' ')
+                    value.remove_prefix(1);
+                if (iequals(name, "Content-Length")) {
+                    content_length = std::strtoull(std::string(value).c_str(), nullptr, 10);
+                } else if (iequals(name, "Connection")) {
+                    if (iequals(value, "close"))
+                        req.keep_alive = false;
+                    else if (iequals(value, "keep-alive"))
+                        req.keep_alive = true;
+                } else if (iequals(name, "Accept-Encoding")) {
+                    req.accepts_gzip = accepts_gzip(value);
+                } else if (iequals(name, "If-None-Match")) {
+                    req.if_none_match = value;
+                }
+            }
+            if (content_length > max_body)
+                return Parse::bad;
+
+            auto body_start = head_end + 4;
+            if (in.size() < body_start + content_length)
+                return Parse::incomplete;
+            req.body = in.substr(body_start, content_length);
+            in.erase(0, body_start + content_length);
+            return Parse::complete;
+        }
+
+        /// gzip-compressed `data`; empty when built without zlib (`GEOSON_USE_ZLIB`) or if compression fails
+        inline std::string gzip(const std::string &data) {
+#if GEOSON_USE_ZLIB
+            z_stream zs{};
+            if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                return {};
+            std::string out(deflateBound(&zs, static_cast<uLong>(data.size())), '\0');
+            zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+            zs.avail_in = static_cast<uInt>(data.size());
+            zs.next_out = reinterpret_cast<Bytef *>(out.data());
+            zs.avail_out = static_cast<uInt>(out.size());
+            const bool ok = deflate(&zs, Z_FINISH) == Z_STREAM_END;
+            out.resize(zs.total_out);
+            deflateEnd(&zs);
+            return ok ? out : std::string{};
+#else
+            (void)data;
+            return {};
+#endif
+        }
+
+        /// A static document with its complete responses serialised once, so serving it is a single append.
+        /// Browsers revalidate it with its ETag (answered by a bodiless 304); with zlib it also goes out gzipped
+        /// to clients that accept that.
+        class StaticPage {
+          public:
+            StaticPage(const std::string &content_type, std::string body) {
+                etag_ = "\"" + std::to_string(std::hash<std::string>{}(body)) + "\"";
+                const std::string headers = "ETag: " + etag_ + "\r\nCache-Control: no-cache\r\n";
+                const std::string compressed = gzip(body);
+                for (bool keep_alive : {false, true}) {
+                    plain_[keep_alive] =
+                        Response{"200 OK", content_type, body, headers + "Vary: Accept-Encoding\r\n"}.serialize(
+                            keep_alive);
+                    gzipped_[keep_alive] =
+                        compressed.empty()
+                            ? plain_[keep_alive]
+                            : Response{"200 OK", content_type, compressed,
+                                       headers + "Vary: Accept-Encoding\r\nContent-Encoding: gzip\r\n"}
+                                  .serialize(keep_alive);
+                    not_modified_[keep_alive] = Response{"304 Not Modified", content_type, {}, headers}.serialize(
+                        keep_alive);
+                }
+            }
+
+            /// appends the right response for `req` to `out`
+            void serve(const Request &req, bool keep_alive, std::string &out) const {
+                if (!req.if_none_match.empty() && matches_etag(req.if_none_match, etag_))
+                    out += not_modified_[keep_alive];
+                else
+                    out += req.accepts_gzip ? gzipped_[keep_alive] : plain_[keep_alive];
+            }
+
+            const std::string &etag() const { return etag_; }
+
+          private:
+            std::string etag_;
+            std::string plain_[2], gzipped_[2], not_modified_[2]; // indexed by keep-alive
+        };
+    } // namespace http
+
+    /// Puts numbered events back in order. The page numbers its posts from 0 on every load (`session`), but the
+    /// fetches travel over several keep-alive connections and can overtake each other. `push` applies an event
+    /// once every lower number has been applied and holds early arrivals until then, so ordering costs one map
+    /// insert for an event that overtook another and nothing otherwise. Not synchronised: it belongs to the
+    /// thread running the event loop.
+    template <typename Event> class Sequencer {
+      public:
+        using clock = std::chrono::steady_clock;
+
+        template <typename Apply> void push(const std::string &session, std::uint64_t seq, Event event, Apply &&apply) {
+            if (session != session_) {
+                flush(apply); // a reloaded page counts from 0 again
+                session_ = session;
+                next_ = 0;
+            }
+            if (seq > next_) {
+                if (held_.empty())
+                    gap_since_ = clock::now();
+                held_.emplace(seq, std::move(event));
+                return;
+            }
+            apply(std::move(event)); // in order, or a straggler from before a flush
+            if (seq == next_)
+                ++next_;
+            while (!held_.empty() && held_.begin()->first == next_) {
+                apply(std::move(held_.begin()->second));
+                held_.erase(held_.begin());
+                ++next_;
+            }
+            gap_since_ = clock::now();
+        }
+
+        /// events are held back waiting for a lower number
+        bool waiting() const { return !held_.empty(); }
+
+        /// the oldest gap has been open for at least `limit`
+        bool stalled(clock::duration limit) const { return waiting() && clock::now() - gap_since_ >= limit; }
+
+        /// gives up on the gaps and applies everything held, in order
+        template <typename Apply> void flush(Apply &&apply) {
+            for (auto &[seq, event] : held_) {
+                apply(std::move(event));
+                next_ = seq + 1;
+            }
+            held_.clear();
+        }
+
+      private:
+        std::string session_;
+        std::uint64_t next_ = 0;
+        std::map<std::uint64_t, Event> held_;
+        clock::time_point gap_since_;
+    };
+
     class PolygonDrawer {
       private:
+        /// an open client socket with its unparsed input and unsent output
+        struct Connection {
+            int fd;
+            std::uint64_t id;
+            std::string in;
+            std::string out;
+            bool close_after = false; // once `out` has drained
+            bool awaiting = false;    // its current request is a capture event that has not been applied yet
+            bool resume = false;      // that event was applied; parse whatever followed it
+        };
+
+        /// a capture request from the page (/api/addpoint, /api/done, ...), applied in the page's post order
+        struct CaptureEvent {
+            std::string path;
+            Point point{};
+            std::vector<Point> ring; // /api/setpoints: the whole current shape at once
+            std::uint64_t connection; // the reply goes back here once the event is applied
+            bool keep_alive;
+        };
+
+        // All capture state below is owned by the thread running serve(): requests are handled on the event loop
+        // and capture events are applied through `sequencer`, so none of it needs a lock.
         int server_fd;
+        std::vector<Connection> connections;
+        std::uint64_t next_connection_id = 0;
+        Sequencer<CaptureEvent> sequencer;
         std::vector<Point> points;
         std::vector<std::vector<Point>> all_polygons;
         std::vector<Point> all_single_points;
         bool is_done;
-        std::mutex done_mutex;
-        std::condition_variable done_cv;
         bool single_point_mode;
         concord::Datum datum;
+        std::shared_ptr<const geoson::DatumTransform> transform_;
         bool select_point;
 
-        std::string get_html() {
-            if (single_point_mode) {
-                return get_single_point_html();
-            } else {
-                return get_polygon_html();
-            }
+        /// transform for the current datum, refreshed whenever the datum has been changed
+        const geoson::DatumTransform &transform() {
+            if (!transform_ || !transform_->is(datum))
+                transform_ = geoson::DatumTransform::shared(datum);
+            return *transform_;
+        }
+
+        /// captured lat/lon points to ENU in one batch (altitude 0)
+        std::vector<concord::Point> to_enu(const std::vector<Point> &captured) {
+            std::vector<concord::Point> pts;
+            pts.reserve(captured.size());
+            for (const auto &point : captured)
+                pts.emplace_back(point.lon, point.lat, 0.0);
+            transform().toENU(pts.data(), pts.size());
+            return pts;
+        }
+
+        /// the page for the current mode, built on first use and shared by every drawer
+        const http::StaticPage &get_html() const {
+            static const http::StaticPage polygon_page("text/html", get_polygon_html());
+            static const http::StaticPage single_point_page("text/html", get_single_point_html());
+            return single_point_mode ? single_point_page : polygon_page;
         }
 
-        std::string get_polygon_html() {
+        static std::string get_polygon_html() {
             std::string html = "<!DOCTYPE html><html><head><title>Draw Polygon</title>"
                                "<link rel=\"stylesheet\" href=\"https://unpkg.com/leaflet@1.9.4/dist/leaflet.css\"/>"
                                "<style>body{margin:0;font-family:Arial}#map{height:100vh;width:100vw}"
@@ -64,6 +386,12 @@ namespace geoget {
                                "<script>"
                                "var map=L.map('map').setView([52.1326,5.2913],10);"
                                "L.tileLayer('https://{s}.tile.openstreetmap.org/{z}/{x}/{y}.png').addTo(map);"
+                               "var sid=Math.random().toString(36).slice(2),seq=0;"
+                               "function post(path,body){"
+                               "body=body||{};body.sid=sid;body.seq=seq++;"
+                               "return fetch(path,{method:'POST',headers:{'Content-Type':'application/json'},"
+                               "body:JSON.stringify(body)});"
+                               "}"
                                "var points=[],markers=[],poly=null,allPolys=[],allMarkers=[];"
                                "var "
                                "colors=['#FF0000','#00FF00','#0000FF','#FFFF00','#FF00FF','#00FFFF','#FFA500','#800080'"
@@ -85,8 +413,7 @@ namespace geoget {
                                "poly=L.polygon(points,{color:currentColor,fillOpacity:0.2}).addTo(map);"
                                "document.getElementById('newBtn').disabled=false;"
                                "}"
-                               "fetch('/api/addpoint',{method:'POST',headers:{'Content-Type':'application/json'},"
-                               "body:JSON.stringify({lat:lat,lon:lon})});"
+                               "post('/api/addpoint',{lat:lat,lon:lon});"
                                "});"
                                "function removePoint(marker){"
                                "var idx=markers.indexOf(marker);"
@@ -99,18 +426,13 @@ namespace geoget {
                                "var currentColor=colors[allPolys.length%colors.length];"
                                "poly=L.polygon(points,{color:currentColor,fillOpacity:0.2}).addTo(map);"
                                "}"
-                               "fetch('/api/clearcurrent',{method:'POST'}).then(function(){"
-                               "points.forEach(function(p){"
-                               "fetch('/api/addpoint',{method:'POST',headers:{'Content-Type':'application/json'},"
-                               "body:JSON.stringify({lat:p[0],lon:p[1]})});"
-                               "});"
-                               "});"
+                               "post('/api/setpoints',{points:points});"
                                "}}"
                                "function newPoly(){"
                                "if(points.length>=3){"
                                "allPolys.push(poly);"
                                "allMarkers.push(markers.slice());"
-                               "fetch('/api/newpolygon',{method:'POST'});"
+                               "post('/api/newpolygon');"
                                "points=[];"
                                "markers=[];"
                                "poly=null;"
@@ -125,29 +447,20 @@ namespace geoget {
                                "allMarkers.forEach(function(ms){ms.forEach(function(m){map.removeLayer(m);});});"
                                "allPolys=[];allMarkers=[];"
                                "document.getElementById('newBtn').disabled=true;"
-                               "fetch('/api/clear',{method:'POST'});"
+                               "post('/api/clear');"
                                "}"
                                "function done(){"
                                "if(points.length<3){alert('Need at least 3 points');return;}"
-                               "fetch('/api/done',{method:'POST'})"
+                               "post('/api/done')"
                                ".then(response=>response.json())"
                                ".then(data=>alert('Polygon complete! '+data.pointCount+' points saved'));"
                                "}"
                                "</script></body></html>";
 
-            return "HTTP/1.1 200 OK\r\n"
-                   "Content-Type: text/html\r\n"
-                   "Cache-Control: no-cache, no-store, must-revalidate\r\n"
-                   "Pragma: no-cache\r\n"
-                   "Expires: 0\r\n"
-                   "Content-Length: " +
-                   std::to_string(html.length()) +
-                   "\r\n"
-                   "\r\n" +
-                   html;
+            return html;
         }
 
-        std::string get_single_point_html() {
+        static std::string get_single_point_html() {
             std::string html = "<!DOCTYPE html><html><head><title>Select Point</title>"
                                "<link rel=\"stylesheet\" href=\"https://unpkg.com/leaflet@1.9.4/dist/leaflet.css\"/>"
                                "<style>body{margin:0;font-family:Arial}#map{height:100vh;width:100vw}"
@@ -167,6 +480,12 @@ namespace geoget {
                                "<script>"
                                "var map=L.map('map').setView([52.1326,5.2913],10);"
                                "L.tileLayer('https://{s}.tile.openstreetmap.org/{z}/{x}/{y}.png').addTo(map);"
+                               "var sid=Math.random().toString(36).slice(2),seq=0;"
+                               "function post(path,body){"
+                               "body=body||{};body.sid=sid;body.seq=seq++;"
+                               "return fetch(path,{method:'POST',headers:{'Content-Type':'application/json'},"
+                               "body:JSON.stringify(body)});"
+                               "}"
                                "var marker=null,allMarkers=[];"
                                "if(navigator.geolocation){"
                                "navigator.geolocation.getCurrentPosition(function(p){"
@@ -178,18 +497,17 @@ namespace geoget {
                                "marker=L.marker([lat,lon]).addTo(map);"
                                "marker.on('contextmenu',function(){removePoint();});"
                                "document.getElementById('newBtn').disabled=false;"
-                               "fetch('/api/setpoint',{method:'POST',headers:{'Content-Type':'application/json'},"
-                               "body:JSON.stringify({lat:lat,lon:lon})});"
+                               "post('/api/setpoint',{lat:lat,lon:lon});"
                                "});"
                                "function removePoint(){"
                                "if(marker){map.removeLayer(marker);marker=null;}"
                                "document.getElementById('newBtn').disabled=true;"
-                               "fetch('/api/clearcurrent',{method:'POST'});"
+                               "post('/api/clearcurrent');"
                                "}"
                                "function newPoint(){"
                                "if(marker){"
                                "allMarkers.push(marker);"
-                               "fetch('/api/newpoint',{method:'POST'});"
+                               "post('/api/newpoint');"
                                "marker=null;"
                                "document.getElementById('newBtn').disabled=true;"
                                "}}"
@@ -198,157 +516,177 @@ namespace geoget {
                                "allMarkers.forEach(function(m){map.removeLayer(m);});"
                                "allMarkers=[];"
                                "document.getElementById('newBtn').disabled=true;"
-                               "fetch('/api/clear',{method:'POST'});"
+                               "post('/api/clear');"
                                "}"
                                "function done(){"
                                "if(!marker){alert('Please select a point first');return;}"
-                               "fetch('/api/done',{method:'POST'})"
+                               "post('/api/done')"
                                ".then(response=>response.json())"
                                ".then(data=>alert('Point selected!'));"
                                "}"
                                "</script></body></html>";
 
-            return "HTTP/1.1 200 OK\r\n"
-                   "Content-Type: text/html\r\n"
-                   "Cache-Control: no-cache, no-store, must-revalidate\r\n"
-                   "Pragma: no-cache\r\n"
-                   "Expires: 0\r\n"
-                   "Content-Length: " +
-                   std::to_string(html.length()) +
-                   "\r\n"
-                   "\r\n" +
-                   html;
+            return html;
         }
 
-        void handle_request(int client_fd) {
-            char buffer[4096] = {0};
-            read(client_fd, buffer, 4096);
-
-            std::string request(buffer);
-            std::istringstream iss(request);
-            std::string method, path, version;
-            iss >> method >> path >> version;
+        static bool is_capture(const http::Request &request) {
+            static const char *const paths[] = {"/api/addpoint",   "/api/setpoint", "/api/setpoints",
+                                                "/api/newpolygon", "/api/newpoint", "/api/clear",
+                                                "/api/clearcurrent", "/api/done"};
+            if (request.method != "POST")
+                return false;
+            for (const char *path : paths)
+                if (request.path == path)
+                    return true;
+            return false;
+        }
 
-            std::cout << "DEBUG: Request " << method << " " << path
+        void log_request(const http::Request &request) const {
+            std::cout << "DEBUG: Request " << request.method << " " << request.path
                       << " (mode: " << (single_point_mode ? "single" : "polygon") << ")" << std::endl;
+        }
 
-            std::string response;
-            if (path == "/" || path == "/index.html") {
-                response = get_html();
-            } else if (path == "/api/addpoint" && method == "POST") {
-                response = add_point(request);
-            } else if (path == "/api/clear" && method == "POST") {
-                response = clear_points();
-            } else if (path == "/api/setpoint" && method == "POST") {
-                response = set_point(request);
-            } else if (path == "/api/newpolygon" && method == "POST") {
-                response = new_polygon();
-            } else if (path == "/api/newpoint" && method == "POST") {
-                response = new_point();
-            } else if (path == "/api/clearcurrent" && method == "POST") {
-                response = clear_current_only();
-            } else if (path == "/api/done" && method == "POST") {
-                response = handle_done();
-            } else {
-                response = "HTTP/1.1 404 Not Found\r\n\r\nNot Found";
+        void handle_request(const http::Request &request, bool keep_alive, std::string &out) {
+            log_request(request);
+            if (request.path == "/" || request.path == "/index.html") {
+                get_html().serve(request, keep_alive, out);
+                return;
             }
-
-            send(client_fd, response.c_str(), response.length(), 0);
-            close(client_fd);
+            out += http::Response::error("404 Not Found", "Not Found").serialize(keep_alive);
         }
 
-        std::string add_point(const std::string &request) {
-            size_t body_start = request.find("\r\n\r\n");
-            if (body_start == std::string::npos) {
-                return "HTTP/1.1 400 Bad Request\r\n\r\nNo body";
+        /// Turns a capture request into an event for the sequencer. The connection waits for the reply, which is
+        /// sent once the event has actually been applied; posts without "sid"/"seq" are applied on arrival.
+        void submit(Connection &c, const http::Request &request, bool keep_alive) {
+            log_request(request);
+            json data = request.body.empty() ? json::object() : json::parse(request.body, nullptr, false);
+            if (!data.is_object()) {
+                c.out += http::Response::error("400 Bad Request", "Invalid JSON").serialize(keep_alive);
+                return;
             }
 
-            std::string body = request.substr(body_start + 4);
-            try {
-                json data = json::parse(body);
-                double lat = data["lat"].get<double>();
-                double lon = data["lon"].get<double>();
-
-                points.push_back({lat, lon});
-
-                std::cout << "Point " << points.size() << ": " << lat << ", " << lon << std::endl;
-
-                return "HTTP/1.1 200 OK\r\n"
-                       "Content-Type: application/json\r\n"
-                       "\r\n{\"success\":true}";
-
-            } catch (...) {
-                return "HTTP/1.1 400 Bad Request\r\n\r\nInvalid JSON";
+            CaptureEvent event{request.path, {}, {}, c.id, keep_alive};
+            if (request.path == "/api/addpoint" || request.path == "/api/setpoint") {
+                auto lat = data.find("lat"), lon = data.find("lon");
+                if (lat == data.end() || lon == data.end() || !lat->is_number() || !lon->is_number()) {
+                    c.out += http::Response::error("400 Bad Request",
+                                                   request.body.empty() ? "No body" : "Invalid JSON")
+                                 .serialize(keep_alive);
+                    return;
+                }
+                event.point = {lat->get<double>(), lon->get<double>()};
+            } else if (request.path == "/api/setpoints") {
+                auto ring = data.find("points");
+                bool valid = ring != data.end() && ring->is_array();
+                if (valid) {
+                    event.ring.reserve(ring->size());
+                    for (const auto &p : *ring) {
+                        if (!p.is_array() || p.size() != 2 || !p[0].is_number() || !p[1].is_number()) {
+                            valid = false;
+                            break;
+                        }
+                        event.ring.push_back({p[0].get<double>(), p[1].get<double>()});
+                    }
+                }
+                if (!valid) {
+                    c.out += http::Response::error("400 Bad Request", "Invalid JSON").serialize(keep_alive);
+                    return;
+                }
             }
+
+            c.awaiting = true;
+            auto apply = [this](CaptureEvent &&e) { apply_event(std::move(e)); };
+            auto sid = data.find("sid"), seq = data.find("seq");
+            if (sid != data.end() && sid->is_string() && seq != data.end() && seq->is_number_unsigned())
+                sequencer.push(sid->get<std::string>(), seq->get<std::uint64_t>(), std::move(event), apply);
+            else
+                apply(std::move(event));
         }
 
-        std::string set_point(const std::string &request) {
-            size_t body_start = request.find("\r\n\r\n");
-            if (body_start == std::string::npos) {
-                return "HTTP/1.1 400 Bad Request\r\n\r\nNo body";
+        void apply_event(CaptureEvent &&event) {
+            if (is_done)
+                return; // the capture is over; what comes after /api/done is dropped
+            http::Response response;
+            if (event.path == "/api/addpoint") {
+                response = add_point(event.point);
+            } else if (event.path == "/api/setpoint") {
+                response = set_point(event.point);
+            } else if (event.path == "/api/setpoints") {
+                response = set_points(std::move(event.ring));
+            } else if (event.path == "/api/newpolygon") {
+                response = new_polygon();
+            } else if (event.path == "/api/newpoint") {
+                response = new_point();
+            } else if (event.path == "/api/clear") {
+                response = clear_points();
+            } else if (event.path == "/api/clearcurrent") {
+                response = clear_current_only();
+            } else {
+                response = handle_done();
             }
+            for (auto &c : connections) {
+                if (c.id == event.connection && c.fd != -1) {
+                    c.out += response.serialize(event.keep_alive);
+                    c.awaiting = false;
+                    c.resume = true;
+                    break;
+                }
+            }
+        }
 
-            std::string body = request.substr(body_start + 4);
-            try {
-                json data = json::parse(body);
-                double lat = data["lat"].get<double>();
-                double lon = data["lon"].get<double>();
-
-                points.clear();
-                points.push_back({lat, lon});
-
-                std::cout << "Point set: " << lat << ", " << lon << std::endl;
+        http::Response add_point(const Point &point) {
+            points.push_back(point);
+            std::cout << "Point " << points.size() << ": " << point.lat << ", " << point.lon << std::endl;
+            return http::Response::json("{\"success\":true}");
+        }
 
-                return "HTTP/1.1 200 OK\r\n"
-                       "Content-Type: application/json\r\n"
-                       "\r\n{\"success\":true}";
+        http::Response set_point(const Point &point) {
+            points.clear();
+            points.push_back(point);
+            std::cout << "Point set: " << point.lat << ", " << point.lon << std::endl;
+            return http::Response::json("{\"success\":true}");
+        }
 
-            } catch (...) {
-                return "HTTP/1.1 400 Bad Request\r\n\r\nInvalid JSON";
-            }
+        /// replaces the shape being drawn with `ring`, [lat, lon] pairs in drawing order
+        http::Response set_points(std::vector<Point> ring) {
+            points = std::move(ring);
+            std::cout << "Current shape set: " << points.size() << " points" << std::endl;
+            return http::Response::json("{\"success\":true}");
         }
 
-        std::string new_polygon() {
+        http::Response new_polygon() {
             if (points.size() >= 3) {
                 all_polygons.push_back(points);
                 std::cout << "New polygon added with " << points.size() << " points" << std::endl;
                 points.clear();
             }
-            return "HTTP/1.1 200 OK\r\n"
-                   "Content-Type: application/json\r\n"
-                   "\r\n{\"success\":true}";
+            return http::Response::json("{\"success\":true}");
         }
 
-        std::string new_point() {
+        http::Response new_point() {
             if (!points.empty()) {
                 all_single_points.push_back(points[0]);
                 std::cout << "New point added: " << points[0].lat << ", " << points[0].lon << std::endl;
                 points.clear();
             }
-            return "HTTP/1.1 200 OK\r\n"
-                   "Content-Type: application/json\r\n"
-                   "\r\n{\"success\":true}";
+            return http::Response::json("{\"success\":true}");
         }
 
-        std::string clear_current_only() {
+        http::Response clear_current_only() {
             points.clear();
             std::cout << (single_point_mode ? "Current point cleared" : "Current polygon cleared") << std::endl;
-            return "HTTP/1.1 200 OK\r\n"
-                   "Content-Type: application/json\r\n"
-                   "\r\n{\"success\":true}";
+            return http::Response::json("{\"success\":true}");
         }
 
-        std::string clear_points() {
+        http::Response clear_points() {
             points.clear();
             all_polygons.clear();
             all_single_points.clear();
             std::cout << (single_point_mode ? "All points cleared" : "All polygons cleared") << std::endl;
-            return "HTTP/1.1 200 OK\r\n"
-                   "Content-Type: application/json\r\n"
-                   "\r\n{\"success\":true}";
+            return http::Response::json("{\"success\":true}");
         }
 
-        std::string handle_done() {
+        http::Response handle_done() {
             if (single_point_mode) {
                 // Add current point to collection if exists
                 if (!points.empty()) {
@@ -380,12 +718,8 @@ namespace geoget {
                 std::cout << "===========================\n" << std::endl;
             }
 
-            // Signal that we're done
-            {
-                std::lock_guard<std::mutex> lock(done_mutex);
-                is_done = true;
-            }
-            done_cv.notify_one();
+            // Ends the event loop once this response has gone out
+            is_done = true;
 
             json response;
             response["success"] = true;
@@ -397,75 +731,165 @@ namespace geoget {
                 response["polygonCount"] = all_polygons.size();
             }
 
-            return "HTTP/1.1 200 OK\r\n"
-                   "Content-Type: application/json\r\n"
-                   "\r\n" +
-                   response.dump();
+            return http::Response::json(response.dump());
         }
 
-        std::vector<Point> collect_points() {
-            single_point_mode = false;
+        /// Runs the server on the calling thread until a client posts /api/done. A single poll() loop accepts
+        /// connections, reads whatever has arrived, answers each complete request in arrival order and writes
+        /// replies as the sockets take them; connections stay open between requests (HTTP/1.1 keep-alive).
+        void serve() {
+            while (!is_done && server_fd != -1) {
+                if (!poll_once(-1, true))
+                    break;
+            }
+            // give the last replies (the /api/done one in particular) a moment to drain
+            for (int i = 0; i < 20 && has_output(); ++i)
+                poll_once(50, false);
+            stop();
+        }
 
-            // Reset state with proper mutex lock
-            {
-                std::lock_guard<std::mutex> lock(done_mutex);
-                is_done = false;
+        /// one round of the event loop; false on an unrecoverable poll() error
+        bool poll_once(int timeout_ms, bool accepting) {
+            std::vector<pollfd> fds;
+            fds.reserve(connections.size() + 1);
+            fds.push_back({server_fd, static_cast<short>(accepting ? POLLIN : 0), 0});
+            for (const auto &c : connections) {
+                fds.push_back({c.fd, static_cast<short>(c.out.empty() ? POLLIN : POLLIN | POLLOUT), 0});
+                if (accepting && c.resume)
+                    timeout_ms = 0;
             }
-            points.clear();
+            if (accepting && timeout_ms != 0 && sequencer.waiting())
+                timeout_ms = 100; // wake up to check on the gap
+
+            if (poll(fds.data(), fds.size(), timeout_ms) < 0)
+                return errno == EINTR;
+
+            // a post that never arrives (the page was closed mid-request) must not hold the others forever
+            if (accepting && sequencer.stalled(std::chrono::seconds(1)))
+                sequencer.flush([this](CaptureEvent &&e) { apply_event(std::move(e)); });
+
+            const size_t polled = connections.size();
+            if (fds[0].revents & POLLIN)
+                accept_all();
+            for (size_t i = 0; i < polled; ++i) {
+                auto &c = connections[i];
+                if (accepting && (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+                    receive(c);
+                else if (accepting && c.resume)
+                    process(c);
+                if (c.fd != -1 && !c.out.empty())
+                    transmit(c);
+            }
+            std::erase_if(connections, [](const Connection &c) { return c.fd == -1; });
+            return true;
+        }
 
-            // Start server thread
-            std::thread server_thread([this]() {
-                while (!is_done) {
-                    struct sockaddr_in client_addr;
-                    socklen_t client_len = sizeof(client_addr);
-                    int client_fd = accept(server_fd, (struct sockaddr *)&client_addr, &client_len);
-                    if (client_fd >= 0) {
-                        std::thread([this, client_fd]() { handle_request(client_fd); }).detach();
-                    }
+        void accept_all() {
+            while (true) {
+                int fd = accept(server_fd, nullptr, nullptr);
+                if (fd < 0)
+                    return; // EAGAIN: nothing more pending (or a transient error; poll() will tell again)
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+                connections.push_back({fd, next_connection_id++, {}, {}});
+            }
+        }
+
+        /// reads everything available, then answers the complete requests in it
+        void receive(Connection &c) {
+            char buffer[16 * 1024];
+            while (true) {
+                ssize_t n = read(c.fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    c.in.append(buffer, static_cast<size_t>(n));
+                } else if (n == 0) {
+                    c.close_after = true; // peer finished sending; still answer what it sent
+                    break;
+                } else if (errno == EINTR) {
+                    continue;
+                } else {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK)
+                        disconnect(c);
+                    break;
                 }
-            });
+            }
+            if (c.fd != -1)
+                process(c);
+        }
 
-            // Wait for completion
-            std::unique_lock<std::mutex> lock(done_mutex);
-            done_cv.wait(lock, [this] { return is_done; });
+        /// Answers the complete requests in `c.in`, in order. Parsing pauses while a capture event from this
+        /// connection waits for its turn, since replies have to go out in request order.
+        void process(Connection &c) {
+            c.resume = false;
+            http::Request request;
+            while (!is_done && !c.awaiting) {
+                auto parsed = http::take_request(c.in, request);
+                if (parsed == http::Parse::incomplete)
+                    break;
+                if (parsed == http::Parse::bad) {
+                    c.out += http::Response::error("400 Bad Request", "Bad Request").serialize(false);
+                    c.in.clear();
+                    c.close_after = true;
+                    break;
+                }
+                const bool keep_alive = request.keep_alive && !c.close_after;
+                if (is_capture(request))
+                    submit(c, request, keep_alive);
+                else
+                    handle_request(request, keep_alive, c.out);
+                if (!request.keep_alive) {
+                    c.in.clear();
+                    c.close_after = true;
+                    break;
+                }
+            }
+            if (c.out.empty() && c.close_after && !c.awaiting)
+                disconnect(c);
+        }
 
-            // Clean up
-            server_thread.detach();
-            stop();
+        void transmit(Connection &c) {
+            while (!c.out.empty()) {
+                ssize_t n = send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL);
+                if (n > 0) {
+                    c.out.erase(0, static_cast<size_t>(n));
+                } else if (n < 0 && errno == EINTR) {
+                    continue;
+                } else {
+                    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+                        disconnect(c);
+                    return;
+                }
+            }
+            if (c.close_after && !c.awaiting)
+                disconnect(c);
+        }
+
+        void disconnect(Connection &c) {
+            if (c.fd != -1) {
+                close(c.fd);
+                c.fd = -1;
+            }
+        }
+
+        bool has_output() const {
+            for (const auto &c : connections)
+                if (c.fd != -1 && !c.out.empty())
+                    return true;
+            return false;
+        }
 
+        std::vector<Point> collect_points() {
+            single_point_mode = false;
+            is_done = false;
+            points.clear();
+            serve();
             return points;
         }
 
         Point collect_single_point() {
             single_point_mode = true;
-
-            // Reset state with proper mutex lock
-            {
-                std::lock_guard<std::mutex> lock(done_mutex);
-                is_done = false;
-            }
+            is_done = false;
             points.clear();
-
-            // Start server thread
-            std::thread server_thread([this]() {
-                while (!is_done) {
-                    struct sockaddr_in client_addr;
-                    socklen_t client_len = sizeof(client_addr);
-                    int client_fd = accept(server_fd, (struct sockaddr *)&client_addr, &client_len);
-                    if (client_fd >= 0) {
-                        std::thread([this, client_fd]() { handle_request(client_fd); }).detach();
-                    }
-                }
-            });
-
-            // Wait for completion
-            std::unique_lock<std::mutex> lock(done_mutex);
-            done_cv.wait(lock, [this] { return is_done; });
-
-            // Clean up
-            server_thread.detach();
-            stop();
-
+            serve();
             return points.empty() ? Point{0, 0} : points[0];
         }
 
@@ -490,12 +914,9 @@ namespace geoget {
                 server_fd = -1;
             }
 
-            // Reset state with proper mutex lock
-            {
-                std::lock_guard<std::mutex> lock(done_mutex);
-                is_done = false;
-            }
+            is_done = false;
             points.clear();
+            sequencer = {};
 
             server_fd = socket(AF_INET, SOCK_STREAM, 0);
             if (server_fd == -1) {
@@ -515,15 +936,20 @@ namespace geoget {
                 return false;
             }
 
-            if (listen(server_fd, 3) < 0) {
+            if (listen(server_fd, SOMAXCONN) < 0) {
                 return false;
             }
+            // the event loop never blocks on accept()
+            fcntl(server_fd, F_SETFL, fcntl(server_fd, F_GETFL, 0) | O_NONBLOCK);
 
             std::cout << "Polygon Drawer on http://localhost:" << port << std::endl;
             return true;
         }
 
         void stop() {
+            for (auto &c : connections)
+                disconnect(c);
+            connections.clear();
             if (server_fd != -1) {
                 shutdown(server_fd, SHUT_RDWR);
                 close(server_fd);
@@ -533,35 +959,11 @@ namespace geoget {
 
         concord::Datum add_datum() {
             single_point_mode = true;
-
-            // Reset state with proper mutex lock
-            {
-                std::lock_guard<std::mutex> lock(done_mutex);
-                is_done = false;
-            }
+            is_done = false;
             points.clear();
 
             std::cout << "Select datum point on the map..." << std::endl;
-
-            // Start server thread
-            std::thread server_thread([this]() {
-                while (!is_done) {
-                    struct sockaddr_in client_addr;
-                    socklen_t client_len = sizeof(client_addr);
-                    int client_fd = accept(server_fd, (struct sockaddr *)&client_addr, &client_len);
-                    if (client_fd >= 0) {
-                        std::thread([this, client_fd]() { handle_request(client_fd); }).detach();
-                    }
-                }
-            });
-
-            // Wait for completion
-            std::unique_lock<std::mutex> lock(done_mutex);
-            done_cv.wait(lock, [this] { return is_done; });
-
-            // Clean up
-            server_thread.detach();
-            stop();
+            serve();
 
             // Set the datum from the selected point
             if (!points.empty()) {
@@ -595,14 +997,9 @@ namespace geoget {
                 }
             }
             std::vector<concord::Polygon> concord_polygons;
-            for (const auto &polygon : all_polygons) {
-                concord::Polygon concord_polygon;
-                for (const auto &point : polygon) {
-                    auto [x, y, z] = concord::gps_to_enu(point.lat, point.lon, 0.0, datum.lat, datum.lon, datum.alt);
-                    concord_polygon.addPoint(concord::Point{x, y, z});
-                }
-                concord_polygons.push_back(concord_polygon);
-            }
+            concord_polygons.reserve(all_polygons.size());
+            for (const auto &polygon : all_polygons)
+                concord_polygons.emplace_back(to_enu(polygon));
             return concord_polygons;
         }
 
@@ -615,12 +1012,7 @@ namespace geoget {
                     set_datum_from_point(all_single_points[0]);
                 }
             }
-            std::vector<concord::Point> concord_points;
-            for (const auto &point : all_single_points) {
-                auto [x, y, z] = concord::gps_to_enu(point.lat, point.lon, 0.0, datum.lat, datum.lon, datum.alt);
-                concord_points.emplace_back(x, y, z);
-            }
-            return concord_points;
+            return to_enu(all_single_points);
         }
     };
 
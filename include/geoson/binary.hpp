@@ -0,0 +1,576 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "concord/concord.hpp"
+
+#include "geoson/columnar.hpp"
+#include "geoson/parser.hpp"
+#include "geoson/spatial.hpp"
+#include "geoson/types.hpp"
+#include "geoson/writter.hpp"
+
+// Binary collection format: the columnar layout (see ColumnarCollection) written out as is, so a reader maps the
+// file and points straight into it instead of parsing text. Little-endian, every section 8-byte aligned:
+//
+//   header    fixed-size `op::BinaryHeader` (magic, version, datum, heading, counts, section table)
+//   offsets   uint64[features + 1]   first coordinate of each feature, then the coordinate count
+//   kinds     uint8[features]        GeometryKind
+//   x, y, z   double[points] each    ENU metres
+//   keys      uint32 count, then (uint32 length, bytes) per distinct property key
+//   props     uint64[features + 1] byte offsets into the records that follow; a record is a uint32 entry count,
+//             then per entry a uint32 key, a uint8 PropertyValue::Kind and the value (int64, double, uint8, or
+//             uint32 length + bytes for strings and JSON text)
+//   globals   uint32 count, then (uint32 length, bytes) key and value pairs
+//   index     optional packed R-tree: uint64 entry count, uint64 level count, uint64 node count per level, then
+//             entries (min/max x/y/z, id) and the levels root first (min/max x/y/z, first, count)
+
+namespace geoson {
+
+    /// what `WriteBinaryCollection` includes beyond the features themselves
+    struct BinaryOptions {
+        /// store the packed R-tree over the feature boxes, so readers can query without building one
+        bool spatial_index = true;
+    };
+
+    namespace op {
+        inline constexpr char binary_magic[8] = {'G', 'E', 'O', 'S', 'O', 'N', 'B', '\0'};
+        inline constexpr std::uint32_t binary_version = 1;
+
+        struct BinarySection {
+            std::uint64_t offset = 0;
+            std::uint64_t size = 0;
+        };
+
+        struct BinaryHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t flags; // reserved
+            double datum[3];     // lat, lon, alt
+            double heading;      // yaw
+            std::uint64_t features;
+            std::uint64_t points;
+            BinarySection offsets, kinds, x, y, z, keys, props, globals, index;
+        };
+        static_assert(sizeof(BinaryHeader) == 208, "BinaryHeader layout is part of the file format");
+
+        inline void requireLittleEndian() {
+            if constexpr (std::endian::native != std::endian::little)
+                throw std::runtime_error("geoson binary collections need a little-endian host");
+        }
+
+        constexpr std::uint64_t alignUp(std::uint64_t n) { return (n + 7) & ~std::uint64_t(7); }
+
+        /// appends plain values to a byte string
+        struct ByteSink {
+            std::string &bytes;
+
+            template <typename T> void pod(T v) { bytes.append(reinterpret_cast<const char *>(&v), sizeof(T)); }
+            void text(std::string_view s) {
+                pod(static_cast<std::uint32_t>(s.size()));
+                bytes.append(s);
+            }
+            void box(const Bounds &b) {
+                for (double v : {b.min_x, b.min_y, b.min_z, b.max_x, b.max_y, b.max_z})
+                    pod(v);
+            }
+        };
+
+        /// bounds-checked reads from one section of a loaded collection
+        class ByteSource {
+          public:
+            ByteSource(const char *data, std::size_t size) : cur_(data), end_(data + size) {}
+
+            template <typename T> T pod() {
+                need(sizeof(T));
+                T v;
+                std::memcpy(&v, cur_, sizeof(T));
+                cur_ += sizeof(T);
+                return v;
+            }
+            std::string_view text() {
+                const auto n = pod<std::uint32_t>();
+                need(n);
+                std::string_view s(cur_, n);
+                cur_ += n;
+                return s;
+            }
+            Bounds box() {
+                Bounds b;
+                for (double *v : {&b.min_x, &b.min_y, &b.min_z, &b.max_x, &b.max_y, &b.max_z})
+                    *v = pod<double>();
+                return b;
+            }
+            /// A record count, checked to leave room for that many records of at least `record_size` bytes each,
+            /// so nothing is sized from a corrupt count before its bytes are known to be there.
+            template <typename T> std::size_t count(std::size_t record_size) {
+                const auto n = pod<T>();
+                need(n, record_size);
+                return static_cast<std::size_t>(n);
+            }
+            /// throws unless `n` records of `record_size` bytes each fit in the rest of the section
+            void need(std::uint64_t n, std::size_t record_size = 1) const {
+                if (n > static_cast<std::size_t>(end_ - cur_) / record_size)
+                    throw std::runtime_error("geoson::BinaryCollection: truncated section");
+            }
+
+          private:
+            const char *cur_;
+            const char *end_;
+        };
+
+        inline void encodeValue(ByteSink &out, const PropertyValue &v) {
+            out.pod(static_cast<std::uint8_t>(v.kind()));
+            switch (v.kind()) {
+            case PropertyValue::Kind::Integer:
+                out.pod(v.asInt());
+                break;
+            case PropertyValue::Kind::Number:
+                out.pod(v.asDouble());
+                break;
+            case PropertyValue::Kind::Boolean:
+                out.pod(static_cast<std::uint8_t>(v.asBool()));
+                break;
+            case PropertyValue::Kind::String:
+                out.text(v.asString());
+                break;
+            default:
+                out.text(v.str());
+            }
+        }
+
+        inline PropertyValue decodeValue(ByteSource &in) {
+            switch (static_cast<PropertyValue::Kind>(in.pod<std::uint8_t>())) {
+            case PropertyValue::Kind::String:
+                return PropertyValue(in.text());
+            case PropertyValue::Kind::Integer:
+                return PropertyValue(in.pod<std::int64_t>());
+            case PropertyValue::Kind::Number:
+                return PropertyValue(in.pod<double>());
+            case PropertyValue::Kind::Boolean:
+                return PropertyValue(in.pod<std::uint8_t>() != 0);
+            case PropertyValue::Kind::Json:
+                return PropertyValue::fromJson(std::string(in.text()));
+            }
+            throw std::runtime_error("geoson::BinaryCollection: unknown property kind");
+        }
+
+        /// Writes `cc` in the binary layout. Everything but the coordinate columns is encoded up front, so the
+        /// header can carry the final section table; the columns are then streamed as they are.
+        inline void writeBinary(ColumnarCollection const &cc, OutputBuffer &out, const BinaryOptions &opts) {
+            requireLittleEndian();
+            const std::uint64_t n = cc.size(), points = cc.pointCount();
+
+            std::string keys, props, globals, index;
+            std::unordered_map<std::string_view, std::uint32_t> key_ids;
+            std::vector<std::uint64_t> record_offsets;
+            record_offsets.reserve(n + 1);
+            {
+                ByteSink sink{props};
+                for (auto const &bag : cc.properties) {
+                    record_offsets.push_back(props.size());
+                    sink.pod(static_cast<std::uint32_t>(bag.size()));
+                    for (auto const &[key, value] : bag) {
+                        auto [it, added] = key_ids.try_emplace(key.str(), static_cast<std::uint32_t>(key_ids.size()));
+                        sink.pod(it->second);
+                        encodeValue(sink, value);
+                    }
+                }
+                record_offsets.push_back(props.size());
+            }
+            {
+                std::vector<std::string_view> by_id(key_ids.size());
+                for (auto const &[key, id] : key_ids)
+                    by_id[id] = key;
+                ByteSink sink{keys};
+                sink.pod(static_cast<std::uint32_t>(by_id.size()));
+                for (auto key : by_id)
+                    sink.text(key);
+            }
+            {
+                ByteSink sink{globals};
+                sink.pod(static_cast<std::uint32_t>(cc.global_properties.size()));
+                for (auto const &[key, value] : cc.global_properties) {
+                    sink.text(key);
+                    sink.text(value);
+                }
+            }
+            if (opts.spatial_index) {
+                std::vector<Bounds> boxes;
+                boxes.reserve(n);
+                for (std::size_t i = 0; i < n; ++i)
+                    boxes.push_back(cc.bounds(i));
+                const SpatialIndex tree(boxes);
+                ByteSink sink{index};
+                sink.pod(static_cast<std::uint64_t>(tree.entries().size()));
+                sink.pod(static_cast<std::uint64_t>(tree.levels().size()));
+                for (auto const &level : tree.levels())
+                    sink.pod(static_cast<std::uint64_t>(level.size()));
+                for (auto const &entry : tree.entries()) {
+                    sink.box(entry.box);
+                    sink.pod(static_cast<std::uint64_t>(entry.id));
+                }
+                for (auto const &level : tree.levels())
+                    for (auto const &node : level) {
+                        sink.box(node.box);
+                        sink.pod(static_cast<std::uint64_t>(node.first));
+                        sink.pod(static_cast<std::uint64_t>(node.count));
+                    }
+            }
+
+            BinaryHeader h{};
+            std::memcpy(h.magic, binary_magic, sizeof(h.magic));
+            h.version = binary_version;
+            h.datum[0] = cc.datum.lat;
+            h.datum[1] = cc.datum.lon;
+            h.datum[2] = cc.datum.alt;
+            h.heading = cc.heading.yaw;
+            h.features = n;
+            h.points = points;
+
+            std::uint64_t pos = alignUp(sizeof(BinaryHeader));
+            auto place = [&](BinarySection &s, std::uint64_t size) {
+                s = BinarySection{pos, size};
+                pos = alignUp(pos + size);
+            };
+            place(h.offsets, 8 * (n + 1));
+            place(h.kinds, n);
+            place(h.x, 8 * points);
+            place(h.y, 8 * points);
+            place(h.z, 8 * points);
+            place(h.keys, keys.size());
+            place(h.props, 8 * (n + 1) + props.size());
+            place(h.globals, globals.size());
+            if (!index.empty())
+                place(h.index, index.size());
+
+            std::uint64_t written = 0;
+            auto emit = [&](const void *data, std::size_t size) {
+                out.write(static_cast<const char *>(data), size);
+                written += size;
+            };
+            auto pad = [&] {
+                static constexpr char zeros[8] = {};
+                emit(zeros, alignUp(written) - written);
+            };
+            emit(&h, sizeof(h));
+            pad();
+            for (auto offset : cc.offsets) {
+                const auto o = static_cast<std::uint64_t>(offset);
+                emit(&o, sizeof(o));
+            }
+            emit(&points, sizeof(points));
+            emit(cc.kinds.data(), cc.kinds.size());
+            pad();
+            emit(cc.x.data(), 8 * points);
+            emit(cc.y.data(), 8 * points);
+            emit(cc.z.data(), 8 * points);
+            emit(keys.data(), keys.size());
+            pad();
+            emit(record_offsets.data(), 8 * record_offsets.size());
+            emit(props.data(), props.size());
+            pad();
+            emit(globals.data(), globals.size());
+            pad();
+            emit(index.data(), index.size());
+        }
+    } // namespace op
+
+    /// Binary collection opened for reading. Files are memory-mapped: the coordinate columns are never copied and
+    /// feature `i`'s coordinates are read straight from the mapping, while property bags are only decoded when
+    /// asked for. Opening checks the header and the feature offsets, so it costs milliseconds even for millions of
+    /// coordinates.
+    class BinaryCollection {
+      public:
+        /// maps `file`; files that cannot be mapped are read into memory instead
+        static BinaryCollection open(const std::filesystem::path &file) {
+            if (op::MappedFile map{file}) {
+                BinaryCollection bc;
+                bc.map_ = std::move(map);
+                bc.load(bc.map_.view());
+                return bc;
+            }
+            std::ifstream ifs(file, std::ios::binary);
+            if (!ifs)
+                throw std::runtime_error("geoson::BinaryCollection::open(): cannot open \"" + file.string() + '\"');
+            const std::string bytes((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+            BinaryCollection bc;
+            bc.adopt(bytes);
+            return bc;
+        }
+
+        /// A collection held in memory. Used in place when `data` is 8-byte aligned, in which case it must outlive
+        /// the BinaryCollection; otherwise it is copied first.
+        static BinaryCollection fromBuffer(std::string_view data) {
+            BinaryCollection bc;
+            if (reinterpret_cast<std::uintptr_t>(data.data()) % alignof(double) == 0)
+                bc.load(data);
+            else
+                bc.adopt(data);
+            return bc;
+        }
+
+        BinaryCollection(BinaryCollection &&) noexcept = default;
+        BinaryCollection &operator=(BinaryCollection &&) noexcept = default;
+
+        const concord::Datum &datum() const { return datum_; }
+        const concord::Euler &heading() const { return heading_; }
+        const std::unordered_map<std::string, std::string> &global_properties() const { return globals_; }
+
+        std::size_t size() const { return features_; }
+        bool empty() const { return features_ == 0; }
+        /// total number of coordinates over all features
+        std::size_t pointCount() const { return points_; }
+
+        /// Feature `i`'s kind and coordinates, pointing into the file. Its `properties` is null: property bags
+        /// are decoded on demand by `properties(i)`.
+        FeatureView operator[](std::size_t i) const {
+            const std::size_t begin = offsets_[i];
+            return FeatureView{static_cast<GeometryKind>(kinds_[i]), x_ + begin, y_ + begin, z_ + begin,
+                               static_cast<std::size_t>(offsets_[i + 1]) - begin, nullptr};
+        }
+
+        FeatureView at(std::size_t i) const {
+            if (i >= size())
+                throw std::out_of_range("geoson::BinaryCollection::at(): index " + std::to_string(i) +
+                                        " out of range");
+            return (*this)[i];
+        }
+
+        /// the whole coordinate columns, ENU metres
+        const double *x() const { return x_; }
+        const double *y() const { return y_; }
+        const double *z() const { return z_; }
+
+        /// decodes feature `i`'s property bag
+        Properties properties(std::size_t i) const {
+            op::ByteSource in(records_ + record_offsets_[i], record_offsets_[i + 1] - record_offsets_[i]);
+            Properties props;
+            const auto count = in.count<std::uint32_t>(5); // key id and value kind at the least
+            props.reserve(count);
+            for (std::uint32_t k = 0; k < count; ++k) {
+                const auto key = in.pod<std::uint32_t>();
+                if (key >= keys_.size())
+                    throw std::runtime_error("geoson::BinaryCollection: property key out of range");
+                props.insert_or_assign(keys_[key], op::decodeValue(in));
+            }
+            return props;
+        }
+
+        Feature feature(std::size_t i) const { return Feature{(*this)[i].geometry(), properties(i)}; }
+
+        FeatureCollection toFeatureCollection() const {
+            FeatureCollection fc;
+            fc.datum = datum_;
+            fc.heading = heading_;
+            fc.global_properties = globals_;
+            fc.features.reserve(size());
+            for (std::size_t i = 0; i < size(); ++i)
+                fc.features.push_back(feature(i));
+            return fc;
+        }
+
+        /// copies the columns out in one go each
+        ColumnarCollection toColumnar() const {
+            ColumnarCollection cc;
+            cc.datum = datum_;
+            cc.heading = heading_;
+            cc.global_properties = globals_;
+            cc.x.assign(x_, x_ + points_);
+            cc.y.assign(y_, y_ + points_);
+            cc.z.assign(z_, z_ + points_);
+            cc.offsets.assign(offsets_, offsets_ + features_);
+            cc.kinds.reserve(features_);
+            cc.properties.reserve(features_);
+            for (std::size_t i = 0; i < features_; ++i) {
+                cc.kinds.push_back(static_cast<GeometryKind>(kinds_[i]));
+                cc.properties.push_back(properties(i));
+            }
+            return cc;
+        }
+
+        /// whether the file carries a spatial index
+        bool hasIndex() const { return index_.size != 0; }
+
+        /// The stored R-tree over the feature boxes (ids are feature indices), loaded without re-packing; files
+        /// written without one get it built from the coordinates.
+        SpatialIndex spatialIndex() const {
+            if (!hasIndex()) {
+                std::vector<Bounds> boxes;
+                boxes.reserve(size());
+                for (std::size_t i = 0; i < size(); ++i) {
+                    const FeatureView v = (*this)[i];
+                    Bounds b;
+                    for (std::size_t j = 0; j < v.size; ++j)
+                        b.expand(v.point(j));
+                    boxes.push_back(b);
+                }
+                return SpatialIndex(boxes);
+            }
+            constexpr std::size_t box_bytes = 6 * sizeof(double);
+            constexpr std::size_t entry_bytes = box_bytes + 8, node_bytes = box_bytes + 16;
+            op::ByteSource in(data_ + index_.offset, index_.size);
+            const auto entry_count = in.count<std::uint64_t>(entry_bytes);
+            std::vector<std::uint64_t> level_sizes(in.count<std::uint64_t>(8));
+            std::uint64_t nodes = 0;
+            for (auto &n : level_sizes) {
+                n = in.pod<std::uint64_t>();
+                in.need(nodes += n, node_bytes); // bounds the running total too, so it cannot wrap
+            }
+            in.need(entry_count * entry_bytes + nodes * node_bytes);
+            std::vector<std::vector<SpatialIndex::Node>> levels(level_sizes.size());
+            for (std::size_t l = 0; l < levels.size(); ++l)
+                levels[l].resize(level_sizes[l]);
+            std::vector<SpatialIndex::Entry> entries(entry_count);
+            for (auto &entry : entries) {
+                entry.box = in.box();
+                entry.id = in.pod<std::uint64_t>();
+                if (entry.id >= size())
+                    throw std::runtime_error("geoson::BinaryCollection: spatial index entry out of range");
+            }
+            for (std::size_t l = 0; l < levels.size(); ++l) {
+                const std::size_t children = l + 1 < levels.size() ? levels[l + 1].size() : entries.size();
+                for (auto &node : levels[l]) {
+                    node.box = in.box();
+                    node.first = in.pod<std::uint64_t>();
+                    node.count = in.pod<std::uint64_t>();
+                    if (node.first > children || node.count > children - node.first)
+                        throw std::runtime_error("geoson::BinaryCollection: spatial index node out of range");
+                }
+            }
+            if (!levels.empty() && levels[0].size() != 1)
+                throw std::runtime_error("geoson::BinaryCollection: spatial index has no single root");
+            return SpatialIndex(std::move(entries), std::move(levels));
+        }
+
+      private:
+        op::MappedFile map_;
+        std::unique_ptr<std::uint64_t[]> owned_;
+        const char *data_ = nullptr;
+
+        concord::Datum datum_;
+        concord::Euler heading_;
+        std::unordered_map<std::string, std::string> globals_;
+        std::size_t features_ = 0;
+        std::size_t points_ = 0;
+        const std::uint64_t *offsets_ = nullptr;
+        const std::uint8_t *kinds_ = nullptr;
+        const double *x_ = nullptr, *y_ = nullptr, *z_ = nullptr;
+        const std::uint64_t *record_offsets_ = nullptr;
+        const char *records_ = nullptr;
+        std::vector<PropertyKey> keys_;
+        op::BinarySection index_;
+
+        BinaryCollection() = default;
+
+        /// loads from a private, aligned copy of `bytes`
+        void adopt(std::string_view bytes) {
+            owned_.reset(new std::uint64_t[op::alignUp(bytes.size()) / 8]);
+            std::memcpy(owned_.get(), bytes.data(), bytes.size());
+            load({reinterpret_cast<const char *>(owned_.get()), bytes.size()});
+        }
+
+        [[noreturn]] static void fail(const std::string &what) {
+            throw std::runtime_error("geoson::BinaryCollection: " + what);
+        }
+
+        void load(std::string_view bytes) {
+            op::requireLittleEndian();
+            data_ = bytes.data();
+            op::BinaryHeader h;
+            if (bytes.size() < sizeof(h))
+                fail("not a binary collection (too short)");
+            std::memcpy(&h, data_, sizeof(h));
+            if (std::memcmp(h.magic, op::binary_magic, sizeof(h.magic)) != 0)
+                fail("not a binary collection (bad magic)");
+            if (h.version != op::binary_version)
+                fail("unsupported version " + std::to_string(h.version));
+
+            for (const op::BinarySection *s : {&h.offsets, &h.kinds, &h.x, &h.y, &h.z, &h.keys, &h.props,
+                                               &h.globals, &h.index})
+                if (s->offset % 8 != 0 || s->offset > bytes.size() || s->size > bytes.size() - s->offset)
+                    fail("section out of bounds");
+            const std::uint64_t n = h.features, p = h.points;
+            if (h.offsets.size / 8 != n + 1 || h.kinds.size != n || h.x.size / 8 != p || h.y.size / 8 != p ||
+                h.z.size / 8 != p || h.props.size < 8 * (n + 1))
+                fail("section sizes do not match the counts");
+
+            datum_ = concord::Datum{h.datum[0], h.datum[1], h.datum[2]};
+            heading_ = concord::Euler{0.0, 0.0, h.heading};
+            features_ = n;
+            points_ = p;
+            offsets_ = reinterpret_cast<const std::uint64_t *>(data_ + h.offsets.offset);
+            kinds_ = reinterpret_cast<const std::uint8_t *>(data_ + h.kinds.offset);
+            x_ = reinterpret_cast<const double *>(data_ + h.x.offset);
+            y_ = reinterpret_cast<const double *>(data_ + h.y.offset);
+            z_ = reinterpret_cast<const double *>(data_ + h.z.offset);
+            record_offsets_ = reinterpret_cast<const std::uint64_t *>(data_ + h.props.offset);
+            records_ = data_ + h.props.offset + 8 * (n + 1);
+            index_ = h.index;
+
+            const std::uint64_t records_size = h.props.size - 8 * (n + 1);
+            if (offsets_[n] != p || record_offsets_[n] > records_size)
+                fail("feature offsets out of range");
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::uint64_t size = offsets_[i + 1] - offsets_[i];
+                if (offsets_[i] > offsets_[i + 1] || record_offsets_[i] > record_offsets_[i + 1] || kinds_[i] > 3 ||
+                    (kinds_[i] == 0 && size != 1) || (kinds_[i] == 1 && size != 2))
+                    fail("corrupt feature table");
+            }
+
+            op::ByteSource keys(data_ + h.keys.offset, h.keys.size);
+            keys_.resize(keys.count<std::uint32_t>(4)); // each key starts with its length
+            for (auto &key : keys_)
+                key = PropertyKey(keys.text());
+
+            op::ByteSource globals(data_ + h.globals.offset, h.globals.size);
+            for (auto count = globals.pod<std::uint32_t>(); count > 0; --count) {
+                std::string key(globals.text());
+                globals_[std::move(key)] = std::string(globals.text());
+            }
+        }
+    };
+
+    /// write `cc` as a binary collection into a stream
+    inline void WriteBinaryCollection(ColumnarCollection const &cc, std::ostream &os, const BinaryOptions &opts = {}) {
+        op::OutputBuffer out(os);
+        op::writeBinary(cc, out, opts);
+    }
+
+    inline void WriteBinaryCollection(ColumnarCollection const &cc, std::filesystem::path const &outPath,
+                                      const BinaryOptions &opts = {}) {
+        std::ofstream ofs(outPath, std::ios::binary);
+        if (!ofs)
+            throw std::runtime_error("Cannot open for write: " + outPath.string());
+        WriteBinaryCollection(cc, ofs, opts);
+    }
+
+    /// the features are laid out as columns first; property bags are shared, not copied
+    inline void WriteBinaryCollection(FeatureCollection const &fc, std::ostream &os, const BinaryOptions &opts = {}) {
+        WriteBinaryCollection(ColumnarCollection(fc), os, opts);
+    }
+
+    inline void WriteBinaryCollection(FeatureCollection const &fc, std::filesystem::path const &outPath,
+                                      const BinaryOptions &opts = {}) {
+        WriteBinaryCollection(ColumnarCollection(fc), outPath, opts);
+    }
+
+    /// read a binary collection back into a FeatureCollection (see `BinaryCollection` for in-place access)
+    inline FeatureCollection ReadBinaryCollection(const std::filesystem::path &file) {
+        return BinaryCollection::open(file).toFeatureCollection();
+    }
+
+} // namespace geoson
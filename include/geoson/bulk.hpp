@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "concord/concord.hpp"
+
+#include "geoson/spatial.hpp"
+#include "geoson/types.hpp"
+
+namespace geoson {
+
+    namespace op {
+        template <typename Fn> void forEachPosition(const Geometry &geometry, Fn &&fn) {
+            std::visit(
+                [&](auto const &shape) {
+                    using T = std::decay_t<decltype(shape)>;
+                    if constexpr (std::is_same_v<T, concord::Point>) {
+                        fn(shape);
+                    } else if constexpr (std::is_same_v<T, concord::Line>) {
+                        fn(shape.getStart());
+                        fn(shape.getEnd());
+                    } else {
+                        for (auto const &p : shape.getPoints())
+                            fn(p);
+                    }
+                },
+                geometry);
+        }
+
+        inline std::vector<concord::Point> positions(const Geometry &geometry) {
+            std::vector<concord::Point> out;
+            forEachPosition(geometry, [&](const concord::Point &p) { out.push_back(p); });
+            return out;
+        }
+
+        /// a geometry of `like`'s kind over `pts`; a Point or Line takes the first one or two
+        inline Geometry withPositions(const Geometry &like, std::vector<concord::Point> pts) {
+            switch (like.index()) {
+            case 0:
+                return pts[0];
+            case 1:
+                return concord::Line{pts[0], pts[1]};
+            case 2:
+                return concord::Path{std::move(pts)};
+            default:
+                return concord::Polygon{std::move(pts)};
+            }
+        }
+
+        /// worker count for a `threads` knob: 0 means every hardware thread
+        inline unsigned workerCount(unsigned threads) {
+            return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        /// Splits [0, n) into at most `threads` contiguous ranges of at least `grain` items and calls `fn(begin,
+        /// end)` for each, the first range on the calling thread and the others on `std::async` workers. Returns
+        /// the results in range order (nothing for a void `fn`); a worker's exception is rethrown here.
+        template <typename Fn> auto forRanges(std::size_t n, unsigned threads, std::size_t grain, Fn &&fn) {
+            using R = std::invoke_result_t<Fn &, std::size_t, std::size_t>;
+            const std::size_t fit = n / std::max<std::size_t>(grain, 1);
+            const std::size_t ranges = std::max<std::size_t>(1, std::min<std::size_t>(workerCount(threads), fit));
+            const std::size_t step = (n + ranges - 1) / ranges;
+
+            std::vector<std::future<R>> rest;
+            rest.reserve(ranges - 1);
+            for (std::size_t r = 1; r < ranges; ++r) {
+                const std::size_t begin = std::min(n, r * step), end = std::min(n, begin + step);
+                rest.push_back(std::async(std::launch::async, [&fn, begin, end] { return fn(begin, end); }));
+            }
+            if constexpr (std::is_void_v<R>) {
+                fn(0, std::min(n, step));
+                for (auto &f : rest)
+                    f.get();
+            } else {
+                std::vector<R> out;
+                out.reserve(ranges);
+                out.push_back(fn(0, std::min(n, step)));
+                for (auto &f : rest)
+                    out.push_back(f.get());
+                return out;
+            }
+        }
+
+        /// Elements handed to one worker by the bulk operations: enough that starting a thread pays off.
+        inline constexpr std::size_t bulk_grain = 1024;
+
+        /// Runs `kernel(points, count)` over the coordinates of geometries `at(0)` .. `at(n - 1)`: each worker
+        /// gathers its share into one contiguous buffer, calls the kernel on it once and rebuilds the geometries
+        /// from the result. `kernel` must be safe to call from several threads at once.
+        template <typename At, typename Kernel>
+        void transformGeometries(std::size_t n, unsigned threads, At &&at, Kernel &&kernel) {
+            forRanges(n, threads, bulk_grain, [&](std::size_t begin, std::size_t end) {
+                std::vector<concord::Point> pts;
+                std::vector<std::size_t> offsets;
+                offsets.reserve(end - begin + 1);
+                for (std::size_t i = begin; i < end; ++i) {
+                    offsets.push_back(pts.size());
+                    forEachPosition(at(i), [&](const concord::Point &p) { pts.push_back(p); });
+                }
+                offsets.push_back(pts.size());
+                kernel(pts.data(), pts.size());
+                for (std::size_t i = begin; i < end; ++i) {
+                    Geometry &g = at(i);
+                    auto first = pts.begin() + static_cast<std::ptrdiff_t>(offsets[i - begin]);
+                    auto last = pts.begin() + static_cast<std::ptrdiff_t>(offsets[i - begin + 1]);
+                    g = withPositions(g, std::vector<concord::Point>(first, last));
+                }
+            });
+        }
+
+        /// Douglas-Peucker over `pts` in the x/y plane: keeps the end points and every point further than
+        /// `tolerance` metres from the simplified line. Polygons keep at least three corners (plus a closing point).
+        inline std::vector<concord::Point> simplify(const std::vector<concord::Point> &pts, double tolerance,
+                                                    bool polygon) {
+            const std::size_t n = pts.size();
+            if (n < 3 || tolerance <= 0.0)
+                return pts;
+            std::vector<bool> keep(n, false);
+            keep.front() = keep.back() = true;
+            std::vector<std::pair<std::size_t, std::size_t>> stack{{0, n - 1}};
+            while (!stack.empty()) {
+                auto [a, b] = stack.back();
+                stack.pop_back();
+                double worst = 0.0;
+                std::size_t at = a;
+                for (std::size_t i = a + 1; i < b; ++i) {
+                    const double d = segmentDistance(pts[a], pts[b], pts[i].x, pts[i].y);
+                    if (d > worst)
+                        worst = d, at = i;
+                }
+                if (worst > tolerance) {
+                    keep[at] = true;
+                    stack.emplace_back(a, at);
+                    stack.emplace_back(at, b);
+                }
+            }
+            std::vector<concord::Point> out;
+            for (std::size_t i = 0; i < n; ++i)
+                if (keep[i])
+                    out.push_back(pts[i]);
+            const bool closed = pts.front().x == pts.back().x && pts.front().y == pts.back().y &&
+                                pts.front().z == pts.back().z;
+            if (polygon && out.size() < (closed ? 4u : 3u))
+                return pts;
+            return out;
+        }
+    } // namespace op
+
+} // namespace geoson
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "concord/concord.hpp"
+
+#include "geoson/reader.hpp"
+#include "geoson/transform.hpp"
+#include "geoson/types.hpp"
+#include "geoson/writter.hpp"
+
+namespace geoson {
+
+    /// geometry alternative of a columnar feature; the values follow `Geometry`'s variant index
+    enum class GeometryKind : std::uint8_t { Point, Line, Path, Polygon };
+
+    /// One feature of a ColumnarCollection: its kind, `size` consecutive coordinates and its properties.
+    struct FeatureView {
+        GeometryKind kind;
+        const double *x;
+        const double *y;
+        const double *z;
+        std::size_t size;
+        const Properties *properties;
+
+        concord::Point point(std::size_t i) const { return concord::Point{x[i], y[i], z[i]}; }
+
+        /// the feature's geometry as a freshly built `Geometry`
+        Geometry geometry() const {
+            switch (kind) {
+            case GeometryKind::Point:
+                return point(0);
+            case GeometryKind::Line:
+                return concord::Line{point(0), point(1)};
+            default: {
+                std::vector<concord::Point> pts;
+                pts.reserve(size);
+                for (std::size_t i = 0; i < size; ++i)
+                    pts.push_back(point(i));
+                if (kind == GeometryKind::Path)
+                    return concord::Path{pts};
+                return concord::Polygon{pts};
+            }
+            }
+        }
+    };
+
+    /// Structure-of-arrays counterpart of FeatureCollection: all coordinates of all features live in three
+    /// contiguous x/y/z columns (ENU, like FeatureCollection), and feature `i` owns the points from `offsets[i]` up
+    /// to the next feature's offset (or the end of the columns). Bounds, transforms and the WGS conversion on write
+    /// become linear passes over plain doubles.
+    ///
+    /// The columns are public for bulk work; keep `offsets`, `kinds` and `properties` the same length and the
+    /// offsets non-decreasing, which `push_back` does.
+    struct ColumnarCollection {
+        concord::Datum datum;
+        concord::Euler heading;
+        std::unordered_map<std::string, std::string> global_properties;
+
+        std::vector<double> x, y, z;
+        std::vector<std::size_t> offsets;
+        std::vector<GeometryKind> kinds;
+        std::vector<Properties> properties;
+
+        ColumnarCollection() = default;
+
+        /// columns for an existing collection; property bags are shared, not copied
+        explicit ColumnarCollection(const FeatureCollection &fc)
+            : datum(fc.datum), heading(fc.heading), global_properties(fc.global_properties) {
+            std::size_t points = 0;
+            for (auto const &f : fc.features)
+                points += pointCount(f.geometry);
+            reserve(fc.features.size(), points);
+            for (auto const &f : fc.features)
+                push_back(f.geometry, f.properties);
+        }
+
+        std::size_t size() const { return kinds.size(); }
+        bool empty() const { return kinds.empty(); }
+        /// total number of coordinates over all features
+        std::size_t pointCount() const { return x.size(); }
+
+        void reserve(std::size_t features, std::size_t points) {
+            offsets.reserve(features);
+            kinds.reserve(features);
+            properties.reserve(features);
+            x.reserve(points);
+            y.reserve(points);
+            z.reserve(points);
+        }
+
+        void clear() {
+            x.clear();
+            y.clear();
+            z.clear();
+            offsets.clear();
+            kinds.clear();
+            properties.clear();
+        }
+
+        void push_back(const Geometry &geometry, Properties props = {}) {
+            offsets.push_back(x.size());
+            kinds.push_back(static_cast<GeometryKind>(geometry.index()));
+            properties.push_back(std::move(props));
+            std::visit(
+                [&](auto const &shape) {
+                    using T = std::decay_t<decltype(shape)>;
+                    if constexpr (std::is_same_v<T, concord::Point>) {
+                        append(shape);
+                    } else if constexpr (std::is_same_v<T, concord::Line>) {
+                        append(shape.getStart());
+                        append(shape.getEnd());
+                    } else {
+                        for (auto const &p : shape.getPoints())
+                            append(p);
+                    }
+                },
+                geometry);
+        }
+
+        void push_back(const Feature &f) { push_back(f.geometry, f.properties); }
+
+        FeatureView operator[](std::size_t i) const {
+            const std::size_t begin = offsets[i];
+            const std::size_t end = i + 1 < offsets.size() ? offsets[i + 1] : x.size();
+            return FeatureView{kinds[i], x.data() + begin, y.data() + begin, z.data() + begin, end - begin,
+                               &properties[i]};
+        }
+
+        FeatureView at(std::size_t i) const {
+            if (i >= size())
+                throw std::out_of_range("geoson::ColumnarCollection::at(): index " + std::to_string(i) +
+                                        " out of range");
+            return (*this)[i];
+        }
+
+        Feature feature(std::size_t i) const { return Feature{(*this)[i].geometry(), properties[i]}; }
+
+        /// back to the row layout; property bags are shared, not copied
+        FeatureCollection toFeatureCollection() const {
+            FeatureCollection fc;
+            fc.datum = datum;
+            fc.heading = heading;
+            fc.global_properties = global_properties;
+            fc.features.reserve(size());
+            for (std::size_t i = 0; i < size(); ++i)
+                fc.features.push_back(feature(i));
+            return fc;
+        }
+
+        /// box around every coordinate of every feature
+        Bounds bounds() const { return span(0, x.size()); }
+
+        /// box around feature `i`
+        Bounds bounds(std::size_t i) const {
+            auto v = (*this)[i];
+            const std::size_t begin = offsets[i];
+            return span(begin, begin + v.size);
+        }
+
+        /// shifts every coordinate by (dx, dy, dz) metres
+        void translate(double dx, double dy, double dz = 0.0) {
+            for (auto &v : x)
+                v += dx;
+            for (auto &v : y)
+                v += dy;
+            for (auto &v : z)
+                v += dz;
+        }
+
+      private:
+        void append(const concord::Point &p) {
+            x.push_back(p.x);
+            y.push_back(p.y);
+            z.push_back(p.z);
+        }
+
+        static std::size_t pointCount(const Geometry &geometry) {
+            return std::visit(
+                [](auto const &shape) -> std::size_t {
+                    using T = std::decay_t<decltype(shape)>;
+                    if constexpr (std::is_same_v<T, concord::Point>)
+                        return 1;
+                    else if constexpr (std::is_same_v<T, concord::Line>)
+                        return 2;
+                    else
+                        return shape.getPoints().size();
+                },
+                geometry);
+        }
+
+        // one column at a time, so each min/max loop is a plain reduction over contiguous doubles
+        Bounds span(std::size_t begin, std::size_t end) const {
+            Bounds b;
+            auto reduce = [&](const std::vector<double> &col, double &lo, double &hi) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    lo = std::min(lo, col[i]);
+                    hi = std::max(hi, col[i]);
+                }
+            };
+            reduce(x, b.min_x, b.max_x);
+            reduce(y, b.min_y, b.max_y);
+            reduce(z, b.min_z, b.max_z);
+            return b;
+        }
+    };
+
+    namespace op {
+        /// streaming writer for the columnar layout; the bytes match `emitFeatureCollection` on the equivalent
+        /// FeatureCollection. For WGS output the whole coordinate columns are converted in one batch up front.
+        inline void emitColumnar(JsonEmitter &e, ColumnarCollection const &cc, geoson::CRS outputCrs,
+                                 const WriteOptions &opts = {}) {
+            const double *x = cc.x.data(), *y = cc.y.data(), *z = cc.z.data();
+            std::vector<double> lon, lat, alt;
+            if (outputCrs == geoson::CRS::WGS) {
+                const std::size_t n = cc.pointCount();
+                lon.resize(n);
+                lat.resize(n);
+                alt.resize(n);
+                DatumTransform::shared(cc.datum)->toWGS(n, x, y, z, lon.data(), lat.data(), alt.data());
+                x = lon.data();
+                y = lat.data();
+                z = alt.data();
+            }
+
+            e.beginObject();
+            e.key("features");
+            e.beginArray();
+            for (std::size_t i = 0; i < cc.size(); ++i) {
+                const FeatureView v = cc[i];
+                const std::size_t base = cc.offsets[i];
+                const bool with_z = emitsZ(v.size, [&](std::size_t j) { return z[base + j]; }, opts);
+                auto coords = [&](std::size_t j) {
+                    emitCoords(e, concord::Point{x[base + j], y[base + j], z[base + j]}, outputCrs, opts, with_z);
+                };
+                auto ring = [&] {
+                    e.beginArray();
+                    for (std::size_t j = 0; j < v.size; ++j)
+                        coords(j);
+                    e.endArray();
+                };
+
+                e.beginObject();
+                e.key("geometry");
+                e.beginObject();
+                e.key("coordinates");
+                switch (v.kind) {
+                case GeometryKind::Point:
+                    coords(0);
+                    break;
+                case GeometryKind::Polygon:
+                    e.beginArray();
+                    ring();
+                    e.endArray();
+                    break;
+                default:
+                    ring();
+                }
+                e.key("type");
+                e.value(v.kind == GeometryKind::Point     ? "Point"
+                        : v.kind == GeometryKind::Polygon ? "Polygon"
+                                                          : "LineString");
+                e.endObject();
+                e.key("properties");
+                emitProperties(e, *v.properties);
+                e.key("type");
+                e.value("Feature");
+                e.endObject();
+            }
+            e.endArray();
+            e.key("properties");
+            emitHeader(e, cc.datum, cc.heading, cc.global_properties, outputCrs);
+            e.key("type");
+            e.value("FeatureCollection");
+            e.endObject();
+        }
+
+        template <typename Reader> ColumnarCollection readColumnar(Reader &reader) {
+            ColumnarCollection cc;
+            cc.datum = reader.header().datum;
+            cc.heading = reader.header().heading;
+            cc.global_properties = reader.header().global_properties;
+            Feature f;
+            while (reader.next(f))
+                cc.push_back(std::move(f.geometry), std::move(f.properties));
+            return cc;
+        }
+    } // namespace op
+
+    /// read a FeatureCollection straight into columns, one feature at a time
+    inline ColumnarCollection ReadColumnarCollection(std::istream &is) {
+        FeatureReader reader(is);
+        return op::readColumnar(reader);
+    }
+
+    inline ColumnarCollection ReadColumnarCollectionFromBuffer(std::string_view data) {
+        auto reader = FeatureReader::fromBuffer(data);
+        return op::readColumnar(reader);
+    }
+
+    /// regular files are memory-mapped, as in `ReadFeatureCollection`
+    inline ColumnarCollection ReadColumnarCollection(const std::filesystem::path &file) {
+        FeatureReader reader(file);
+        return op::readColumnar(reader);
+    }
+
+    /// same output as writing `cc.toFeatureCollection()`, compact by default
+    inline void WriteFeatureCollection(ColumnarCollection const &cc, std::ostream &os,
+                                       geoson::CRS outputCrs = geoson::CRS::ENU,
+                                       const WriteOptions &opts = WriteOptions::compact()) {
+        op::OutputBuffer out(os);
+        op::JsonEmitter e(out, opts.indent);
+        op::emitColumnar(e, cc, outputCrs, opts);
+    }
+
+    /// same output as writing `cc.toFeatureCollection()`, pretty-printed unless `opts` says otherwise
+    inline void WriteFeatureCollection(ColumnarCollection const &cc, std::filesystem::path const &outPath,
+                                       geoson::CRS outputCrs = geoson::CRS::ENU, const WriteOptions &opts = {}) {
+        std::ofstream ofs(outPath, std::ios::binary);
+        if (!ofs)
+            throw std::runtime_error("Cannot open for write: " + outPath.string());
+        op::OutputBuffer out(ofs);
+        op::JsonEmitter e(out, opts.indent);
+        op::emitColumnar(e, cc, outputCrs, opts);
+        out.put('\n');
+    }
+
+} // namespace geoson
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "geoson/bulk.hpp"
+#include "geoson/parser.hpp"
+#include "geoson/types.hpp"
+#include "geoson/writter.hpp"
+
+namespace geoson {
+
+    /// How `diff` recognises a feature across two revisions of a collection.
+    struct DiffOptions {
+        /// Property holding a stable feature ID. Left empty, or for features without it, the ID is a hash of the
+        /// feature's geometry and properties, so any edit to such a feature shows up as a removal plus an addition.
+        std::string id_key;
+        /// largest per-coordinate change, in metres, for which a geometry still counts as unchanged
+        double tolerance = 0.0;
+    };
+
+    /// The edits to one feature present in both revisions.
+    struct FeatureChange {
+        std::string id;
+        std::optional<Geometry> geometry; ///< the new geometry, when it changed
+        Properties set;                   ///< properties added or given a new value
+        std::vector<std::string> unset;   ///< properties dropped
+    };
+
+    /// Feature-level difference between two revisions of a collection, as made by `diff` and replayed by
+    /// `applyPatch`. Features are named by their ID (see `DiffOptions::id_key`); an ID seen n > 0 times before in
+    /// the same collection gets a "~n" suffix, so repeated IDs and identical features still pair up in order.
+    /// Coordinates are ENU, as held in memory.
+    struct FeaturePatch {
+        std::string id_key;
+        std::vector<std::string> removed;
+        std::vector<FeatureChange> modified;
+        std::vector<Feature> added; ///< appended after the existing features
+
+        std::optional<concord::Datum> datum;
+        std::optional<concord::Euler> heading;
+        std::unordered_map<std::string, std::string> set_global;
+        std::vector<std::string> unset_global;
+
+        bool empty() const {
+            return removed.empty() && modified.empty() && added.empty() && !datum && !heading && set_global.empty() &&
+                   unset_global.empty();
+        }
+    };
+
+    namespace op {
+        /// same kind and shape, every coordinate within `tolerance`
+        inline bool sameGeometry(const Geometry &a, const Geometry &b, double tolerance) {
+            if (a.index() != b.index())
+                return false;
+            const auto pa = positions(a), pb = positions(b);
+            if (pa.size() != pb.size())
+                return false;
+            for (std::size_t i = 0; i < pa.size(); ++i)
+                if (!(std::abs(pa[i].x - pb[i].x) <= tolerance && std::abs(pa[i].y - pb[i].y) <= tolerance &&
+                      std::abs(pa[i].z - pb[i].z) <= tolerance))
+                    return false;
+            return true;
+        }
+
+        /// FNV-1a over the geometry's kind and coordinate bits and the properties in any order
+        inline std::uint64_t contentHash(const Geometry &geometry, const Properties &properties) {
+            constexpr std::uint64_t basis = 14695981039346656037ull, prime = 1099511628211ull;
+            auto mix = [&](std::uint64_t h, const void *data, std::size_t n) {
+                auto *bytes = static_cast<const unsigned char *>(data);
+                for (std::size_t i = 0; i < n; ++i)
+                    h = (h ^ bytes[i]) * prime;
+                return h;
+            };
+
+            const auto kind = static_cast<std::uint64_t>(geometry.index());
+            std::uint64_t h = mix(basis, &kind, sizeof kind);
+            forEachPosition(geometry, [&](const concord::Point &p) {
+                const double xyz[3] = {p.x + 0.0, p.y + 0.0, p.z + 0.0}; // -0.0 hashes as 0.0
+                h = mix(h, xyz, sizeof xyz);
+            });
+
+            std::uint64_t props = 0; // entry order must not matter, so entries are summed
+            for (auto const &[key, value] : properties) {
+                const auto k = static_cast<unsigned char>(value.kind());
+                const std::string text = value.str();
+                std::uint64_t e = mix(basis, key.str().data(), key.str().size());
+                e = mix(e, &k, 1);
+                props += mix(e, text.data(), text.size());
+            }
+            return mix(h, &props, sizeof props);
+        }
+
+        /// Hands out the IDs of a collection's features, taken in collection order.
+        class FeatureIds {
+          public:
+            explicit FeatureIds(std::string key) : key_(std::move(key)) {}
+
+            std::string next(const Geometry &geometry, const Properties &properties) {
+                std::string id;
+                auto it = key_.empty() ? properties.end() : properties.find(key_);
+                if (it != properties.end()) {
+                    id = it->second.str();
+                } else {
+                    static constexpr char hex[] = "0123456789abcdef";
+                    std::uint64_t h = contentHash(geometry, properties);
+                    id.assign(17, '#');
+                    for (int i = 16; i > 0; --i, h >>= 4)
+                        id[static_cast<std::size_t>(i)] = hex[h & 0xf];
+                }
+                const std::size_t n = seen_[id]++;
+                return n == 0 ? id : id + '~' + std::to_string(n);
+            }
+
+          private:
+            std::string key_;
+            std::unordered_map<std::string, std::size_t> seen_;
+        };
+
+        /// position of feature `id` in `where`; throws naming `who` when the patch does not fit the collection
+        inline std::size_t patchTarget(const std::unordered_map<std::string, std::size_t> &where, const std::string &id,
+                                       const char *who) {
+            auto it = where.find(id);
+            if (it == where.end())
+                throw std::runtime_error(std::string(who) + ": patch names feature \"" + id +
+                                         "\", which the collection does not have");
+            return it->second;
+        }
+
+        inline void applyChange(Geometry &geometry, Properties &properties, const FeatureChange &change) {
+            if (change.geometry)
+                geometry = *change.geometry;
+            for (auto const &key : change.unset)
+                properties.erase(key);
+            for (auto const &[key, value] : change.set)
+                properties.insert_or_assign(key, value);
+        }
+
+        inline void applyHeader(const FeaturePatch &patch, concord::Datum &datum, concord::Euler &heading,
+                                std::unordered_map<std::string, std::string> &global_properties) {
+            if (patch.datum)
+                datum = *patch.datum;
+            if (patch.heading)
+                heading = *patch.heading;
+            for (auto const &key : patch.unset_global)
+                global_properties.erase(key);
+            for (auto const &[key, value] : patch.set_global)
+                global_properties[key] = value;
+        }
+
+        /// the ENU frame patches are written in; no coordinate is ever converted through it
+        inline const DatumTransform &patchFrame() {
+            static const DatumTransform tf(concord::Datum{0.0, 0.0, 0.0});
+            return tf;
+        }
+    } // namespace op
+
+    /// Changes that turn `from` into `to`: features only in `from` are removed, features only in `to` are added,
+    /// and features in both carry their geometry (if it moved beyond `opts.tolerance`) and property deltas.
+    /// Geometries are compared in each collection's own ENU frame, as held in memory.
+    inline FeaturePatch diff(const FeatureCollection &from, const FeatureCollection &to, const DiffOptions &opts = {}) {
+        FeaturePatch patch;
+        patch.id_key = opts.id_key;
+
+        if (from.datum.lat != to.datum.lat || from.datum.lon != to.datum.lon || from.datum.alt != to.datum.alt)
+            patch.datum = to.datum;
+        if (from.heading.roll != to.heading.roll || from.heading.pitch != to.heading.pitch ||
+            from.heading.yaw != to.heading.yaw)
+            patch.heading = to.heading;
+        for (auto const &[key, value] : to.global_properties) {
+            auto it = from.global_properties.find(key);
+            if (it == from.global_properties.end() || it->second != value)
+                patch.set_global.emplace(key, value);
+        }
+        for (auto const &[key, value] : from.global_properties)
+            if (!to.global_properties.count(key))
+                patch.unset_global.push_back(key);
+
+        op::FeatureIds from_ids(opts.id_key), to_ids(opts.id_key);
+        std::vector<std::string> old_ids;
+        std::unordered_map<std::string, std::size_t> where;
+        old_ids.reserve(from.features.size());
+        where.reserve(from.features.size());
+        for (std::size_t i = 0; i < from.features.size(); ++i) {
+            old_ids.push_back(from_ids.next(from.features[i].geometry, from.features[i].properties));
+            where.emplace(old_ids.back(), i);
+        }
+
+        std::vector<bool> kept(from.features.size(), false);
+        for (auto const &feature : to.features) {
+            std::string id = to_ids.next(feature.geometry, feature.properties);
+            auto it = where.find(id);
+            if (it == where.end()) {
+                patch.added.push_back(feature);
+                continue;
+            }
+            kept[it->second] = true;
+            const Feature &old = from.features[it->second];
+
+            FeatureChange change;
+            if (!op::sameGeometry(old.geometry, feature.geometry, opts.tolerance))
+                change.geometry = feature.geometry;
+            for (auto const &[key, value] : feature.properties) {
+                auto prev = old.properties.find(key.str());
+                if (prev == old.properties.end() || !(prev->second == value))
+                    change.set.insert_or_assign(key, value);
+            }
+            for (auto const &[key, value] : old.properties)
+                if (!feature.properties.contains(key.str()))
+                    change.unset.push_back(key.str());
+            if (change.geometry || !change.set.empty() || !change.unset.empty()) {
+                change.id = std::move(id);
+                patch.modified.push_back(std::move(change));
+            }
+        }
+        for (std::size_t i = 0; i < kept.size(); ++i)
+            if (!kept[i])
+                patch.removed.push_back(old_ids[i]);
+        return patch;
+    }
+
+    /// Replays `patch` on the collection it was made from: changed features are edited in place, removed ones
+    /// erased (the rest keep their order) and added ones appended. Throws, leaving `fc` untouched, when the patch
+    /// names a feature `fc` does not have.
+    inline void applyPatch(FeatureCollection &fc, const FeaturePatch &patch) {
+        constexpr const char *who = "geoson::applyPatch()";
+        op::FeatureIds ids(patch.id_key);
+        std::unordered_map<std::string, std::size_t> where;
+        where.reserve(fc.features.size());
+        for (std::size_t i = 0; i < fc.features.size(); ++i)
+            where.emplace(ids.next(fc.features[i].geometry, fc.features[i].properties), i);
+
+        std::vector<std::size_t> changed;
+        changed.reserve(patch.modified.size());
+        for (auto const &change : patch.modified)
+            changed.push_back(op::patchTarget(where, change.id, who));
+        std::vector<bool> gone(fc.features.size(), false);
+        for (auto const &id : patch.removed)
+            gone[op::patchTarget(where, id, who)] = true;
+
+        for (std::size_t k = 0; k < changed.size(); ++k) {
+            Feature &f = fc.features[changed[k]];
+            op::applyChange(f.geometry, f.properties, patch.modified[k]);
+        }
+        if (!patch.removed.empty()) {
+            std::size_t out = 0;
+            for (std::size_t i = 0; i < fc.features.size(); ++i) {
+                if (gone[i])
+                    continue;
+                if (out != i)
+                    fc.features[out] = std::move(fc.features[i]);
+                ++out;
+            }
+            fc.features.resize(out);
+        }
+        fc.features.insert(fc.features.end(), patch.added.begin(), patch.added.end());
+        op::applyHeader(patch, fc.datum, fc.heading, fc.global_properties);
+    }
+
+    /// the patch as compact-friendly JSON; geometries are GeoJSON objects with ENU coordinates
+    inline nlohmann::json toJson(const FeaturePatch &patch) {
+        auto props = [](const Properties &p) {
+            nlohmann::json j = nlohmann::json::object();
+            for (auto const &[key, value] : p)
+                j[key.str()] = propertyToJson(value);
+            return j;
+        };
+
+        nlohmann::json j;
+        j["type"] = "FeaturePatch";
+        j["id_key"] = patch.id_key;
+        if (patch.datum)
+            j["datum"] = nlohmann::json::array({patch.datum->lat, patch.datum->lon, patch.datum->alt});
+        if (patch.heading)
+            j["heading"] = patch.heading->yaw;
+        if (!patch.set_global.empty())
+            j["set_global"] = patch.set_global;
+        if (!patch.unset_global.empty())
+            j["unset_global"] = patch.unset_global;
+
+        j["removed"] = patch.removed;
+        j["modified"] = nlohmann::json::array();
+        for (auto const &change : patch.modified) {
+            nlohmann::json c;
+            c["id"] = change.id;
+            if (change.geometry)
+                c["geometry"] = geometryToJson(*change.geometry, op::patchFrame(), CRS::ENU);
+            if (!change.set.empty())
+                c["set"] = props(change.set);
+            if (!change.unset.empty())
+                c["unset"] = change.unset;
+            j["modified"].push_back(std::move(c));
+        }
+        j["added"] = nlohmann::json::array();
+        for (auto const &feature : patch.added)
+            j["added"].push_back(featureToJson(feature, op::patchFrame(), CRS::ENU));
+        return j;
+    }
+
+    inline FeaturePatch parseFeaturePatch(const nlohmann::json &j) {
+        if (!j.is_object() || j.value("type", "") != "FeaturePatch")
+            throw std::runtime_error("geoson::parseFeaturePatch(): not a FeaturePatch document");
+        auto geometry = [](const nlohmann::json &g) {
+            auto parts = parseGeometry(g, op::patchFrame(), CRS::ENU);
+            if (parts.size() != 1)
+                throw std::runtime_error("geoson::parseFeaturePatch(): expected a single geometry");
+            return std::move(parts.front());
+        };
+
+        FeaturePatch patch;
+        patch.id_key = j.value("id_key", "");
+        if (j.contains("datum")) {
+            auto &d = j.at("datum");
+            patch.datum = concord::Datum{d.at(0).get<double>(), d.at(1).get<double>(), d.at(2).get<double>()};
+        }
+        if (j.contains("heading"))
+            patch.heading = concord::Euler{0.0, 0.0, j.at("heading").get<double>()};
+        if (j.contains("set_global"))
+            patch.set_global = j.at("set_global").get<std::unordered_map<std::string, std::string>>();
+        if (j.contains("unset_global"))
+            patch.unset_global = j.at("unset_global").get<std::vector<std::string>>();
+
+        patch.removed = j.value("removed", std::vector<std::string>{});
+        for (auto const &c : j.value("modified", nlohmann::json::array())) {
+            FeatureChange change;
+            change.id = c.at("id").get<std::string>();
+            if (c.contains("geometry"))
+                change.geometry = geometry(c.at("geometry"));
+            if (c.contains("set"))
+                change.set = parseProperties(c.at("set"));
+            if (c.contains("unset"))
+                change.unset = c.at("unset").get<std::vector<std::string>>();
+            patch.modified.push_back(std::move(change));
+        }
+        for (auto const &f : j.value("added", nlohmann::json::array()))
+            patch.added.push_back(Feature{geometry(f.at("geometry")), parseProperties(f.value("properties",
+                                                                                               nlohmann::json::object()))});
+        return patch;
+    }
+
+    /// compact JSON: patches are meant to travel
+    inline void WriteFeaturePatch(const FeaturePatch &patch, std::ostream &os) { os << toJson(patch).dump() << '\n'; }
+
+    inline void WriteFeaturePatch(const FeaturePatch &patch, const std::filesystem::path &file) {
+        std::ofstream ofs(file, std::ios::binary);
+        if (!ofs)
+            throw std::runtime_error("Cannot open for write: " + file.string());
+        WriteFeaturePatch(patch, ofs);
+    }
+
+    inline FeaturePatch ReadFeaturePatch(std::istream &is) { return parseFeaturePatch(nlohmann::json::parse(is)); }
+
+    inline FeaturePatch ReadFeaturePatch(const std::filesystem::path &file) {
+        std::ifstream ifs(file, std::ios::binary);
+        if (!ifs)
+            throw std::runtime_error("Cannot open for read: " + file.string());
+        return ReadFeaturePatch(ifs);
+    }
+
+} // namespace geoson
@@ -1,6 +1,16 @@
 #pragma once
 
+#include "binary.hpp"
+#include "bulk.hpp"
+#include "columnar.hpp"
+#include "diff.hpp"
+#include "lazy.hpp"
 #include "parser.hpp"
+#include "reader.hpp"
+#include "spatial.hpp"
+#include "stats.hpp"
+#include "tiles.hpp"
+#include "transform.hpp"
 #include "types.hpp"
 #include "writter.hpp"
 
@@ -10,6 +20,21 @@ namespace geoson {
     // Read function alias
     inline FeatureCollection read(const std::filesystem::path &file) { return ReadFeatureCollection(file); }
 
+    // Read function alias - with reader options (e.g. parallel feature parsing)
+    inline FeatureCollection read(const std::filesystem::path &file, const ReadOptions &opts) {
+        return ReadFeatureCollection(file, opts);
+    }
+
+    // In-memory read alias - parses a document we already hold (e.g. a message payload) without a temp file
+    inline FeatureCollection read_from_buffer(std::string_view data, const ReadOptions &opts = {}) {
+        return ReadFeatureCollectionFromBuffer(data, opts);
+    }
+
+    // Streaming read alias - visits features one at a time; return false from `fn` to stop early
+    template <typename Fn> void for_each_feature(const std::filesystem::path &file, Fn &&fn) {
+        ForEachFeature(file, std::forward<Fn>(fn));
+    }
+
     // Write function aliases - with CRS choice
     inline void write(const FeatureCollection &fc, const std::filesystem::path &outPath, CRS outputCrs) {
         WriteFeatureCollection(fc, outPath, outputCrs);
@@ -21,4 +46,14 @@ namespace geoson {
         WriteFeatureCollection(fc, outPath);
     }
 
+    // Write function aliases - with formatting options (indentation, coordinate precision, z omission)
+    inline void write(const FeatureCollection &fc, const std::filesystem::path &outPath, CRS outputCrs,
+                      const WriteOptions &opts) {
+        WriteFeatureCollection(fc, outPath, outputCrs, opts);
+    }
+
+    inline void write(const FeatureCollection &fc, const std::filesystem::path &outPath, const WriteOptions &opts) {
+        WriteFeatureCollection(fc, outPath, CRS::ENU, opts);
+    }
+
 } // namespace geoson
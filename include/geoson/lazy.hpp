@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "geoson/parser.hpp"
+#include "geoson/reader.hpp"
+#include "geoson/types.hpp"
+
+namespace geoson {
+
+    namespace op {
+        /// Calls `fn(key, value)` for each member of the JSON object `text`, `key` as written between its quotes
+        /// and `value` as raw text; stops as soon as `fn` returns true. Values are only delimited, never parsed,
+        /// and malformed input simply ends the walk (the full parse reports it, should the feature be decoded).
+        template <typename Fn> void forEachMember(std::string_view text, Fn &&fn) {
+            std::size_t i = 0;
+            const std::size_t n = text.size();
+            auto ws = [&] {
+                while (i < n && (text[i] == ' ' || text[i] == '\t' || text[i] == '\n' || text[i] == '\r'))
+                    ++i;
+            };
+            auto skipString = [&] { // at the opening quote; leaves i past the closing one
+                for (++i; i < n && text[i] != '"'; ++i)
+                    if (text[i] == '\\')
+                        ++i;
+                ++i;
+            };
+
+            ws();
+            if (i >= n || text[i] != '{')
+                return;
+            ++i;
+            while (true) {
+                ws();
+                if (i >= n || text[i] != '"')
+                    return;
+                const std::size_t key_begin = i + 1;
+                skipString();
+                if (i > n)
+                    return;
+                const std::string_view key = text.substr(key_begin, i - 1 - key_begin);
+                ws();
+                if (i >= n || text[i] != ':')
+                    return;
+                ++i;
+                ws();
+
+                const std::size_t value_begin = i;
+                if (i < n && text[i] == '"') {
+                    skipString();
+                } else if (i < n && (text[i] == '{' || text[i] == '[')) {
+                    int depth = 0;
+                    do {
+                        if (text[i] == '"') {
+                            skipString();
+                            continue;
+                        }
+                        if (text[i] == '{' || text[i] == '[')
+                            ++depth;
+                        else if (text[i] == '}' || text[i] == ']')
+                            --depth;
+                        ++i;
+                    } while (i < n && depth > 0);
+                } else {
+                    while (i < n && text[i] != ',' && text[i] != '}' && text[i] != ' ' && text[i] != '\t' &&
+                           text[i] != '\n' && text[i] != '\r')
+                        ++i;
+                }
+                if (i > n || i == value_begin)
+                    return;
+                if (fn(key, text.substr(value_begin, i - value_begin)))
+                    return;
+                ws();
+                if (i >= n || text[i] != ',')
+                    return;
+                ++i;
+            }
+        }
+
+        /// raw text of member `key` of the JSON object `text`, if present
+        inline std::optional<std::string_view> member(std::string_view text, std::string_view key) {
+            std::optional<std::string_view> found;
+            forEachMember(text, [&](std::string_view k, std::string_view value) {
+                if (k != key)
+                    return false;
+                found = value;
+                return true;
+            });
+            return found;
+        }
+    } // namespace op
+
+    /// A GeoJSON FeatureCollection indexed rather than read: opening parses the header and delimits every feature
+    /// in one scan, recording where its text lies, and nothing else. A feature's geometry is parsed and converted
+    /// only when `features(i)` asks for it, so listing many files or picking a few features out of a huge one
+    /// costs a pass over the bytes instead of a full read.
+    ///
+    /// Regular files are memory-mapped and the index points into the mapping.
+    class LazyCollection {
+      public:
+        /// scans `file`; files that cannot be mapped are read into memory first
+        static LazyCollection open(const std::filesystem::path &file) {
+            LazyCollection lc;
+            lc.map_ = op::MappedFile{file};
+            if (lc.map_) {
+                lc.scan(lc.map_.view());
+                return lc;
+            }
+            std::ifstream ifs(file, std::ios::binary);
+            if (!ifs)
+                throw std::runtime_error("geoson::LazyCollection::open(): cannot open \"" + file.string() + '\"');
+            lc.owned_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+            lc.scan(std::string_view(lc.owned_.data(), lc.owned_.size()));
+            return lc;
+        }
+
+        /// indexes a document already in memory, which must outlive the LazyCollection
+        static LazyCollection fromBuffer(std::string_view data) {
+            LazyCollection lc;
+            lc.scan(data);
+            return lc;
+        }
+
+        LazyCollection(LazyCollection &&) noexcept = default;
+        LazyCollection &operator=(LazyCollection &&) noexcept = default;
+
+        const CollectionHeader &header() const { return header_; }
+
+        /// number of GeoJSON features in the document (Multi* geometries split into several Features on decode)
+        std::size_t size() const { return texts_.size(); }
+        bool empty() const { return texts_.empty(); }
+
+        /// feature `i`'s raw JSON text
+        std::string_view text(std::size_t i) const { return texts_.at(i); }
+
+        /// byte offset of feature `i` in the document, for features that were read in place
+        std::optional<std::size_t> offset(std::size_t i) const {
+            const std::string_view t = texts_.at(i);
+            if (t.data() < source_.data() || t.data() >= source_.data() + source_.size())
+                return std::nullopt;
+            return static_cast<std::size_t>(t.data() - source_.data());
+        }
+
+        /// Feature `i`'s GeoJSON geometry type ("Point", "MultiPolygon", ...), read without parsing its
+        /// coordinates; empty for a null or missing geometry.
+        std::string geometryType(std::size_t i) const {
+            auto geometry = op::member(text(i), "geometry");
+            if (!geometry)
+                return {};
+            auto type = op::member(*geometry, "type");
+            if (!type || type->empty() || type->front() != '"')
+                return {};
+            if (type->find('\\') == std::string_view::npos && type->size() >= 2)
+                return std::string(type->substr(1, type->size() - 2));
+            return nlohmann::json::parse(*type).get<std::string>();
+        }
+
+        /// one property of feature `i`, parsed on its own
+        std::optional<PropertyValue> property(std::size_t i, std::string_view key) const {
+            auto props = op::member(text(i), "properties");
+            if (!props)
+                return std::nullopt;
+            auto value = op::member(*props, key);
+            if (!value)
+                return std::nullopt;
+            return parsePropertyValue(nlohmann::json::parse(*value));
+        }
+
+        /// feature `i`'s property bag, without touching its geometry
+        Properties properties(std::size_t i) const {
+            auto props = op::member(text(i), "properties");
+            if (!props)
+                return {};
+            auto j = nlohmann::json::parse(*props);
+            return j.is_object() ? parseProperties(j) : Properties{};
+        }
+
+        /// Parses and converts feature `i`: one Feature per (sub-)geometry, none for a null geometry, exactly as
+        /// `ReadFeatureCollection` would produce for it.
+        std::vector<Feature> features(std::size_t i) const {
+            std::vector<Feature> out;
+            parseFeatureText(text(i), *tf_, header_.crs, out);
+            return out;
+        }
+
+        /// every feature, decoded; the same collection `ReadFeatureCollection` returns
+        FeatureCollection toFeatureCollection() const {
+            FeatureCollection fc;
+            fc.datum = header_.datum;
+            fc.heading = header_.heading;
+            fc.global_properties = header_.global_properties;
+            fc.features.reserve(size());
+            for (std::size_t i = 0; i < size(); ++i)
+                parseFeatureText(texts_[i], *tf_, header_.crs, fc.features);
+            return fc;
+        }
+
+      private:
+        op::MappedFile map_;
+        std::vector<char> owned_; // a vector, so moving the collection keeps the views valid
+        std::string_view source_;
+        CollectionHeader header_;
+        std::shared_ptr<const DatumTransform> tf_;
+        std::vector<std::string_view> texts_;
+        std::deque<std::string> detached_; // features the scanner had to parse (no in-place text)
+
+        LazyCollection() = default;
+
+        void scan(std::string_view data) {
+            source_ = data;
+            op::FeatureScanner scanner(data);
+            header_ = parseHeader(scanner.properties());
+            tf_ = DatumTransform::shared(header_.datum);
+
+            nlohmann::json value;
+            std::string_view raw;
+            while (scanner.nextRaw(value, raw)) {
+                if (raw.empty())
+                    raw = detached_.emplace_back(value.dump());
+                texts_.push_back(raw);
+            }
+            op::addStat(&Stats::bytes_read, scanner.scanned());
+        }
+    };
+
+    /// Just the collection header of `file` (datum, heading, CRS, global properties): no feature is parsed.
+    inline CollectionHeader ReadCollectionHeader(const std::filesystem::path &file) {
+        return FeatureReader(file).header();
+    }
+
+} // namespace geoson
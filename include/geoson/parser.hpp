@@ -1,29 +1,113 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <variant>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GEOSON_HAS_MMAP 1
+#endif
+
 #include "concord/concord.hpp" // for concord::CRS, Datum, Euler
 
+#include "geoson/stats.hpp"
+#include "geoson/transform.hpp"
 #include "geoson/types.hpp"
 
+#if GEOSON_USE_SIMDJSON
+#include "geoson/simd_parser.hpp"
+#endif
+
 namespace geoson {
 
     namespace op {
-        inline nlohmann::json ReadFeatureCollection(const std::filesystem::path &file) {
-            std::ifstream ifs(file);
-            if (!ifs) {
-                throw std::runtime_error("geoson::ReadFeatureCollection(): cannot open \"" + file.string() + '\"');
+        /// Read-only memory mapping of a whole file. Evaluates to false when the file cannot be mapped (missing,
+        /// empty, not a regular file, or no mmap on this platform); callers then fall back to stream input.
+        class MappedFile {
+          public:
+            MappedFile() = default;
+
+            explicit MappedFile(const std::filesystem::path &file) {
+#ifdef GEOSON_HAS_MMAP
+                int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                    return;
+                struct stat st;
+                if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                    void *p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (p != MAP_FAILED) {
+                        data_ = static_cast<const char *>(p);
+                        size_ = static_cast<std::size_t>(st.st_size);
+                        ::madvise(p, size_, MADV_SEQUENTIAL);
+                    }
+                }
+                ::close(fd);
+#else
+                (void)file;
+#endif
             }
 
+            MappedFile(MappedFile &&other) noexcept : data_(other.data_), size_(other.size_) {
+                other.data_ = nullptr;
+                other.size_ = 0;
+            }
+            MappedFile &operator=(MappedFile &&other) noexcept {
+                std::swap(data_, other.data_);
+                std::swap(size_, other.size_);
+                return *this;
+            }
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            ~MappedFile() {
+#ifdef GEOSON_HAS_MMAP
+                if (data_)
+                    ::munmap(const_cast<char *>(data_), size_);
+#endif
+            }
+
+            explicit operator bool() const { return data_ != nullptr; }
+            std::string_view view() const { return {data_, size_}; }
+
+          private:
+            const char *data_ = nullptr;
+            std::size_t size_ = 0;
+        };
+
+        inline nlohmann::json ReadFeatureCollection(const std::filesystem::path &file) {
             nlohmann::json j;
-            ifs >> j;
+            if (MappedFile map{file}) {
+                j = nlohmann::json::parse(map.view().begin(), map.view().end());
+            } else {
+                std::ifstream ifs(file, std::ios::binary);
+                if (!ifs) {
+                    throw std::runtime_error("geoson::ReadFeatureCollection(): cannot open \"" + file.string() +
+                                             '\"');
+                }
+                ifs >> j;
+            }
 
             if (!j.is_object() || !j.contains("type") || !j["type"].is_string()) {
                 throw std::runtime_error(
@@ -42,88 +126,500 @@ namespace geoson {
             nlohmann::json feat = {{"type", "Feature"}, {"geometry", j}, {"properties", nlohmann::json::object()}};
             return nlohmann::json{{"type", "FeatureCollection"}, {"features", nlohmann::json::array({feat})}};
         }
+
+        /// Incremental reader over the top level of a GeoJSON document.
+        ///
+        /// Only one element of "features" is held as a `nlohmann::json` value at a time, so memory stays bounded by
+        /// the largest single feature instead of the whole file. When "features" comes before "properties" (as in
+        /// files written by `WriteFeatureCollection`, whose keys are sorted) the array is skipped over once to reach
+        /// the header and then re-read from its recorded offset; unseekable streams buffer the features instead.
+        class FeatureScanner {
+          public:
+            explicit FeatureScanner(std::istream &is) : is_(&is), origin_(is.tellg()), chunk_(1 << 16) {}
+
+            /// Scans a document already in memory, e.g. a mapped file. Values are delimited in place and never
+            /// copied; `data` must outlive the scanner.
+            explicit FeatureScanner(std::string_view data)
+                : is_(nullptr), origin_(0), begin_(data.data()), cur_(data.data()), end_(data.data() + data.size()) {}
+
+            /// Collection-level `properties` object, or null when the document has none. Reads ahead as far as
+            /// needed and validates the top-level `type` on the way.
+            const nlohmann::json &properties() {
+                readHeader();
+                return properties_;
+            }
+
+            /// Parses the next element of "features" into `feature`; returns false once the array is exhausted.
+            bool next(nlohmann::json &feature) {
+                switch (advance()) {
+                case Next::Buffered:
+                    feature = std::move(buffered_[buffered_pos_++]);
+                    return true;
+                case Next::Raw:
+                    feature = nlohmann::json::parse(capture());
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            /// Like `next`, but hands out the element's raw JSON text unparsed, so parsing can happen elsewhere.
+            bool nextText(std::string &text) {
+                switch (advance()) {
+                case Next::Buffered:
+                    text = buffered_[buffered_pos_++].dump();
+                    return true;
+                case Next::Raw:
+                    text.assign(capture());
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            /// Like `next`, but leaves raw elements unparsed: `raw` then views their text until the next call. For
+            /// elements the scanner already had to parse, `raw` is empty and the value is moved into `feature`.
+            bool nextRaw(nlohmann::json &feature, std::string_view &raw) {
+                switch (advance()) {
+                case Next::Buffered:
+                    feature = std::move(buffered_[buffered_pos_++]);
+                    raw = {};
+                    return true;
+                case Next::Raw:
+                    raw = capture();
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            /// Bytes consumed from the start of the document so far.
+            std::size_t offset() const { return consumed_ + static_cast<std::size_t>(cur_ - begin_); }
+
+            /// Furthest `offset` reached, which differs from it while the features are re-read after the header.
+            std::size_t scanned() const { return std::max(furthest_, offset()); }
+
+          private:
+            enum class State { Start, Members, Features, Done };
+            enum class Next { Done, Buffered, Raw };
+
+            std::istream *is_;
+            std::streampos origin_;
+            std::vector<char> chunk_;
+            const char *begin_ = nullptr;
+            const char *cur_ = nullptr;
+            const char *end_ = nullptr;
+            std::size_t consumed_ = 0;
+            std::size_t furthest_ = 0;
+            std::string scratch_;
+
+            State state_ = State::Start;
+            bool first_element_ = true;
+            bool resume_members_ = true;
+            bool has_type_ = false;
+            bool has_properties_ = false;
+            std::optional<std::size_t> pending_features_;
+            nlohmann::json type_;
+            nlohmann::json properties_;
+            std::vector<nlohmann::json> buffered_;
+            std::size_t buffered_pos_ = 0;
+
+            static constexpr int eof = std::char_traits<char>::eof();
+
+            bool refill() {
+                if (!is_)
+                    return false; // in-memory input has no more than it started with
+                consumed_ += static_cast<std::size_t>(end_ - begin_);
+                auto n = is_->rdbuf()->sgetn(chunk_.data(), static_cast<std::streamsize>(chunk_.size()));
+                begin_ = cur_ = chunk_.data();
+                end_ = begin_ + (n > 0 ? n : 0);
+                return cur_ != end_;
+            }
+
+            int peek() {
+                if (cur_ == end_ && !refill())
+                    return eof;
+                return static_cast<unsigned char>(*cur_);
+            }
+
+            int get() {
+                int c = peek();
+                if (c != eof)
+                    ++cur_;
+                return c;
+            }
+
+            void skipWs() {
+                for (int c = peek(); c == ' ' || c == '\t' || c == '\n' || c == '\r'; c = peek())
+                    ++cur_;
+            }
+
+            [[noreturn]] void fail(int c, const char *context, const char *expected) const {
+                std::string got = c == eof ? std::string("end of input") : "'" + std::string(1, char(c)) + "'";
+                throw nlohmann::json::parse_error::create(101, offset(),
+                                                          "syntax error while parsing " + std::string(context) +
+                                                              " - unexpected " + got + "; expected " + expected,
+                                                          nullptr);
+            }
+
+            /// Walks exactly one JSON value, copying its raw text into `scratch_` when `Keep` is set. The value is
+            /// only delimited here; `nlohmann::json::parse` does the validation afterwards.
+            template <bool Keep> void walk() {
+                const char *mark = cur_;
+                auto flush = [&] {
+                    if constexpr (Keep)
+                        scratch_.append(mark, cur_);
+                };
+                auto peek_char = [&]() -> int {
+                    if (cur_ == end_) {
+                        flush();
+                        refill();
+                        mark = cur_;
+                        if (cur_ == end_)
+                            return eof;
+                    }
+                    return static_cast<unsigned char>(*cur_);
+                };
+                auto next_char = [&]() -> int {
+                    int ch = peek_char();
+                    if (ch != eof)
+                        ++cur_;
+                    return ch;
+                };
+
+                int c = peek_char();
+                if (c == '{' || c == '[' || c == '"') {
+                    int depth = 0;
+                    bool in_string = false;
+                    do {
+                        c = next_char();
+                        if (c == eof)
+                            break;
+                        if (in_string) {
+                            if (c == '\\')
+                                next_char();
+                            else if (c == '"')
+                                in_string = false;
+                        } else if (c == '"') {
+                            in_string = true;
+                        } else if (c == '{' || c == '[') {
+                            ++depth;
+                        } else if (c == '}' || c == ']') {
+                            --depth;
+                        }
+                    } while (in_string || depth > 0);
+                } else if (c == eof || c == ',' || c == ':' || c == ']' || c == '}') {
+                    fail(c, "value", "value");
+                } else {
+                    while ((c = peek_char()) != eof && c != ',' && c != ']' && c != '}' && c != ' ' && c != '\t' &&
+                           c != '\n' && c != '\r')
+                        ++cur_;
+                }
+                flush();
+            }
+
+            /// Moves to the next element of "features": a buffered value, or raw text starting at the cursor.
+            Next advance() {
+                readHeader();
+                while (true) {
+                    if (buffered_pos_ < buffered_.size())
+                        return Next::Buffered;
+                    if (state_ != State::Features)
+                        return Next::Done;
+                    skipWs();
+                    if (first_element_) {
+                        first_element_ = false;
+                        if (peek() == ']') {
+                            get();
+                            endFeatures();
+                            continue;
+                        }
+                    } else {
+                        int c = get();
+                        if (c == ']') {
+                            endFeatures();
+                            continue;
+                        }
+                        if (c != ',')
+                            fail(c, "array", "',' or ']'");
+                        skipWs();
+                    }
+                    return Next::Raw;
+                }
+            }
+
+            std::string_view capture() {
+                if (!is_) {
+                    const char *start = cur_;
+                    walk<false>();
+                    return {start, static_cast<std::size_t>(cur_ - start)};
+                }
+                scratch_.clear();
+                walk<true>();
+                return scratch_;
+            }
+
+            std::string readKey() {
+                if (peek() != '"')
+                    fail(peek(), "object key", "string literal");
+                auto raw = capture();
+                if (raw.find('\\') == std::string_view::npos && raw.size() >= 2 && raw.back() == '"')
+                    return std::string(raw.substr(1, raw.size() - 2));
+                return nlohmann::json::parse(raw).get<std::string>();
+            }
+
+            void readHeader() {
+                if (state_ == State::Start) {
+                    skipWs();
+                    if (peek() != '{') {
+                        // not an object: surface malformed input as a parse error, anything else has no 'type'
+                        auto root = nlohmann::json::parse(capture());
+                        throw std::runtime_error(
+                            "geoson::ReadFeatureCollection(): top-level object has no string 'type' field");
+                    }
+                    get();
+                    skipWs();
+                    if (peek() == '}') {
+                        get();
+                        state_ = State::Done;
+                    } else {
+                        state_ = State::Members;
+                    }
+                }
+                if (state_ == State::Members)
+                    readMembers();
+            }
+
+            void readMembers() {
+                while (state_ == State::Members) {
+                    skipWs();
+                    auto key = readKey();
+                    skipWs();
+                    if (int c = get(); c != ':')
+                        fail(c, "object separator", "':'");
+                    skipWs();
+
+                    if (key == "features") {
+                        if (has_type_ && has_properties_) {
+                            validateType();
+                            enterFeatures();
+                            return;
+                        }
+                        pendFeatures();
+                    } else if (key == "type") {
+                        type_ = nlohmann::json::parse(capture());
+                        has_type_ = true;
+                    } else if (key == "properties") {
+                        properties_ = nlohmann::json::parse(capture());
+                        has_properties_ = true;
+                    } else {
+                        auto ignored = nlohmann::json::parse(capture());
+                    }
+                    endMember();
+                }
+                if (state_ != State::Done)
+                    return;
+
+                validateType();
+                if (pending_features_) {
+                    furthest_ = offset();
+                    if (is_) {
+                        is_->clear();
+                        is_->seekg(origin_ + static_cast<std::streamoff>(*pending_features_));
+                        begin_ = cur_ = end_ = nullptr;
+                        consumed_ = *pending_features_;
+                    } else {
+                        cur_ = begin_ + *pending_features_;
+                    }
+                    resume_members_ = false;
+                    pending_features_.reset();
+                    enterFeatures();
+                }
+            }
+
+            void endMember() {
+                skipWs();
+                int c = get();
+                if (c == '}')
+                    state_ = State::Done;
+                else if (c != ',')
+                    fail(c, "object", "',' or '}'");
+            }
+
+            /// "features" arrived before the header: remember where it starts and skip it, or buffer it when the
+            /// stream cannot seek back.
+            void pendFeatures() {
+                if (origin_ != std::streampos(-1)) {
+                    pending_features_ = offset();
+                    walk<false>();
+                } else {
+                    auto features = nlohmann::json::parse(capture());
+                    bufferFeatures(std::move(features));
+                }
+            }
+
+            void enterFeatures() {
+                skipWs();
+                if (peek() == '[') {
+                    get();
+                    first_element_ = true;
+                    state_ = State::Features;
+                } else {
+                    bufferFeatures(nlohmann::json::parse(capture()));
+                    state_ = resume_members_ ? State::Members : State::Done;
+                    if (resume_members_)
+                        endMember();
+                    if (state_ == State::Members)
+                        readMembers();
+                }
+            }
+
+            void endFeatures() {
+                if (!resume_members_) {
+                    state_ = State::Done;
+                    return;
+                }
+                state_ = State::Members;
+                endMember();
+                if (state_ == State::Members)
+                    readMembers();
+            }
+
+            void bufferFeatures(nlohmann::json features) {
+                if (features.is_array() || features.is_object()) {
+                    for (auto &f : features)
+                        buffered_.push_back(std::move(f));
+                } else if (!features.is_null()) {
+                    buffered_.push_back(std::move(features));
+                }
+            }
+
+            void validateType() {
+                if (!has_type_ || !type_.is_string())
+                    throw std::runtime_error(
+                        "geoson::ReadFeatureCollection(): top-level object has no string 'type' field");
+                // a bare Feature or geometry has no collection header to read
+                if (type_.get<std::string>() != "FeatureCollection" || !has_properties_)
+                    properties_ = nullptr;
+            }
+        };
     } // namespace op
 
     using json = nlohmann::json;
 
-    inline std::unordered_map<std::string, std::string> parseProperties(const json &props) {
-        std::unordered_map<std::string, std::string> m;
-        m.reserve(props.size());
-        for (auto const &item : props.items()) {
-            if (item.value().is_string())
-                m[item.key()] = item.value().get<std::string>();
-            else
-                m[item.key()] = item.value().dump();
+    /// one JSON property value; anything other than a string, number or bool is kept as its compact JSON text
+    inline PropertyValue parsePropertyValue(const json &value) {
+        switch (value.type()) {
+        case json::value_t::string:
+            return value.get_ref<const std::string &>();
+        case json::value_t::boolean:
+            return value.get<bool>();
+        case json::value_t::number_integer:
+            return value.get<std::int64_t>();
+        case json::value_t::number_unsigned:
+            if (value.get<std::uint64_t>() <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+                return value.get<std::int64_t>();
+            return PropertyValue::fromJson(value.dump());
+        case json::value_t::number_float:
+            return value.get<double>();
+        default:
+            return PropertyValue::fromJson(value.dump());
         }
+    }
+
+    inline Properties parseProperties(const json &props) {
+        Properties m;
+        m.reserve(props.size());
+        for (auto const &item : props.items())
+            m.insert_or_assign(item.key(), parsePropertyValue(item.value()));
         return m;
     }
 
-    inline concord::Point parsePoint(const json &coords, const concord::Datum &datum, geoson::CRS crs) {
+    /// raw x/y/z (lon/lat/alt for WGS input) of one GeoJSON position
+    inline concord::Point parsePosition(const json &coords) {
         double x = coords.at(0).get<double>();
         double y = coords.at(1).get<double>();
         double z = coords.size() > 2 ? coords.at(2).get<double>() : 0.0;
-
-        // Internal representation is always in Point coordinates (ENU/local system)
-        if (crs == geoson::CRS::ENU) {
-            // ENU flavor: coordinates are already local x,y,z
-            return concord::Point{x, y, z};
-        } else {
-            // WGS flavor: coordinates are lon,lat,alt - convert to ENU using datum
-            // Note: WGS constructor is (lat, lon, alt), so swap x,y
-            concord::WGS wgs{y, x, z};
-            concord::ENU enu = wgs.toENU(datum);
-            return concord::Point{enu.x, enu.y, enu.z};
-        }
+        return concord::Point{x, y, z};
     }
 
-    inline Geometry parseLineString(const json &coords, const concord::Datum &datum, geoson::CRS crs) {
+    /// all positions of a coordinate array, converted to the local frame in one batch
+    inline std::vector<concord::Point> parsePositions(const json &coords, const DatumTransform &tf, geoson::CRS crs) {
         std::vector<concord::Point> pts;
         pts.reserve(coords.size());
         for (auto const &c : coords)
-            pts.push_back(parsePoint(c, datum, crs));
+            pts.push_back(parsePosition(c));
+        op::addStat(&Stats::coordinates, pts.size());
+        // Internal representation is always in Point coordinates (ENU/local system)
+        if (crs == geoson::CRS::WGS)
+            tf.toENU(pts.data(), pts.size());
+        return pts;
+    }
+
+    inline concord::Point parsePoint(const json &coords, const DatumTransform &tf, geoson::CRS crs) {
+        concord::Point p = parsePosition(coords);
+        op::addStat(&Stats::coordinates, 1);
+        if (crs == geoson::CRS::WGS)
+            tf.toENU(&p, 1);
+        return p;
+    }
+
+    inline concord::Point parsePoint(const json &coords, const concord::Datum &datum, geoson::CRS crs) {
+        return parsePoint(coords, *DatumTransform::shared(datum), crs);
+    }
+
+    inline Geometry parseLineString(const json &coords, const DatumTransform &tf, geoson::CRS crs) {
+        auto pts = parsePositions(coords, tf, crs);
         if (pts.size() == 2)
             return concord::Line{pts[0], pts[1]};
         else
             return concord::Path{pts};
     }
 
+    inline Geometry parseLineString(const json &coords, const concord::Datum &datum, geoson::CRS crs) {
+        return parseLineString(coords, *DatumTransform::shared(datum), crs);
+    }
+
+    inline concord::Polygon parsePolygon(const json &coords, const DatumTransform &tf, geoson::CRS crs) {
+        return concord::Polygon{parsePositions(coords.at(0), tf, crs)};
+    }
+
     inline concord::Polygon parsePolygon(const json &coords, const concord::Datum &datum, geoson::CRS crs) {
-        std::vector<concord::Point> pts;
-        auto const &ring = coords.at(0);
-        pts.reserve(ring.size());
-        for (auto const &c : ring)
-            pts.push_back(parsePoint(c, datum, crs));
-        return concord::Polygon{pts};
+        return parsePolygon(coords, *DatumTransform::shared(datum), crs);
     }
 
-    inline std::vector<Geometry> parseGeometry(const json &geom, const concord::Datum &datum, geoson::CRS crs) {
+    inline std::vector<Geometry> parseGeometry(const json &geom, const DatumTransform &tf, geoson::CRS crs) {
         std::vector<Geometry> out;
         auto type = geom.at("type").get<std::string>();
 
         if (type == "Point") {
-            out.emplace_back(parsePoint(geom.at("coordinates"), datum, crs));
+            out.emplace_back(parsePoint(geom.at("coordinates"), tf, crs));
         } else if (type == "LineString") {
-            out.emplace_back(parseLineString(geom.at("coordinates"), datum, crs));
+            out.emplace_back(parseLineString(geom.at("coordinates"), tf, crs));
         } else if (type == "Polygon") {
-            out.emplace_back(parsePolygon(geom.at("coordinates"), datum, crs));
+            out.emplace_back(parsePolygon(geom.at("coordinates"), tf, crs));
         } else if (type == "MultiPoint") {
-            for (auto const &c : geom.at("coordinates"))
-                out.emplace_back(parsePoint(c, datum, crs));
+            for (auto const &p : parsePositions(geom.at("coordinates"), tf, crs))
+                out.emplace_back(p);
         } else if (type == "MultiLineString") {
             for (auto const &linegeoson : geom.at("coordinates"))
-                out.emplace_back(parseLineString(linegeoson, datum, crs));
+                out.emplace_back(parseLineString(linegeoson, tf, crs));
         } else if (type == "MultiPolygon") {
             for (auto const &poly : geom.at("coordinates"))
-                out.emplace_back(parsePolygon(poly, datum, crs));
+                out.emplace_back(parsePolygon(poly, tf, crs));
         } else if (type == "GeometryCollection") {
             for (auto const &sub : geom.at("geometries")) {
-                auto subs = parseGeometry(sub, datum, crs);
+                auto subs = parseGeometry(sub, tf, crs);
                 out.insert(out.end(), subs.begin(), subs.end());
             }
         }
         return out;
     }
 
+    inline std::vector<Geometry> parseGeometry(const json &geom, const concord::Datum &datum, geoson::CRS crs) {
+        return parseGeometry(geom, *DatumTransform::shared(datum), crs);
+    }
+
     // ––– parse the CRS string into the enum –––
 
     inline geoson::CRS parseCRS(const std::string &s) {
@@ -134,14 +630,11 @@ namespace geoson {
         throw std::runtime_error("Unknown CRS string: " + s);
     }
 
-    // ––– main loader –––
-
-    inline FeatureCollection ReadFeatureCollection(const std::filesystem::path &file) {
-        auto fc_json = op::ReadFeatureCollection(file);
+    // ––– collection header –––
 
-        if (!fc_json.contains("properties") || !fc_json["properties"].is_object())
+    inline CollectionHeader parseHeader(const json &P) {
+        if (!P.is_object())
             throw std::runtime_error("missing top-level 'properties'");
-        auto &P = fc_json["properties"];
 
         if (!P.contains("crs") || !P["crs"].is_string())
             throw std::runtime_error("'properties' missing string 'crs'");
@@ -150,39 +643,194 @@ namespace geoson {
         if (!P.contains("heading") || !P["heading"].is_number())
             throw std::runtime_error("'properties' missing numeric 'heading'");
 
-        // extract the new types
-        auto crsVal = parseCRS(P["crs"].get<std::string>());
+        CollectionHeader h;
+        h.crs = parseCRS(P["crs"].get<std::string>());
         auto &A = P["datum"];
-        concord::Datum d{A[0].get<double>(), A[1].get<double>(), A[2].get<double>()};
-        double yaw = P["heading"].get<double>();
-        concord::Euler euler{0.0, 0.0, yaw};
-
-        FeatureCollection fc;
-        fc.datum = d;
-        fc.heading = euler;
-        fc.features.reserve(fc_json["features"].size());
-        
+        h.datum = concord::Datum{A[0].get<double>(), A[1].get<double>(), A[2].get<double>()};
+        h.heading = concord::Euler{0.0, 0.0, P["heading"].get<double>()};
+
         // Parse global properties (excluding built-in ones)
-        for (const auto& [key, value] : P.items()) {
+        for (const auto &[key, value] : P.items()) {
             if (key != "crs" && key != "datum" && key != "heading") {
                 if (value.is_string()) {
-                    fc.global_properties[key] = value.get<std::string>();
+                    h.global_properties[key] = value.get<std::string>();
                 } else {
-                    fc.global_properties[key] = value.dump();
+                    h.global_properties[key] = value.dump();
                 }
             }
         }
+        return h;
+    }
+
+    /// parse one GeoJSON feature, appending one Feature per (sub-)geometry; null geometries are skipped
+    inline void parseFeature(const json &feat, const DatumTransform &tf, geoson::CRS crs, std::vector<Feature> &out) {
+        if (feat.value("geometry", json{}).is_null())
+            return;
+        auto geoms = op::timed(&Stats::geometry_ns, [&] { return parseGeometry(feat["geometry"], tf, crs); });
+        // one shared property bag for all sub-geometries
+        Properties props = op::timed(&Stats::properties_ns,
+                                     [&] { return parseProperties(feat.value("properties", json::object())); });
+        for (auto &g : geoms)
+            out.emplace_back(Feature{std::move(g), props});
+    }
+
+    inline void parseFeature(const json &feat, const concord::Datum &datum, geoson::CRS crs,
+                             std::vector<Feature> &out) {
+        parseFeature(feat, *DatumTransform::shared(datum), crs, out);
+    }
+
+    /// parse one feature from its raw JSON text; with `GEOSON_USE_SIMDJSON` the simdjson fast path goes first
+    inline void parseFeatureText(std::string_view text, const DatumTransform &tf, geoson::CRS crs,
+                                 std::vector<Feature> &out) {
+#if GEOSON_USE_SIMDJSON
+        if (op::simd::parseFeature(text, tf, crs, out))
+            return;
+#endif
+        parseFeature(op::timed(&Stats::dom_ns, [&] { return json::parse(text); }), tf, crs, out);
+    }
 
-        for (auto const &feat : fc_json["features"]) {
-            if (feat.value("geometry", json{}).is_null())
-                continue;
-            auto geoms = parseGeometry(feat["geometry"], d, crsVal);
-            auto props_map = parseProperties(feat.value("properties", json::object()));
-            for (auto &g : geoms)
-                fc.features.emplace_back(Feature{std::move(g), props_map});
+    // ––– main loader –––
+
+    /// Reader knobs; the defaults read sequentially on the calling thread.
+    struct ReadOptions {
+        /// worker threads for feature parsing; 1 parses on the calling thread, 0 uses every hardware thread
+        unsigned threads = 1;
+        /// Build property storage in bump arenas, one per parse chunk, instead of one heap block per feature:
+        /// loading makes fewer allocations and tearing the collection down frees a few large blocks. An arena
+        /// lives as long as any property store built in it, so features may outlive their collection; a store
+        /// moves to the heap when first modified. Geometry and string values stay on the heap either way.
+        bool arena = false;
+    };
+
+    namespace op {
+        /// a fresh arena when `enabled`, else null (the heap)
+        inline std::shared_ptr<Arena> makeArena(bool enabled) {
+            return enabled ? std::make_shared<Arena>(std::size_t(1) << 16) : nullptr;
         }
+    } // namespace op
 
-        return fc;
+    namespace op {
+        /// Parses the scanner's next feature into `out`; `scratch` holds it when it has to go through a json value.
+        /// Returns false once the features are exhausted.
+        inline bool parseNextFeature(FeatureScanner &scanner, json &scratch, const DatumTransform &tf,
+                                     geoson::CRS crs, std::vector<Feature> &out) {
+            std::string_view raw;
+            if (!timed(&Stats::dom_ns, [&] { return scanner.nextRaw(scratch, raw); }))
+                return false;
+            if (raw.empty())
+                parseFeature(scratch, tf, crs, out);
+            else
+                parseFeatureText(raw, tf, crs, out);
+            return true;
+        }
+
+        /// Parses features on up to `threads` workers while the calling thread keeps splitting the document into
+        /// chunks of raw feature text. Chunks are collected strictly in file order, so the result and the first
+        /// error raised are the same as for a sequential read.
+        inline void parseFeaturesParallel(FeatureScanner &scanner, const DatumTransform &tf, geoson::CRS crs,
+                                          unsigned threads, bool arena, std::vector<Feature> &out) {
+            constexpr std::size_t chunk_bytes = 1 << 18;
+            constexpr std::size_t chunk_features = 4096;
+
+            // the workers and this thread each collect apart and add up into the caller's sink under a lock
+            auto parseChunk = [&tf, crs, arena, stats = activeStats()](std::vector<std::string> texts) {
+                ArenaScope scope(makeArena(arena));
+                KeyScope keys;
+                WorkerStats worker(stats);
+                std::vector<Feature> features;
+                features.reserve(texts.size());
+                for (auto const &text : texts)
+                    parseFeatureText(text, tf, crs, features);
+                return features;
+            };
+
+            std::deque<std::future<std::vector<Feature>>> inflight;
+            auto collect = [&] {
+                auto next = std::move(inflight.front());
+                inflight.pop_front();
+                auto features = next.get();
+                out.insert(out.end(), std::make_move_iterator(features.begin()),
+                           std::make_move_iterator(features.end()));
+            };
+
+            WorkerStats scanning(activeStats());
+            std::string text;
+            std::exception_ptr scan_error;
+            while (!scan_error) {
+                std::vector<std::string> chunk;
+                std::size_t bytes = 0;
+                try {
+                    while (bytes < chunk_bytes && chunk.size() < chunk_features &&
+                           timed(&Stats::dom_ns, [&] { return scanner.nextText(text); })) {
+                        bytes += text.size();
+                        chunk.push_back(std::move(text));
+                    }
+                } catch (...) {
+                    // raised only after the features before it, exactly as in a sequential read
+                    scan_error = std::current_exception();
+                }
+                if (chunk.empty())
+                    break;
+                if (inflight.size() >= threads)
+                    collect();
+                inflight.push_back(std::async(std::launch::async, parseChunk, std::move(chunk)));
+            }
+            while (!inflight.empty())
+                collect();
+            if (scan_error)
+                std::rethrow_exception(scan_error);
+        }
+
+        /// header, then every feature, sequentially or in parallel as `opts` asks
+        inline FeatureCollection readFeatures(FeatureScanner &scanner, const ReadOptions &opts) {
+            StatTimer timer(&Stats::read_ns);
+            auto header = parseHeader(scanner.properties());
+
+            FeatureCollection fc;
+            fc.datum = header.datum;
+            fc.heading = header.heading;
+            fc.global_properties = std::move(header.global_properties);
+
+            const auto tf = DatumTransform::shared(fc.datum);
+            const unsigned threads = opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+            if (threads > 1) {
+                parseFeaturesParallel(scanner, *tf, header.crs, threads, opts.arena, fc.features);
+            } else {
+                ArenaScope scope(makeArena(opts.arena));
+                KeyScope keys;
+                json scratch;
+                while (parseNextFeature(scanner, scratch, *tf, header.crs, fc.features)) {
+                }
+            }
+
+            addStat(&Stats::features, fc.features.size());
+            addStat(&Stats::bytes_read, scanner.scanned());
+            return fc;
+        }
+    } // namespace op
+
+    /// Reads a FeatureCollection one feature at a time; the document is never held as a single json tree.
+    inline FeatureCollection ReadFeatureCollection(std::istream &is, const ReadOptions &opts = {}) {
+        op::FeatureScanner scanner(is);
+        return op::readFeatures(scanner, opts);
+    }
+
+    /// Reads a FeatureCollection from a document already in memory, such as a message payload. `data` only has to
+    /// stay alive for the duration of the call.
+    inline FeatureCollection ReadFeatureCollectionFromBuffer(std::string_view data, const ReadOptions &opts = {}) {
+        op::FeatureScanner scanner(data);
+        return op::readFeatures(scanner, opts);
+    }
+
+    /// Reads a FeatureCollection from disk; regular files are memory-mapped rather than streamed.
+    inline FeatureCollection ReadFeatureCollection(const std::filesystem::path &file, const ReadOptions &opts = {}) {
+        if (op::MappedFile map{file})
+            return ReadFeatureCollectionFromBuffer(map.view(), opts);
+        std::ifstream ifs(file, std::ios::binary);
+        if (!ifs) {
+            throw std::runtime_error("geoson::ReadFeatureCollection(): cannot open \"" + file.string() + '\"');
+        }
+        return ReadFeatureCollection(ifs, opts);
     }
 
     // ––– pretty-print FeatureCollection header –––
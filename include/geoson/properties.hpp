@@ -0,0 +1,463 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace geoson {
+
+    namespace op {
+        class KeyScope;
+    }
+
+    /// Interned property key. Equal keys share one reference-counted string, so millions of features carrying
+    /// "name" or "id" hold a pointer each instead of a string each, and comparing two keys compares pointers. A
+    /// key's string is freed once no PropertyKey refers to it any more, so a long-running process that reads
+    /// arbitrary files only holds the keys its live data uses.
+    class PropertyKey {
+      public:
+        PropertyKey() : PropertyKey(std::string_view{}) {}
+        PropertyKey(std::string_view key);
+        PropertyKey(const std::string &key) : PropertyKey(std::string_view(key)) {}
+        PropertyKey(const char *key) : PropertyKey(std::string_view(key)) {}
+
+        PropertyKey(const PropertyKey &other) noexcept : n_(other.n_) {
+            if (n_)
+                n_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        /// leaves `other` empty: only assigning to it or destroying it is valid afterwards
+        PropertyKey(PropertyKey &&other) noexcept : n_(std::exchange(other.n_, nullptr)) {}
+        PropertyKey &operator=(PropertyKey other) noexcept {
+            std::swap(n_, other.n_);
+            return *this;
+        }
+        ~PropertyKey() { release(n_); }
+
+        const std::string &str() const { return n_->s; }
+        operator const std::string &() const { return n_->s; }
+
+        friend bool operator==(const PropertyKey &a, const PropertyKey &b) { return a.n_ == b.n_; }
+        template <typename S>
+            requires std::convertible_to<const S &, std::string_view>
+        friend bool operator==(const PropertyKey &a, const S &b) {
+            return a.n_->s == std::string_view(b);
+        }
+        friend bool operator<(const PropertyKey &a, const PropertyKey &b) { return a.n_->s < b.n_->s; }
+        friend std::ostream &operator<<(std::ostream &os, const PropertyKey &k) { return os << k.n_->s; }
+
+      private:
+        friend class op::KeyScope;
+
+        struct Node {
+            std::string s;
+            std::atomic<std::size_t> refs{1};
+        };
+        struct Table {
+            std::mutex mutex;
+            std::unordered_map<std::string_view, Node *> nodes; // views into the nodes' own strings
+        };
+
+        Node *n_;
+
+        explicit PropertyKey(Node *n) : n_(n) {}
+
+        static Table &table() {
+            static auto *t = new Table; // never destroyed: static keys may outlive static destruction
+            return *t;
+        }
+
+        /// the shared node for `key`, with a reference taken
+        static Node *acquire(std::string_view key) {
+            Table &t = table();
+            std::lock_guard<std::mutex> lock(t.mutex);
+            if (auto it = t.nodes.find(key); it != t.nodes.end()) {
+                it->second->refs.fetch_add(1, std::memory_order_relaxed);
+                return it->second;
+            }
+            auto *n = new Node{std::string(key)};
+            t.nodes.emplace(n->s, n);
+            return n;
+        }
+
+        /// drops a reference; the last one goes under the table lock, so a concurrent `acquire` never revives a
+        /// node that is being freed
+        static void release(Node *n) {
+            if (!n)
+                return;
+            std::size_t refs = n->refs.load(std::memory_order_relaxed);
+            while (refs > 1)
+                if (n->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel))
+                    return;
+            Table &t = table();
+            std::lock_guard<std::mutex> lock(t.mutex);
+            if (n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                t.nodes.erase(n->s);
+                delete n;
+            }
+        }
+    };
+
+    namespace op {
+        /// Interning front for one read, active on the creating thread for its lifetime: keys it has handed out
+        /// before are copied from a local map, which keeps the shared table's lock off the parse path. Its own
+        /// references go with it, so keys only the scope still held are freed when the read ends. Scopes nest.
+        class KeyScope {
+          public:
+            KeyScope() : previous_(std::exchange(current(), this)) {}
+            ~KeyScope() { current() = previous_; }
+            KeyScope(const KeyScope &) = delete;
+            KeyScope &operator=(const KeyScope &) = delete;
+
+            static KeyScope *&current() {
+                thread_local KeyScope *scope = nullptr;
+                return scope;
+            }
+
+            const PropertyKey &get(std::string_view key) {
+                if (auto it = keys_.find(key); it != keys_.end())
+                    return it->second;
+                PropertyKey k(PropertyKey::acquire(key));
+                std::string_view view = k.str();
+                return keys_.emplace(view, std::move(k)).first->second;
+            }
+
+          private:
+            KeyScope *previous_;
+            std::unordered_map<std::string_view, PropertyKey> keys_; // views into the keys' own strings
+        };
+    } // namespace op
+
+    inline PropertyKey::PropertyKey(std::string_view key) : n_(nullptr) {
+        if (auto *scope = op::KeyScope::current())
+            *this = scope->get(key);
+        else
+            n_ = acquire(key);
+    }
+
+    /// Typed property value: a string, an integer, a double, a bool, or any other JSON value (null, array,
+    /// object, integers beyond int64) kept as its compact JSON text.
+    class PropertyValue {
+      public:
+        enum class Kind { String, Integer, Number, Boolean, Json };
+
+        PropertyValue() = default;
+        PropertyValue(std::string s) : v_(std::move(s)) {}
+        PropertyValue(std::string_view s) : v_(std::string(s)) {}
+        PropertyValue(const char *s) : v_(std::string(s)) {}
+        template <std::integral T>
+            requires(!std::same_as<T, bool> && !std::same_as<T, char>)
+        PropertyValue(T v) : v_(static_cast<std::int64_t>(v)) {}
+        PropertyValue(double v) : v_(v) {}
+        PropertyValue(bool v) : v_(v) {}
+
+        /// a value given as compact JSON text, e.g. `nlohmann::json::dump()` output
+        static PropertyValue fromJson(std::string text) {
+            PropertyValue v;
+            v.v_ = Raw{std::move(text)};
+            return v;
+        }
+
+        Kind kind() const { return static_cast<Kind>(v_.index()); }
+
+        /// Text form, as properties were stored before they were typed: strings verbatim, anything else as compact
+        /// JSON (`42`, `1.5`, `true`, `[1,2]`).
+        std::string str() const {
+            switch (kind()) {
+            case Kind::String:
+                return std::get<std::string>(v_);
+            case Kind::Integer:
+                return std::to_string(std::get<std::int64_t>(v_));
+            case Kind::Number:
+                return nlohmann::json(std::get<double>(v_)).dump();
+            case Kind::Boolean:
+                return std::get<bool>(v_) ? "true" : "false";
+            default:
+                return std::get<Raw>(v_).text;
+            }
+        }
+        operator std::string() const { return str(); }
+
+        const std::string &asString() const {
+            if (auto s = std::get_if<std::string>(&v_))
+                return *s;
+            throw std::runtime_error("geoson::PropertyValue: not a string");
+        }
+        std::int64_t asInt() const {
+            if (auto i = std::get_if<std::int64_t>(&v_))
+                return *i;
+            throw std::runtime_error("geoson::PropertyValue: not an integer");
+        }
+        /// integers convert
+        double asDouble() const {
+            if (auto d = std::get_if<double>(&v_))
+                return *d;
+            if (auto i = std::get_if<std::int64_t>(&v_))
+                return static_cast<double>(*i);
+            throw std::runtime_error("geoson::PropertyValue: not a number");
+        }
+        bool asBool() const {
+            if (auto b = std::get_if<bool>(&v_))
+                return *b;
+            throw std::runtime_error("geoson::PropertyValue: not a boolean");
+        }
+
+        /// same kind and value
+        friend bool operator==(const PropertyValue &a, const PropertyValue &b) { return a.v_ == b.v_; }
+        /// compares the text form, so `props.at("id") == "1"` holds for a numeric 1 as it did for a string "1"
+        template <typename S>
+            requires std::convertible_to<const S &, std::string_view>
+        friend bool operator==(const PropertyValue &a, const S &b) {
+            if (auto s = std::get_if<std::string>(&a.v_))
+                return *s == std::string_view(b);
+            return a.str() == std::string_view(b);
+        }
+        friend std::ostream &operator<<(std::ostream &os, const PropertyValue &v) { return os << v.str(); }
+
+      private:
+        struct Raw {
+            std::string text;
+            bool operator==(const Raw &) const = default;
+        };
+        std::variant<std::string, std::int64_t, double, bool, Raw> v_;
+    };
+
+    namespace op {
+        /// Bump arena for the property stores one reader thread builds (see `ReadOptions::arena`). Unlocked: it
+        /// is only allocated from while installed on that thread by an `ArenaScope`.
+        using Arena = std::pmr::monotonic_buffer_resource;
+
+        /// Allocator for a store's control block. It holds the arena, so an arena lives exactly as long as the
+        /// stores built in it -- features moved or copied out of their collection stay valid -- at the cost of
+        /// one reference count per store, not per allocation.
+        template <typename T> struct ArenaRef {
+            using value_type = T;
+            std::shared_ptr<Arena> arena;
+
+            explicit ArenaRef(std::shared_ptr<Arena> a) : arena(std::move(a)) {}
+            template <typename U> ArenaRef(const ArenaRef<U> &other) : arena(other.arena) {}
+
+            T *allocate(std::size_t n) { return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T))); }
+            void deallocate(T *, std::size_t) {} // freed with the arena
+            template <typename U> bool operator==(const ArenaRef<U> &other) const { return arena == other.arena; }
+        };
+
+        /// the arena new property stores on this thread are built in, null for the heap
+        inline std::shared_ptr<Arena> &currentArena() {
+            thread_local std::shared_ptr<Arena> arena;
+            return arena;
+        }
+
+        /// Builds this thread's new property stores in `arena` (the heap when null) for the scope's lifetime.
+        class ArenaScope {
+          public:
+            explicit ArenaScope(std::shared_ptr<Arena> arena)
+                : previous_(std::exchange(currentArena(), std::move(arena))) {}
+            ~ArenaScope() { currentArena() = std::move(previous_); }
+            ArenaScope(const ArenaScope &) = delete;
+            ArenaScope &operator=(const ArenaScope &) = delete;
+
+          private:
+            std::shared_ptr<Arena> previous_;
+        };
+    } // namespace op
+
+    /// Feature property bag: interned keys with typed values, stored flat, whose copies share one immutable
+    /// instance until one of them is modified (copy-on-write). The sub-features split off a Multi* geometry all
+    /// share their parent's properties.
+    ///
+    /// Lookups and iteration are read-only and never copy. Only the modifiers (`operator[]`, `insert`, `emplace`,
+    /// `insert_or_assign`, `erase`, ...) first make this instance the sole owner of its entries. Entries keep their
+    /// insertion order; `operator==` ignores it.
+    ///
+    /// `operator[]` is the one modifier that hands out a writable reference, which could outlive the next copy.
+    /// Once it has been called the entries are never shared again: copies of this instance get their own (as the
+    /// old copy-on-write `std::string` did after leaking a reference). The other modifiers return read-only
+    /// iterators and leave sharing alone.
+    ///
+    /// New entries come from the thread's current arena while a reader has installed one. A store built there
+    /// moves to the heap the first time it is modified anywhere else, so nothing allocates from an arena once
+    /// its read is over.
+    class Properties {
+      public:
+        using key_type = PropertyKey;
+        using mapped_type = PropertyValue;
+        using value_type = std::pair<PropertyKey, PropertyValue>;
+        using size_type = std::size_t;
+        using storage_type = std::pmr::vector<value_type>;
+        using const_iterator = storage_type::const_iterator;
+        /// the untyped form properties used to have
+        using map_type = std::unordered_map<std::string, std::string>;
+
+        Properties() = default;
+        Properties(const Properties &other) : p_(other.shareable()) {}
+        Properties(Properties &&other) noexcept
+            : p_(std::move(other.p_)), leaked_(std::exchange(other.leaked_, false)) {}
+        Properties &operator=(const Properties &other) {
+            if (this != &other) {
+                p_ = other.shareable();
+                leaked_ = false;
+            }
+            return *this;
+        }
+        Properties &operator=(Properties &&other) noexcept {
+            p_ = std::move(other.p_);
+            leaked_ = std::exchange(other.leaked_, false);
+            return *this;
+        }
+        Properties(std::initializer_list<value_type> init) {
+            for (auto const &kv : init)
+                insert_or_assign(kv.first, kv.second);
+        }
+        Properties(const map_type &map) {
+            reserve(map.size());
+            for (auto const &[key, value] : map)
+                own().emplace_back(key, value);
+        }
+
+        /// text form of every value, see `PropertyValue::str`
+        map_type toMap() const {
+            map_type m;
+            m.reserve(size());
+            for (auto const &[key, value] : *this)
+                m.emplace(key.str(), value.str());
+            return m;
+        }
+        operator map_type() const { return toMap(); }
+
+        /// true when both refer to the same underlying entries
+        bool sharesWith(const Properties &other) const { return p_ && p_ == other.p_; }
+
+        size_type size() const { return p_ ? p_->size() : 0; }
+        bool empty() const { return size() == 0; }
+        const_iterator begin() const { return entries().begin(); }
+        const_iterator end() const { return entries().end(); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        const_iterator find(std::string_view key) const {
+            auto const &e = entries();
+            for (auto it = e.begin(); it != e.end(); ++it)
+                if (it->first == key)
+                    return it;
+            return e.end();
+        }
+        const_iterator find(const std::string &key) const { return find(std::string_view(key)); }
+        const_iterator find(const char *key) const { return find(std::string_view(key)); }
+        /// compares interned pointers rather than text: the lookup for keys held in a `static const PropertyKey`
+        const_iterator find(const PropertyKey &key) const {
+            auto const &e = entries();
+            for (auto it = e.begin(); it != e.end(); ++it)
+                if (it->first == key)
+                    return it;
+            return e.end();
+        }
+        size_type count(std::string_view key) const { return find(key) != end(); }
+        bool contains(std::string_view key) const { return find(key) != end(); }
+        const PropertyValue &at(std::string_view key) const {
+            auto it = find(key);
+            if (it == end())
+                throw std::out_of_range("geoson::Properties::at(): no property \"" + std::string(key) + '\"');
+            return it->second;
+        }
+
+        PropertyValue &operator[](PropertyKey key) {
+            auto &value = slot(value_type{key, PropertyValue{}}).first->second;
+            leaked_ = true;
+            return value;
+        }
+        std::pair<const_iterator, bool> insert(const value_type &kv) { return slot(kv); }
+        template <typename... Args> std::pair<const_iterator, bool> emplace(Args &&...args) {
+            return slot(value_type(std::forward<Args>(args)...));
+        }
+        std::pair<const_iterator, bool> insert_or_assign(PropertyKey key, PropertyValue value) {
+            auto r = slot(value_type{key, PropertyValue{}});
+            r.first->second = std::move(value);
+            return r;
+        }
+        size_type erase(std::string_view key) {
+            if (!contains(key))
+                return 0;
+            auto &e = own();
+            for (auto it = e.begin(); it != e.end(); ++it) {
+                if (it->first == key) {
+                    e.erase(it);
+                    break;
+                }
+            }
+            return 1;
+        }
+        void clear() {
+            p_.reset();
+            leaked_ = false;
+        }
+        void reserve(size_type n) { own().reserve(n); }
+
+        friend bool operator==(const Properties &a, const Properties &b) {
+            if (a.p_ == b.p_)
+                return true;
+            if (a.size() != b.size())
+                return false;
+            for (auto const &[key, value] : a) {
+                auto it = b.find(key);
+                if (it == b.end() || !(it->second == value))
+                    return false;
+            }
+            return true;
+        }
+
+      private:
+        std::shared_ptr<storage_type> p_;
+        bool leaked_ = false; // a reference from operator[] may still point into *p_
+
+        const storage_type &entries() const {
+            static const storage_type none;
+            return p_ ? *p_ : none;
+        }
+
+        storage_type &own() {
+            if (!p_) {
+                if (auto &arena = op::currentArena())
+                    p_ = std::allocate_shared<storage_type>(op::ArenaRef<storage_type>(arena), arena.get());
+                else
+                    p_ = std::make_shared<storage_type>();
+            } else if (p_.use_count() > 1 || !writable(*p_)) {
+                p_ = std::make_shared<storage_type>(p_->begin(), p_->end());
+            }
+            return *p_;
+        }
+
+        /// heap entries, or ones in the arena this thread is still building in
+        static bool writable(const storage_type &e) {
+            auto *resource = e.get_allocator().resource();
+            return resource == std::pmr::get_default_resource() || resource == op::currentArena().get();
+        }
+
+        /// the entries for a copy to hold: these ones, or a copy of them once a reference has leaked
+        std::shared_ptr<storage_type> shareable() const {
+            return leaked_ ? std::make_shared<storage_type>(p_->begin(), p_->end()) : p_;
+        }
+
+        std::pair<storage_type::iterator, bool> slot(const value_type &kv) {
+            auto &e = own();
+            for (auto it = e.begin(); it != e.end(); ++it)
+                if (it->first == kv.first)
+                    return {it, false};
+            e.push_back(kv);
+            return {e.end() - 1, true};
+        }
+    };
+
+} // namespace geoson
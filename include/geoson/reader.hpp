@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "geoson/parser.hpp"
+#include "geoson/types.hpp"
+
+namespace geoson {
+
+    /// Pull-style reader yielding the Features of a GeoJSON FeatureCollection one at a time, without ever
+    /// materialising a FeatureCollection. The collection header is parsed and validated on construction.
+    ///
+    /// Iteration is single-pass. Files whose header precedes "features" are read strictly front to back; files
+    /// written by `WriteFeatureCollection` (sorted keys) need one extra skim over the features to reach the header.
+    class FeatureReader {
+      public:
+        /// Regular files are memory-mapped; anything that cannot be mapped is streamed instead.
+        explicit FeatureReader(const std::filesystem::path &file) : FeatureReader(op::MappedFile{file}, file) {}
+
+        /// Reads from an existing stream, which must outlive the reader.
+        explicit FeatureReader(std::istream &is)
+            : scanner_(is), header_(parseHeader(scanner_.properties())), tf_(DatumTransform::shared(header_.datum)) {}
+
+        /// Reads a document already in memory, which must outlive the reader. (A named function rather than a
+        /// constructor, since a string literal would convert to both a path and a string_view.)
+        static FeatureReader fromBuffer(std::string_view data) { return FeatureReader(data, buffer_tag{}); }
+
+        FeatureReader(const FeatureReader &) = delete;
+        FeatureReader &operator=(const FeatureReader &) = delete;
+
+        const CollectionHeader &header() const { return header_; }
+
+        /// Moves the next Feature into `out`; returns false once the collection is exhausted. Multi* geometries
+        /// and GeometryCollections yield one Feature per sub-geometry, as in `ReadFeatureCollection`.
+        bool next(Feature &out) {
+            while (pending_pos_ == pending_.size()) {
+                pending_.clear();
+                pending_pos_ = 0;
+                if (!op::parseNextFeature(scanner_, json_, *tf_, header_.crs, pending_)) {
+                    op::addStat(&Stats::bytes_read, scanner_.scanned() - bytes_counted_);
+                    bytes_counted_ = scanner_.scanned();
+                    return false;
+                }
+            }
+            out = std::move(pending_[pending_pos_++]);
+            op::addStat(&Stats::features, 1);
+            return true;
+        }
+
+        class iterator {
+          public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Feature;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Feature *;
+            using reference = const Feature &;
+
+            iterator() = default;
+            explicit iterator(FeatureReader *reader) : reader_(reader) { ++*this; }
+
+            reference operator*() const { return current_; }
+            pointer operator->() const { return &current_; }
+
+            iterator &operator++() {
+                if (reader_ && !reader_->next(current_))
+                    reader_ = nullptr;
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const { return reader_ == nullptr; }
+
+          private:
+            FeatureReader *reader_ = nullptr;
+            Feature current_;
+        };
+
+        iterator begin() { return iterator{this}; }
+        std::default_sentinel_t end() const { return {}; }
+
+      private:
+        op::MappedFile map_;
+        std::ifstream file_;
+        op::FeatureScanner scanner_;
+        CollectionHeader header_;
+        std::shared_ptr<const DatumTransform> tf_;
+        nlohmann::json json_;
+        std::vector<Feature> pending_;
+        std::size_t pending_pos_ = 0;
+        std::size_t bytes_counted_ = 0; // input already reported to the stats sink
+
+        FeatureReader(op::MappedFile map, const std::filesystem::path &file)
+            : map_(std::move(map)), file_(map_ ? std::ifstream() : std::ifstream(file, std::ios::binary)),
+              scanner_(map_ ? op::FeatureScanner(map_.view()) : op::FeatureScanner(opened(file))),
+              header_(parseHeader(scanner_.properties())), tf_(DatumTransform::shared(header_.datum)) {}
+
+        struct buffer_tag {};
+
+        FeatureReader(std::string_view data, buffer_tag)
+            : scanner_(data), header_(parseHeader(scanner_.properties())), tf_(DatumTransform::shared(header_.datum)) {}
+
+        std::istream &opened(const std::filesystem::path &file) {
+            if (!file_)
+                throw std::runtime_error("geoson::FeatureReader(): cannot open \"" + file.string() + '\"');
+            return file_;
+        }
+    };
+
+    namespace op {
+        template <typename Fn> void visitFeatures(FeatureReader &reader, Fn &fn) {
+            KeyScope keys;
+            Feature feature;
+            while (reader.next(feature)) {
+                if constexpr (std::is_convertible_v<std::invoke_result_t<Fn &, const Feature &>, bool>) {
+                    if (!fn(std::as_const(feature)))
+                        return;
+                } else {
+                    fn(std::as_const(feature));
+                }
+            }
+        }
+    } // namespace op
+
+    /// Calls `fn(const Feature &)` for every feature in the stream. If `fn` returns something convertible to
+    /// bool, returning false stops reading right there.
+    template <typename Fn> void ForEachFeature(std::istream &is, Fn &&fn) {
+        FeatureReader reader(is);
+        op::visitFeatures(reader, fn);
+    }
+
+    /// Same as above for a document already in memory.
+    template <typename Fn> void ForEachFeatureInBuffer(std::string_view data, Fn &&fn) {
+        auto reader = FeatureReader::fromBuffer(data);
+        op::visitFeatures(reader, fn);
+    }
+
+    /// Same as above for a file; regular files are memory-mapped rather than streamed.
+    template <typename Fn> void ForEachFeature(const std::filesystem::path &file, Fn &&fn) {
+        if (op::MappedFile map{file}) {
+            ForEachFeatureInBuffer(map.view(), fn);
+            return;
+        }
+        std::ifstream ifs(file, std::ios::binary);
+        if (!ifs) {
+            throw std::runtime_error("geoson::ForEachFeature(): cannot open \"" + file.string() + '\"');
+        }
+        ForEachFeature(ifs, fn);
+    }
+
+} // namespace geoson
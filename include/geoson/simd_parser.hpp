@@ -0,0 +1,227 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <simdjson.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "concord/concord.hpp"
+
+#include "geoson/transform.hpp"
+#include "geoson/types.hpp"
+
+namespace geoson {
+
+    /// simdjson fast path for single features, enabled by building with `GEOSON_USE_SIMDJSON` (CMake option
+    /// `GEOSON_ENABLE_SIMDJSON`).
+    ///
+    /// It only takes the shapes it can decode exactly like the nlohmann path: objects, numeric positions, string
+    /// types. Anything else -- malformed JSON included -- reports false, and the caller re-parses the same text
+    /// with nlohmann, so results and error messages never depend on the backend. Duplicate keys resolve to the
+    /// last occurrence, as in nlohmann.
+    namespace op::simd {
+        using simdjson::dom::element;
+
+        /// `obj`'s last member called `key`, or false when there is none
+        inline bool member(simdjson::dom::object obj, std::string_view key, element &out) {
+            bool found = false;
+            for (auto field : obj) {
+                if (field.key == key) {
+                    out = field.value;
+                    found = true;
+                }
+            }
+            return found;
+        }
+
+        inline bool position(element e, concord::Point &p) {
+            simdjson::dom::array a;
+            if (e.get_array().get(a) || a.size() < 2)
+                return false;
+            double v[3] = {0.0, 0.0, 0.0};
+            std::size_t i = 0;
+            for (element c : a) {
+                if (i == 3)
+                    break;
+                if (!c.is_number() || c.get_double().get(v[i]))
+                    return false;
+                ++i;
+            }
+            p = concord::Point{v[0], v[1], v[2]};
+            return true;
+        }
+
+        inline bool positions(element e, const DatumTransform &tf, CRS crs, std::vector<concord::Point> &pts) {
+            simdjson::dom::array a;
+            if (e.get_array().get(a))
+                return false;
+            pts.clear();
+            pts.reserve(a.size());
+            for (element c : a) {
+                concord::Point p;
+                if (!position(c, p))
+                    return false;
+                pts.push_back(p);
+            }
+            addStat(&Stats::coordinates, pts.size());
+            if (crs == CRS::WGS)
+                tf.toENU(pts.data(), pts.size());
+            return true;
+        }
+
+        inline bool lineString(element e, const DatumTransform &tf, CRS crs, std::vector<Geometry> &out) {
+            std::vector<concord::Point> pts;
+            if (!positions(e, tf, crs, pts))
+                return false;
+            if (pts.size() == 2)
+                out.emplace_back(concord::Line{pts[0], pts[1]});
+            else
+                out.emplace_back(concord::Path{pts});
+            return true;
+        }
+
+        inline bool polygon(element e, const DatumTransform &tf, CRS crs, std::vector<Geometry> &out) {
+            simdjson::dom::array rings;
+            if (e.get_array().get(rings) || rings.size() == 0)
+                return false;
+            std::vector<concord::Point> pts;
+            if (!positions(rings.at(0).value_unsafe(), tf, crs, pts))
+                return false;
+            out.emplace_back(concord::Polygon{pts});
+            return true;
+        }
+
+        inline bool geometry(element e, const DatumTransform &tf, CRS crs, std::vector<Geometry> &out) {
+            simdjson::dom::object obj;
+            element type_el;
+            std::string_view type;
+            if (e.get_object().get(obj) || !member(obj, "type", type_el) || type_el.get_string().get(type))
+                return false;
+
+            const bool collection = type == "GeometryCollection";
+            element coords;
+            if ((type == "Point" || type == "LineString" || type == "Polygon" || type == "MultiPoint" ||
+                 type == "MultiLineString" || type == "MultiPolygon" || collection) &&
+                !member(obj, collection ? "geometries" : "coordinates", coords))
+                return false;
+
+            if (type == "Point") {
+                concord::Point p;
+                if (!position(coords, p))
+                    return false;
+                addStat(&Stats::coordinates, 1);
+                if (crs == CRS::WGS)
+                    tf.toENU(&p, 1);
+                out.emplace_back(p);
+            } else if (type == "LineString") {
+                return lineString(coords, tf, crs, out);
+            } else if (type == "Polygon") {
+                return polygon(coords, tf, crs, out);
+            } else if (type == "MultiPoint") {
+                std::vector<concord::Point> pts;
+                if (!positions(coords, tf, crs, pts))
+                    return false;
+                for (auto const &p : pts)
+                    out.emplace_back(p);
+            } else if (type == "MultiLineString" || type == "MultiPolygon" || collection) {
+                simdjson::dom::array parts;
+                if (coords.get_array().get(parts))
+                    return false;
+                for (element part : parts) {
+                    bool ok = type == "MultiLineString" ? lineString(part, tf, crs, out)
+                              : collection              ? geometry(part, tf, crs, out)
+                                                        : polygon(part, tf, crs, out);
+                    if (!ok)
+                        return false;
+                }
+            }
+            return true; // unknown types carry no geometry, as in parseGeometry
+        }
+
+        /// element -> nlohmann value, so non-string properties are dumped exactly as the nlohmann path dumps them
+        inline nlohmann::json toJson(element e) {
+            switch (e.type()) {
+            case simdjson::dom::element_type::OBJECT: {
+                auto j = nlohmann::json::object();
+                simdjson::dom::object obj = e.get_object().value_unsafe();
+                for (auto field : obj)
+                    j[std::string(field.key)] = toJson(field.value);
+                return j;
+            }
+            case simdjson::dom::element_type::ARRAY: {
+                auto j = nlohmann::json::array();
+                simdjson::dom::array arr = e.get_array().value_unsafe();
+                for (element c : arr)
+                    j.push_back(toJson(c));
+                return j;
+            }
+            case simdjson::dom::element_type::STRING:
+                return std::string(e.get_string().value_unsafe());
+            case simdjson::dom::element_type::INT64:
+                return e.get_int64().value_unsafe();
+            case simdjson::dom::element_type::UINT64:
+                return e.get_uint64().value_unsafe();
+            case simdjson::dom::element_type::DOUBLE:
+                return e.get_double().value_unsafe();
+            case simdjson::dom::element_type::BOOL:
+                return e.get_bool().value_unsafe();
+            default:
+                return nullptr;
+            }
+        }
+
+        /// same typing as `parsePropertyValue`
+        inline PropertyValue propertyValue(element e) {
+            switch (e.type()) {
+            case simdjson::dom::element_type::STRING:
+                return e.get_string().value_unsafe();
+            case simdjson::dom::element_type::INT64:
+                return e.get_int64().value_unsafe();
+            case simdjson::dom::element_type::DOUBLE:
+                return e.get_double().value_unsafe();
+            case simdjson::dom::element_type::BOOL:
+                return e.get_bool().value_unsafe();
+            default: // uint64 only holds values beyond int64 here
+                return PropertyValue::fromJson(toJson(e).dump());
+            }
+        }
+
+        inline bool properties(element e, Properties &m) {
+            if (e.is_null())
+                return true;
+            simdjson::dom::object obj;
+            if (e.get_object().get(obj))
+                return false;
+            m.reserve(obj.size());
+            for (auto field : obj)
+                m.insert_or_assign(field.key, propertyValue(field.value));
+            return true;
+        }
+
+        /// Decodes one feature's raw text, appending to `out` only on success.
+        inline bool parseFeature(std::string_view text, const DatumTransform &tf, CRS crs, std::vector<Feature> &out) {
+            thread_local simdjson::dom::parser parser;
+            element root;
+            simdjson::dom::object feat;
+            if (timed(&Stats::dom_ns, [&] { return parser.parse(text.data(), text.size()).get(root); }) ||
+                root.get_object().get(feat))
+                return false;
+
+            element geom, props_el;
+            if (!member(feat, "geometry", geom) || geom.is_null())
+                return true;
+            std::vector<Geometry> geoms;
+            Properties props; // one shared property bag for all sub-geometries
+            if (!timed(&Stats::geometry_ns, [&] { return geometry(geom, tf, crs, geoms); }) ||
+                (member(feat, "properties", props_el) &&
+                 !timed(&Stats::properties_ns, [&] { return properties(props_el, props); })))
+                return false;
+            for (auto &g : geoms)
+                out.emplace_back(Feature{std::move(g), props});
+            return true;
+        }
+    } // namespace op::simd
+
+} // namespace geoson
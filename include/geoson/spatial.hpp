@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "concord/concord.hpp"
+
+#include "geoson/types.hpp"
+
+namespace geoson {
+
+    namespace op {
+        /// box around every position of `geometry`
+        inline Bounds bounds(const Geometry &geometry) {
+            Bounds b;
+            std::visit(
+                [&](auto const &shape) {
+                    using T = std::decay_t<decltype(shape)>;
+                    if constexpr (std::is_same_v<T, concord::Point>) {
+                        b.expand(shape);
+                    } else if constexpr (std::is_same_v<T, concord::Line>) {
+                        b.expand(shape.getStart());
+                        b.expand(shape.getEnd());
+                    } else {
+                        for (auto const &p : shape.getPoints())
+                            b.expand(p);
+                    }
+                },
+                geometry);
+            return b;
+        }
+
+        /// planar (x/y) distance from `p` to the box; 0 inside it
+        inline double distance(const Bounds &b, double x, double y) {
+            const double dx = std::max({b.min_x - x, 0.0, x - b.max_x});
+            const double dy = std::max({b.min_y - y, 0.0, y - b.max_y});
+            return std::hypot(dx, dy);
+        }
+
+        inline double segmentDistance(const concord::Point &a, const concord::Point &b, double x, double y) {
+            const double vx = b.x - a.x, vy = b.y - a.y;
+            const double len2 = vx * vx + vy * vy;
+            double t = len2 > 0.0 ? ((x - a.x) * vx + (y - a.y) * vy) / len2 : 0.0;
+            t = std::clamp(t, 0.0, 1.0);
+            return std::hypot(a.x + t * vx - x, a.y + t * vy - y);
+        }
+
+        /// planar (x/y) distance from (x, y) to `geometry`; 0 inside a polygon
+        inline double distance(const Geometry &geometry, double x, double y) {
+            return std::visit(
+                [&](auto const &shape) -> double {
+                    using T = std::decay_t<decltype(shape)>;
+                    if constexpr (std::is_same_v<T, concord::Point>) {
+                        return std::hypot(shape.x - x, shape.y - y);
+                    } else if constexpr (std::is_same_v<T, concord::Line>) {
+                        return segmentDistance(shape.getStart(), shape.getEnd(), x, y);
+                    } else {
+                        auto const &pts = shape.getPoints();
+                        if (pts.empty())
+                            return std::numeric_limits<double>::infinity();
+                        if (pts.size() == 1)
+                            return std::hypot(pts[0].x - x, pts[0].y - y);
+                        double d = std::numeric_limits<double>::infinity();
+                        for (std::size_t i = 1; i < pts.size(); ++i)
+                            d = std::min(d, segmentDistance(pts[i - 1], pts[i], x, y));
+                        if constexpr (std::is_same_v<T, concord::Polygon>) {
+                            // the ring may or may not repeat its first point; close it either way
+                            d = std::min(d, segmentDistance(pts.back(), pts.front(), x, y));
+                            bool inside = false;
+                            for (std::size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++) {
+                                if ((pts[i].y > y) != (pts[j].y > y) &&
+                                    x < (pts[j].x - pts[i].x) * (y - pts[i].y) / (pts[j].y - pts[i].y) + pts[i].x)
+                                    inside = !inside;
+                            }
+                            if (inside)
+                                return 0.0;
+                        }
+                        return d;
+                    }
+                },
+                geometry);
+        }
+    } // namespace op
+
+    /// Static R-tree over planar (x/y) boxes, bulk-loaded with Sort-Tile-Recursive packing. Entries are identified
+    /// by their position in the box list given to the constructor.
+    ///
+    /// Nodes live level by level in flat vectors, and every node's children are one contiguous run of the level
+    /// below, so a query is a walk over packed arrays.
+    class SpatialIndex {
+      public:
+        static constexpr std::size_t node_capacity = 16;
+
+        struct Entry {
+            Bounds box;
+            std::size_t id;
+        };
+        struct Node {
+            Bounds box;
+            std::size_t first; // children: [first, first + count) in the next level, or in entries_ for leaves
+            std::size_t count;
+        };
+
+        SpatialIndex() = default;
+
+        /// a tree saved earlier from `entries()` and `levels()`, taken over as is instead of being packed again
+        SpatialIndex(std::vector<Entry> entries, std::vector<std::vector<Node>> levels)
+            : entries_(std::move(entries)), levels_(std::move(levels)) {}
+
+        explicit SpatialIndex(const std::vector<Bounds> &boxes) {
+            entries_.reserve(boxes.size());
+            for (std::size_t i = 0; i < boxes.size(); ++i)
+                if (!boxes[i].empty())
+                    entries_.push_back(Entry{boxes[i], i});
+            pack(entries_);
+
+            std::vector<Node> level = group(entries_);
+            while (level.size() > 1) {
+                pack(level);
+                levels_.push_back(std::move(level));
+                level = group(levels_.back());
+            }
+            if (!level.empty())
+                levels_.push_back(std::move(level));
+            std::reverse(levels_.begin(), levels_.end()); // root first
+        }
+
+        std::size_t size() const { return entries_.size(); }
+        bool empty() const { return entries_.empty(); }
+
+        /// the packed layout: leaf entries in tree order, and the node levels root first
+        const std::vector<Entry> &entries() const { return entries_; }
+        const std::vector<std::vector<Node>> &levels() const { return levels_; }
+
+        /// calls `fn(id)` for every entry whose box overlaps [min_x, max_x] x [min_y, max_y]
+        template <typename Fn> void search(double min_x, double min_y, double max_x, double max_y, Fn &&fn) const {
+            if (levels_.empty())
+                return;
+            auto overlaps = [&](const Bounds &b) {
+                return b.min_x <= max_x && b.max_x >= min_x && b.min_y <= max_y && b.max_y >= min_y;
+            };
+            std::vector<std::pair<std::size_t, std::size_t>> stack{{0, 0}}; // (level, node)
+            while (!stack.empty()) {
+                auto [lvl, idx] = stack.back();
+                stack.pop_back();
+                const Node &node = levels_[lvl][idx];
+                if (!overlaps(node.box))
+                    continue;
+                for (std::size_t c = node.first; c < node.first + node.count; ++c) {
+                    if (lvl + 1 < levels_.size()) {
+                        stack.emplace_back(lvl + 1, c);
+                    } else if (overlaps(entries_[c].box)) {
+                        fn(entries_[c].id);
+                    }
+                }
+            }
+        }
+
+        /// Up to `k` entry ids ordered by increasing `dist(id)`, which must never be below the planar distance
+        /// from (x, y) to that entry's box; an entry whose `dist` is infinite is left out. Best-first search, so
+        /// only nodes closer than the k-th hit are opened.
+        template <typename Dist>
+        std::vector<std::size_t> nearest(double x, double y, std::size_t k, Dist &&dist) const {
+            std::vector<std::size_t> out;
+            if (levels_.empty() || k == 0)
+                return out;
+            struct Item {
+                double d;
+                std::size_t level; // node level; levels_.size() is an entry's box, `exact` its own distance
+                std::size_t index;
+                bool operator>(const Item &o) const { return d > o.d || (d == o.d && index > o.index); }
+            };
+            const std::size_t exact = levels_.size() + 1;
+            std::priority_queue<Item, std::vector<Item>, std::greater<>> queue;
+            queue.push({op::distance(levels_[0][0].box, x, y), 0, 0});
+            while (!queue.empty() && out.size() < k) {
+                const Item top = queue.top();
+                queue.pop();
+                if (top.level == exact) {
+                    if (top.d != std::numeric_limits<double>::infinity())
+                        out.push_back(top.index);
+                } else if (top.level == levels_.size()) { // an entry's box: replace with its exact distance
+                    queue.push({dist(entries_[top.index].id), exact, entries_[top.index].id});
+                } else {
+                    const Node &node = levels_[top.level][top.index];
+                    for (std::size_t c = node.first; c < node.first + node.count; ++c) {
+                        const Bounds &b = top.level + 1 < levels_.size() ? levels_[top.level + 1][c].box
+                                                                         : entries_[c].box;
+                        queue.push({op::distance(b, x, y), top.level + 1, c});
+                    }
+                }
+            }
+            return out;
+        }
+
+      private:
+        std::vector<Entry> entries_;
+        std::vector<std::vector<Node>> levels_; // root level first
+
+        /// STR order: sort by x centre, cut into vertical slices, sort each slice by y centre
+        template <typename T> static void pack(std::vector<T> &items) {
+            auto cx = [](const T &t) { return t.box.min_x + t.box.max_x; };
+            auto cy = [](const T &t) { return t.box.min_y + t.box.max_y; };
+            const std::size_t pages = (items.size() + node_capacity - 1) / node_capacity;
+            const auto slices = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(pages))));
+            const std::size_t per_slice = std::max<std::size_t>(1, slices) * node_capacity;
+            std::sort(items.begin(), items.end(), [&](const T &a, const T &b) { return cx(a) < cx(b); });
+            for (std::size_t s = 0; s < items.size(); s += per_slice) {
+                auto end = items.begin() + static_cast<std::ptrdiff_t>(std::min(items.size(), s + per_slice));
+                std::sort(items.begin() + static_cast<std::ptrdiff_t>(s), end,
+                          [&](const T &a, const T &b) { return cy(a) < cy(b); });
+            }
+        }
+
+        /// one parent per run of `node_capacity` consecutive children
+        template <typename T> static std::vector<Node> group(const std::vector<T> &children) {
+            std::vector<Node> parents;
+            parents.reserve((children.size() + node_capacity - 1) / node_capacity);
+            for (std::size_t first = 0; first < children.size(); first += node_capacity) {
+                Node node{Bounds{}, first, std::min(node_capacity, children.size() - first)};
+                for (std::size_t c = first; c < first + node.count; ++c) {
+                    const Bounds &b = children[c].box;
+                    node.box.min_x = std::min(node.box.min_x, b.min_x);
+                    node.box.min_y = std::min(node.box.min_y, b.min_y);
+                    node.box.min_z = std::min(node.box.min_z, b.min_z);
+                    node.box.max_x = std::max(node.box.max_x, b.max_x);
+                    node.box.max_y = std::max(node.box.max_y, b.max_y);
+                    node.box.max_z = std::max(node.box.max_z, b.max_z);
+                }
+                parents.push_back(node);
+            }
+            return parents;
+        }
+    };
+
+} // namespace geoson
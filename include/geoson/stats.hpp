@@ -0,0 +1,155 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+#ifndef GEOSON_USE_STATS
+#define GEOSON_USE_STATS 0
+#endif
+
+namespace geoson {
+
+    /// Counters and per-phase times of the reads and writes run on a thread while a `StatsScope` is active, for
+    /// feeding a metrics exporter. Times are in nanoseconds and nest: `geometry_ns` includes the `crs_ns` spent
+    /// converting WGS input, `serialize_ns` the conversion for WGS output. With `ReadOptions::threads` > 1 the
+    /// phase times are summed over the workers, so they can exceed `read_ns`.
+    ///
+    /// Collecting is compiled in only with `GEOSON_USE_STATS=1` (CMake: `-DGEOSON_ENABLE_STATS=ON`, which puts it
+    /// on the `geoson` target). Without it a scope records nothing and every measuring point compiles to nothing.
+    struct Stats {
+        std::uint64_t bytes_read = 0;
+        std::uint64_t bytes_written = 0;
+        std::uint64_t features = 0;    ///< features read, or written
+        std::uint64_t coordinates = 0; ///< positions parsed, or written
+        std::uint64_t allocations = 0; ///< only what the application reports through `countAllocation`
+
+        std::uint64_t read_ns = 0;       ///< whole `ReadFeatureCollection` / `Vector::fromFile` calls
+        std::uint64_t dom_ns = 0;        ///< splitting the document into features and parsing their JSON
+        std::uint64_t geometry_ns = 0;   ///< coordinates to geometries
+        std::uint64_t crs_ns = 0;        ///< WGS <-> ENU conversion
+        std::uint64_t properties_ns = 0; ///< property values
+        std::uint64_t serialize_ns = 0;  ///< whole writes
+
+        Stats &operator+=(const Stats &o) {
+            bytes_read += o.bytes_read;
+            bytes_written += o.bytes_written;
+            features += o.features;
+            coordinates += o.coordinates;
+            allocations += o.allocations;
+            read_ns += o.read_ns;
+            dom_ns += o.dom_ns;
+            geometry_ns += o.geometry_ns;
+            crs_ns += o.crs_ns;
+            properties_ns += o.properties_ns;
+            serialize_ns += o.serialize_ns;
+            return *this;
+        }
+    };
+
+    namespace op {
+        /// Whether collection is compiled in. Only the function bodies depend on it -- every type has the same
+        /// layout either way -- but it should still be set for a whole program, as the CMake target does.
+        inline constexpr bool stats_enabled = GEOSON_USE_STATS != 0;
+
+        /// the sink of the innermost StatsScope on this thread, or null
+        inline Stats *&activeStats() {
+            thread_local Stats *stats = nullptr;
+            return stats;
+        }
+
+        inline void addStat(std::uint64_t Stats::*counter, std::uint64_t n) {
+            if constexpr (stats_enabled)
+                if (Stats *stats = activeStats())
+                    stats->*counter += n;
+        }
+
+        /// adds the time from construction to destruction to `timer` of the active sink
+        class StatTimer {
+          public:
+            explicit StatTimer(std::uint64_t Stats::*timer) : timer_(timer) {
+                if constexpr (stats_enabled)
+                    if ((stats_ = activeStats()))
+                        start_ = std::chrono::steady_clock::now();
+            }
+            ~StatTimer() {
+                if constexpr (stats_enabled)
+                    if (stats_)
+                        stats_->*timer_ += static_cast<std::uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                                 start_)
+                                .count());
+            }
+            StatTimer(const StatTimer &) = delete;
+            StatTimer &operator=(const StatTimer &) = delete;
+
+          private:
+            Stats *stats_ = nullptr;
+            std::uint64_t Stats::*timer_;
+            std::chrono::steady_clock::time_point start_;
+        };
+
+        /// `fn()`, with the time it takes added to `timer`
+        template <typename Fn> auto timed(std::uint64_t Stats::*timer, Fn &&fn) {
+            StatTimer t(timer);
+            return fn();
+        }
+    } // namespace op
+
+    /// Routes the statistics of the reads and writes on this thread into `stats` for the scope's lifetime. Scopes
+    /// nest; the inner one wins. Counters accumulate, so one sink can cover many calls.
+    class StatsScope {
+      public:
+        explicit StatsScope([[maybe_unused]] Stats &stats) {
+            if constexpr (op::stats_enabled)
+                previous_ = std::exchange(op::activeStats(), &stats);
+        }
+        ~StatsScope() {
+            if constexpr (op::stats_enabled)
+                op::activeStats() = previous_;
+        }
+        StatsScope(const StatsScope &) = delete;
+        StatsScope &operator=(const StatsScope &) = delete;
+
+      private:
+        Stats *previous_ = nullptr;
+    };
+
+    /// Counts one allocation into the active sink. geoson cannot see the heap itself: call this from the
+    /// application's replacement `operator new` to get `Stats::allocations`.
+    inline void countAllocation() { op::addStat(&Stats::allocations, 1); }
+
+    namespace op {
+        /// For a thread working on behalf of a caller whose sink is `parent` (null when it has none): collects into
+        /// a private Stats and adds it to `parent` once, on destruction, so threads sharing a sink never race.
+        class WorkerStats {
+          public:
+            explicit WorkerStats(Stats *parent) : parent_(parent) {
+                if constexpr (stats_enabled) {
+                    previous_ = std::exchange(activeStats(), nullptr);
+                    if (parent_)
+                        activeStats() = &local_;
+                }
+            }
+            ~WorkerStats() {
+                if constexpr (stats_enabled) {
+                    activeStats() = previous_;
+                    if (parent_) {
+                        static std::mutex mutex;
+                        std::lock_guard<std::mutex> lock(mutex);
+                        *parent_ += local_;
+                    }
+                }
+            }
+            WorkerStats(const WorkerStats &) = delete;
+            WorkerStats &operator=(const WorkerStats &) = delete;
+
+          private:
+            Stats *parent_;
+            Stats *previous_ = nullptr;
+            Stats local_;
+        };
+    } // namespace op
+
+} // namespace geoson
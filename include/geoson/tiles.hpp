@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "concord/concord.hpp"
+
+#include "geoson/binary.hpp"
+#include "geoson/bulk.hpp"
+#include "geoson/transform.hpp"
+#include "geoson/types.hpp"
+#include "geoson/writter.hpp"
+
+namespace geoson {
+
+    /// How `WriteTiles` cuts the plane into tiles.
+    enum class TileScheme {
+        ENU,         ///< squares of `TileOptions::tile_size` metres in the collection's ENU frame, named "x_y"
+        WebMercator, ///< the usual z/x/y slippy-map tiles at `TileOptions::zoom`, named "z/x/y"
+    };
+
+    /// What happens to a geometry that crosses tile edges.
+    enum class TileStraddle {
+        Duplicate, ///< written whole to every tile its bounding box touches
+        Clip,      ///< cut at the tile edges; each tile gets the part inside it (a path may fall into several pieces)
+    };
+
+    enum class TileFormat { GeoJSON, Binary };
+
+    struct TileOptions {
+        TileScheme scheme = TileScheme::ENU;
+        /// edge length in metres, for `TileScheme::ENU`
+        double tile_size = 100.0;
+        /// zoom level, for `TileScheme::WebMercator`
+        int zoom = 16;
+        TileStraddle straddle = TileStraddle::Duplicate;
+        TileFormat format = TileFormat::GeoJSON;
+        /// coordinates of GeoJSON tiles
+        CRS crs = CRS::ENU;
+        /// formatting of GeoJSON tiles
+        WriteOptions write = WriteOptions::compact();
+        /// worker threads for clipping and writing; 0 uses every hardware thread
+        unsigned threads = 0;
+    };
+
+    /// one tile `WriteTiles` wrote
+    struct TileInfo {
+        std::int64_t x = 0, y = 0;
+        int z = 0; ///< the zoom level for WebMercator tiles, 0 for ENU ones
+        std::filesystem::path path;
+        std::size_t features = 0;
+    };
+
+    namespace op {
+        /// Maps ENU coordinates to tile units, where tile (x, y) covers [x, x + 1) x [y, y + 1), and back. Heights
+        /// pass through.
+        class TileSpace {
+          public:
+            TileSpace(const TileOptions &opts, const concord::Datum &datum)
+                : scheme_(opts.scheme), size_(opts.tile_size), tiles_(std::ldexp(1.0, opts.zoom)),
+                  tf_(DatumTransform::shared(datum)) {
+                if (scheme_ == TileScheme::ENU && !(size_ > 0.0))
+                    throw std::invalid_argument("geoson::WriteTiles(): tile_size must be positive");
+                if (scheme_ == TileScheme::WebMercator && (opts.zoom < 0 || opts.zoom > 30))
+                    throw std::invalid_argument("geoson::WriteTiles(): zoom must be within 0..30");
+            }
+
+            void forward(std::vector<concord::Point> &pts) const {
+                if (scheme_ == TileScheme::ENU) {
+                    for (auto &p : pts)
+                        p.x /= size_, p.y /= size_;
+                    return;
+                }
+                tf_->toWGS(pts.data(), pts.size()); // x/y now hold lon/lat
+                for (auto &p : pts) {
+                    const double phi = std::clamp(p.y, -max_lat, max_lat) * deg;
+                    p.x = (p.x + 180.0) / 360.0 * tiles_;
+                    p.y = (1.0 - std::asinh(std::tan(phi)) / M_PI) / 2.0 * tiles_;
+                }
+            }
+
+            void inverse(std::vector<concord::Point> &pts) const {
+                if (scheme_ == TileScheme::ENU) {
+                    for (auto &p : pts)
+                        p.x *= size_, p.y *= size_;
+                    return;
+                }
+                for (auto &p : pts) {
+                    const double lon = p.x / tiles_ * 360.0 - 180.0;
+                    p.y = std::atan(std::sinh(M_PI * (1.0 - 2.0 * p.y / tiles_))) / deg;
+                    p.x = lon;
+                }
+                tf_->toENU(pts.data(), pts.size());
+            }
+
+          private:
+            static constexpr double deg = M_PI / 180.0;
+            static constexpr double max_lat = 85.0511287798066; // where Web Mercator is square
+
+            TileScheme scheme_;
+            double size_, tiles_;
+            std::shared_ptr<const DatumTransform> tf_;
+        };
+
+        inline concord::Point lerp(const concord::Point &a, const concord::Point &b, double t) {
+            return concord::Point{a.x + t * (b.x - a.x), a.y + t * (b.y - a.y), a.z + t * (b.z - a.z)};
+        }
+
+        /// Sutherland-Hodgman: the part of ring `pts` inside the box, empty when less than a triangle remains;
+        /// closed again if `pts` was
+        inline std::vector<concord::Point> clipRing(const std::vector<concord::Point> &pts, double x0, double y0,
+                                                    double x1, double y1) {
+            std::vector<concord::Point> ring = pts;
+            const bool closed = ring.size() > 1 && ring.front().x == ring.back().x && ring.front().y == ring.back().y &&
+                                ring.front().z == ring.back().z;
+            if (closed)
+                ring.pop_back();
+
+            // one box edge at a time: `side(p)` >= 0 inside, the crossing found by `cross`
+            auto clip = [&](auto side) {
+                std::vector<concord::Point> out;
+                for (std::size_t i = 0; i < ring.size(); ++i) {
+                    const concord::Point &a = ring[i], &b = ring[(i + 1) % ring.size()];
+                    const double sa = side(a), sb = side(b);
+                    if (sa >= 0)
+                        out.push_back(a);
+                    if ((sa >= 0) != (sb >= 0))
+                        out.push_back(lerp(a, b, sa / (sa - sb)));
+                }
+                ring = std::move(out);
+            };
+            clip([&](const concord::Point &p) { return p.x - x0; });
+            clip([&](const concord::Point &p) { return x1 - p.x; });
+            clip([&](const concord::Point &p) { return p.y - y0; });
+            clip([&](const concord::Point &p) { return y1 - p.y; });
+
+            if (ring.size() < 3)
+                return {};
+            if (closed)
+                ring.push_back(ring.front());
+            return ring;
+        }
+
+        /// Liang-Barsky per segment: the pieces of polyline `pts` inside the box
+        inline std::vector<std::vector<concord::Point>> clipPolyline(const std::vector<concord::Point> &pts,
+                                                                     double x0, double y0, double x1, double y1) {
+            std::vector<std::vector<concord::Point>> pieces;
+            std::vector<concord::Point> current;
+            auto flush = [&] {
+                if (current.size() >= 2)
+                    pieces.push_back(std::move(current));
+                current.clear();
+            };
+
+            for (std::size_t i = 0; i + 1 < pts.size(); ++i) {
+                const concord::Point &a = pts[i], &b = pts[i + 1];
+                const double dx = b.x - a.x, dy = b.y - a.y;
+                double t0 = 0.0, t1 = 1.0;
+                bool inside = true;
+                for (auto [p, q] : {std::pair{-dx, a.x - x0}, {dx, x1 - a.x}, {-dy, a.y - y0}, {dy, y1 - a.y}}) {
+                    if (p == 0.0) {
+                        inside = inside && q >= 0.0;
+                    } else if (p < 0.0) {
+                        t0 = std::max(t0, q / p);
+                    } else {
+                        t1 = std::min(t1, q / p);
+                    }
+                }
+                if (!inside || t0 > t1) {
+                    flush();
+                    continue;
+                }
+                if (!current.empty() && t0 > 0.0)
+                    flush();
+                if (current.empty())
+                    current.push_back(lerp(a, b, t0));
+                current.push_back(lerp(a, b, t1));
+                if (t1 < 1.0)
+                    flush();
+            }
+            flush();
+
+            // a piece that only touches the box is a single repeated point
+            std::erase_if(pieces, [](const std::vector<concord::Point> &piece) {
+                return std::all_of(piece.begin(), piece.end(), [&](const concord::Point &p) {
+                    return p.x == piece.front().x && p.y == piece.front().y;
+                });
+            });
+            return pieces;
+        }
+
+        /// first and last tile index along one axis for tile-unit extent [lo, hi]; an extent ending exactly on an
+        /// edge stays out of the next tile
+        inline std::pair<std::int64_t, std::int64_t> tileSpan(double lo, double hi) {
+            const auto first = static_cast<std::int64_t>(std::floor(lo));
+            return {first, std::max(first, static_cast<std::int64_t>(std::ceil(hi)) - 1)};
+        }
+    } // namespace op
+
+    /// Cuts `fc` into tiles and writes every non-empty one as its own collection under `dir`: "x_y.geojson" for
+    /// ENU tiles, "z/x/y.geojson" for Web Mercator ones (".gsb" with `TileFormat::Binary`). Each tile keeps the
+    /// collection's datum, heading and global properties, and its features keep their input order.
+    ///
+    /// Features are bucketed by their bounding box in one pass; tiles are then clipped and written concurrently
+    /// on `opts.threads` workers. Returns the tiles written, ordered by (x, y). A feature without positions (an
+    /// empty path or polygon) belongs to no tile and is rejected with std::invalid_argument naming its index,
+    /// before anything is written.
+    inline std::vector<TileInfo> WriteTiles(const FeatureCollection &fc, const std::filesystem::path &dir,
+                                            const TileOptions &opts = {}) {
+        const op::TileSpace space(opts, fc.datum);
+        const bool mercator = opts.scheme == TileScheme::WebMercator;
+        using Key = std::pair<std::int64_t, std::int64_t>;
+
+        // feature -> tiles, by tile-unit bounding box
+        auto spans = op::forRanges(fc.features.size(), opts.threads, op::bulk_grain, [&](std::size_t b, std::size_t e) {
+            std::vector<std::pair<Key, std::size_t>> hits;
+            for (std::size_t i = b; i < e; ++i) {
+                auto pts = op::positions(fc.features[i].geometry);
+                if (pts.empty())
+                    throw std::invalid_argument("geoson::WriteTiles(): feature " + std::to_string(i) +
+                                                " has no positions");
+                space.forward(pts);
+                Bounds box;
+                for (auto const &p : pts)
+                    box.expand(p);
+                if (std::holds_alternative<concord::Point>(fc.features[i].geometry)) {
+                    hits.emplace_back(Key{static_cast<std::int64_t>(std::floor(box.min_x)),
+                                          static_cast<std::int64_t>(std::floor(box.min_y))},
+                                      i);
+                    continue;
+                }
+                auto [tx0, tx1] = op::tileSpan(box.min_x, box.max_x);
+                auto [ty0, ty1] = op::tileSpan(box.min_y, box.max_y);
+                for (std::int64_t tx = tx0; tx <= tx1; ++tx)
+                    for (std::int64_t ty = ty0; ty <= ty1; ++ty)
+                        hits.emplace_back(Key{tx, ty}, i);
+            }
+            return hits;
+        });
+        std::map<Key, std::vector<std::size_t>> buckets;
+        for (auto const &part : spans)
+            for (auto const &[key, i] : part)
+                buckets[key].push_back(i);
+
+        const std::string ext = opts.format == TileFormat::Binary ? ".gsb" : ".geojson";
+        std::vector<TileInfo> tiles;
+        tiles.reserve(buckets.size());
+        std::set<std::filesystem::path> dirs{dir};
+        for (auto const &[key, members] : buckets) {
+            TileInfo info;
+            info.x = key.first, info.y = key.second;
+            if (mercator) {
+                info.z = opts.zoom;
+                info.path = dir / std::to_string(info.z) / std::to_string(info.x) / (std::to_string(info.y) + ext);
+            } else {
+                info.path = dir / (std::to_string(info.x) + '_' + std::to_string(info.y) + ext);
+            }
+            dirs.insert(info.path.parent_path());
+            tiles.push_back(std::move(info));
+        }
+        for (auto const &d : dirs)
+            std::filesystem::create_directories(d);
+
+        std::vector<const std::vector<std::size_t> *> members;
+        members.reserve(buckets.size());
+        for (auto const &bucket : buckets)
+            members.push_back(&bucket.second);
+
+        // one tile at a time per worker; a worker writes every tile of its range
+        op::forRanges(tiles.size(), opts.threads, 1, [&](std::size_t b, std::size_t e) {
+            for (std::size_t t = b; t < e; ++t) {
+                TileInfo &info = tiles[t];
+                const double x0 = static_cast<double>(info.x), y0 = static_cast<double>(info.y);
+                const double x1 = x0 + 1.0, y1 = y0 + 1.0;
+
+                FeatureCollection tile;
+                tile.datum = fc.datum;
+                tile.heading = fc.heading;
+                tile.global_properties = fc.global_properties;
+                for (std::size_t i : *members[t]) {
+                    const Feature &f = fc.features[i];
+                    if (opts.straddle == TileStraddle::Duplicate || std::holds_alternative<concord::Point>(f.geometry)) {
+                        tile.features.push_back(f);
+                        continue;
+                    }
+                    auto pts = op::positions(f.geometry);
+                    space.forward(pts);
+                    Bounds box;
+                    for (auto const &p : pts)
+                        box.expand(p);
+                    if (box.min_x >= x0 && box.max_x <= x1 && box.min_y >= y0 && box.max_y <= y1) {
+                        tile.features.push_back(f); // wholly inside: kept exactly as it was
+                        continue;
+                    }
+                    if (std::holds_alternative<concord::Polygon>(f.geometry)) {
+                        auto ring = op::clipRing(pts, x0, y0, x1, y1);
+                        if (ring.empty())
+                            continue;
+                        space.inverse(ring);
+                        tile.features.push_back(Feature{concord::Polygon{std::move(ring)}, f.properties});
+                        continue;
+                    }
+                    const bool line = std::holds_alternative<concord::Line>(f.geometry);
+                    for (auto &piece : op::clipPolyline(pts, x0, y0, x1, y1)) {
+                        space.inverse(piece);
+                        if (line)
+                            tile.features.push_back(Feature{concord::Line{piece.front(), piece.back()}, f.properties});
+                        else
+                            tile.features.push_back(Feature{concord::Path{std::move(piece)}, f.properties});
+                    }
+                }
+
+                info.features = tile.features.size();
+                if (tile.features.empty())
+                    continue;
+                if (opts.format == TileFormat::Binary)
+                    WriteBinaryCollection(tile, info.path);
+                else
+                    WriteFeatureCollection(tile, info.path, opts.crs, opts.write);
+            }
+        });
+
+        std::erase_if(tiles, [](const TileInfo &info) { return info.features == 0; });
+        return tiles;
+    }
+
+} // namespace geoson
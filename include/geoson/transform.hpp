@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "concord/concord.hpp"
+
+#include "geoson/stats.hpp"
+
+namespace geoson {
+
+    /// WGS84 <-> local ENU conversion for one datum. Everything that depends only on the datum (its ECEF position
+    /// and the ECEF -> ENU rotation) is computed once on construction instead of once per point.
+    ///
+    /// The batch calls walk contiguous arrays in fixed-size blocks: one loop does the per-point trigonometry, a
+    /// second the rotation, so both stay straight-line code the compiler can vectorise.
+    class DatumTransform {
+      public:
+        explicit DatumTransform(const concord::Datum &datum) : datum_(datum) {
+            const double phi = datum.lat * deg, lam = datum.lon * deg;
+            const double sp = std::sin(phi), cp = std::cos(phi), sl = std::sin(lam), cl = std::cos(lam);
+            const double N = a / std::sqrt(1.0 - e2 * sp * sp);
+            ox_ = (N + datum.alt) * cp * cl;
+            oy_ = (N + datum.alt) * cp * sl;
+            oz_ = (N * (1.0 - e2) + datum.alt) * sp;
+            // rows: east, north, up
+            r_[0] = -sl, r_[1] = cl, r_[2] = 0.0;
+            r_[3] = -sp * cl, r_[4] = -sp * sl, r_[5] = cp;
+            r_[6] = cp * cl, r_[7] = cp * sl, r_[8] = sp;
+        }
+
+        /// Shared instance for `datum`. A small process-wide cache keeps the most recently used datums, so the
+        /// readers, writers and geoget all convert through the same object without rebuilding it.
+        static std::shared_ptr<const DatumTransform> shared(const concord::Datum &datum) {
+            static std::mutex mutex;
+            static std::vector<std::shared_ptr<const DatumTransform>> cache; // most recent first
+            std::lock_guard<std::mutex> lock(mutex);
+            for (std::size_t i = 0; i < cache.size(); ++i) {
+                if (cache[i]->is(datum)) {
+                    std::rotate(cache.begin(), cache.begin() + i, cache.begin() + i + 1);
+                    return cache.front();
+                }
+            }
+            if (cache.size() == cache_size)
+                cache.pop_back();
+            cache.insert(cache.begin(), std::make_shared<const DatumTransform>(datum));
+            return cache.front();
+        }
+
+        const concord::Datum &datum() const { return datum_; }
+
+        /// true when this transform was built for exactly `datum`
+        bool is(const concord::Datum &datum) const {
+            return datum_.lat == datum.lat && datum_.lon == datum.lon && datum_.alt == datum.alt;
+        }
+
+        /// single-point conveniences over the array calls below; untimed, since a clock read per point would cost
+        /// more than the conversion (the point batches add to `Stats::crs_ns`)
+        concord::Point toENU(const concord::WGS &wgs) const {
+            concord::Point p;
+            toENU(1, &wgs.lon, &wgs.lat, &wgs.alt, &p.x, &p.y, &p.z);
+            return p;
+        }
+
+        concord::WGS toWGS(const concord::Point &enu) const {
+            double lon, lat, alt;
+            toWGS(1, &enu.x, &enu.y, &enu.z, &lon, &lat, &alt);
+            return concord::WGS{lat, lon, alt};
+        }
+
+        /// `n` geodetic coordinates (degrees, metres) to ENU metres. Outputs may alias the inputs.
+        void toENU(std::size_t n, const double *lon, const double *lat, const double *alt, double *x, double *y,
+                   double *z) const {
+            double dx[block], dy[block], dz[block];
+            for (std::size_t base = 0; base < n; base += block) {
+                const std::size_t m = std::min(block, n - base);
+                for (std::size_t i = 0; i < m; ++i) {
+                    const double phi = lat[base + i] * deg, lam = lon[base + i] * deg, h = alt[base + i];
+                    const double sp = std::sin(phi), cp = std::cos(phi);
+                    const double N = a / std::sqrt(1.0 - e2 * sp * sp);
+                    dx[i] = (N + h) * cp * std::cos(lam) - ox_;
+                    dy[i] = (N + h) * cp * std::sin(lam) - oy_;
+                    dz[i] = (N * (1.0 - e2) + h) * sp - oz_;
+                }
+                for (std::size_t i = 0; i < m; ++i) {
+                    x[base + i] = r_[0] * dx[i] + r_[1] * dy[i] + r_[2] * dz[i];
+                    y[base + i] = r_[3] * dx[i] + r_[4] * dy[i] + r_[5] * dz[i];
+                    z[base + i] = r_[6] * dx[i] + r_[7] * dy[i] + r_[8] * dz[i];
+                }
+            }
+        }
+
+        /// `n` ENU coordinates (metres) to geodetic lon/lat (degrees) and altitude (metres). Outputs may alias the
+        /// inputs.
+        void toWGS(std::size_t n, const double *x, const double *y, const double *z, double *lon, double *lat,
+                   double *alt) const {
+            double ex[block], ey[block], ez[block];
+            for (std::size_t base = 0; base < n; base += block) {
+                const std::size_t m = std::min(block, n - base);
+                for (std::size_t i = 0; i < m; ++i) {
+                    const double e = x[base + i], nn = y[base + i], u = z[base + i];
+                    ex[i] = ox_ + r_[0] * e + r_[3] * nn + r_[6] * u;
+                    ey[i] = oy_ + r_[1] * e + r_[4] * nn + r_[7] * u;
+                    ez[i] = oz_ + r_[2] * e + r_[5] * nn + r_[8] * u;
+                }
+                // Heikkinen's closed form: no iteration, so every point costs the same
+                for (std::size_t i = 0; i < m; ++i) {
+                    const double X = ex[i], Y = ey[i], Z = ez[i];
+                    const double r2 = X * X + Y * Y, r = std::sqrt(r2), z2 = Z * Z;
+                    const double F = 54.0 * b2 * z2;
+                    const double G = r2 + (1.0 - e2) * z2 - e2 * (a * a - b2);
+                    const double c = e2 * e2 * F * r2 / (G * G * G);
+                    const double s = std::cbrt(1.0 + c + std::sqrt(c * c + 2.0 * c));
+                    const double k = s + 1.0 / s + 1.0;
+                    const double P = F / (3.0 * k * k * G * G);
+                    const double Q = std::sqrt(1.0 + 2.0 * e2 * e2 * P);
+                    const double r0 = -(P * e2 * r) / (1.0 + Q) +
+                                      std::sqrt(0.5 * a * a * (1.0 + 1.0 / Q) - P * (1.0 - e2) * z2 / (Q * (1.0 + Q)) -
+                                                0.5 * P * r2);
+                    const double t = r - e2 * r0;
+                    const double V = std::sqrt(t * t + (1.0 - e2) * z2);
+                    const double z0 = b2 * Z / (a * V);
+                    double phi = std::atan2(Z + ep2 * z0, r);
+                    // one fixed-point step polishes the last few ulps Heikkinen loses to cancellation
+                    double sp = std::sin(phi), cp = std::cos(phi);
+                    double N = a / std::sqrt(1.0 - e2 * sp * sp);
+                    double h = r * cp + Z * sp - N * (1.0 - e2 * sp * sp);
+                    phi = std::atan2(Z, r * (1.0 - e2 * N / (N + h)));
+                    sp = std::sin(phi), cp = std::cos(phi);
+                    N = a / std::sqrt(1.0 - e2 * sp * sp);
+                    alt[base + i] = r * cp + Z * sp - N * (1.0 - e2 * sp * sp);
+                    lat[base + i] = phi / deg;
+                    lon[base + i] = std::atan2(Y, X) / deg;
+                }
+            }
+        }
+
+        /// In place over points whose x/y/z hold lon/lat/alt; afterwards they hold ENU x/y/z.
+        void toENU(concord::Point *pts, std::size_t n) const {
+            op::StatTimer timer(&Stats::crs_ns);
+            double u[block], v[block], w[block];
+            for (std::size_t base = 0; base < n; base += block) {
+                const std::size_t m = std::min(block, n - base);
+                gather(pts + base, m, u, v, w);
+                toENU(m, u, v, w, u, v, w);
+                scatter(pts + base, m, u, v, w);
+            }
+        }
+
+        /// In place over ENU points; afterwards their x/y/z hold lon/lat/alt.
+        void toWGS(concord::Point *pts, std::size_t n) const {
+            op::StatTimer timer(&Stats::crs_ns);
+            double u[block], v[block], w[block];
+            for (std::size_t base = 0; base < n; base += block) {
+                const std::size_t m = std::min(block, n - base);
+                gather(pts + base, m, u, v, w);
+                toWGS(m, u, v, w, u, v, w);
+                scatter(pts + base, m, u, v, w);
+            }
+        }
+
+        /// In place over ENU points of this datum; afterwards they are ENU points of `to`'s datum. Both frames are
+        /// rigid (an ECEF origin and a rotation), so this is one exact affine map instead of a round trip through
+        /// geodetic coordinates.
+        void toFrame(const DatumTransform &to, concord::Point *pts, std::size_t n) const {
+            op::StatTimer timer(&Stats::crs_ns);
+            // enu' = R' (o + R^T enu - o') = M enu + t
+            double m[9], t[3];
+            const double d[3] = {ox_ - to.ox_, oy_ - to.oy_, oz_ - to.oz_};
+            for (int i = 0; i < 3; ++i) {
+                for (int k = 0; k < 3; ++k)
+                    m[3 * i + k] = to.r_[3 * i] * r_[3 * k] + to.r_[3 * i + 1] * r_[3 * k + 1] +
+                                   to.r_[3 * i + 2] * r_[3 * k + 2];
+                t[i] = to.r_[3 * i] * d[0] + to.r_[3 * i + 1] * d[1] + to.r_[3 * i + 2] * d[2];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                const double e = pts[i].x, nn = pts[i].y, u = pts[i].z;
+                pts[i].x = m[0] * e + m[1] * nn + m[2] * u + t[0];
+                pts[i].y = m[3] * e + m[4] * nn + m[5] * u + t[1];
+                pts[i].z = m[6] * e + m[7] * nn + m[8] * u + t[2];
+            }
+        }
+
+      private:
+        static constexpr std::size_t block = 64;
+        static constexpr std::size_t cache_size = 8;
+        static constexpr double deg = M_PI / 180.0;
+        // WGS84 ellipsoid
+        static constexpr double a = 6378137.0;
+        static constexpr double f = 1.0 / 298.257223563;
+        static constexpr double e2 = f * (2.0 - f);
+        static constexpr double b2 = a * a * (1.0 - e2);
+        static constexpr double ep2 = e2 / (1.0 - e2);
+
+        concord::Datum datum_;
+        double ox_, oy_, oz_;
+        double r_[9];
+
+        static void gather(const concord::Point *pts, std::size_t m, double *u, double *v, double *w) {
+            for (std::size_t i = 0; i < m; ++i) {
+                u[i] = pts[i].x;
+                v[i] = pts[i].y;
+                w[i] = pts[i].z;
+            }
+        }
+
+        static void scatter(concord::Point *pts, std::size_t m, const double *u, const double *v, const double *w) {
+            for (std::size_t i = 0; i < m; ++i) {
+                pts[i].x = u[i];
+                pts[i].y = v[i];
+                pts[i].z = w[i];
+            }
+        }
+    };
+
+} // namespace geoson
@@ -2,11 +2,15 @@
 
 #include "concord/concord.hpp" // for Datum, Euler, geometric types
 
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <unordered_map>
 #include <variant>
 #include <vector>
 
+#include "geoson/properties.hpp"
+
 namespace geoson {
     // Internal geometry representation: all coordinates are stored as Point (ENU/local system)
     // Regardless of input CRS, coordinates are converted to local coordinate system during parsing
@@ -17,7 +21,7 @@ namespace geoson {
 
     struct Feature {
         Geometry geometry;
-        std::unordered_map<std::string, std::string> properties;
+        Properties properties;
     };
 
     struct FeatureCollection {
@@ -27,4 +31,42 @@ namespace geoson {
         std::unordered_map<std::string, std::string> global_properties; // Global properties for the collection
     };
 
+    /// axis-aligned box over ENU coordinates; `empty()` until a point has been added
+    struct Bounds {
+        double min_x = std::numeric_limits<double>::infinity();
+        double min_y = std::numeric_limits<double>::infinity();
+        double min_z = std::numeric_limits<double>::infinity();
+        double max_x = -std::numeric_limits<double>::infinity();
+        double max_y = -std::numeric_limits<double>::infinity();
+        double max_z = -std::numeric_limits<double>::infinity();
+
+        bool empty() const { return min_x > max_x; }
+
+        void expand(const concord::Point &p) {
+            min_x = std::min(min_x, p.x);
+            min_y = std::min(min_y, p.y);
+            min_z = std::min(min_z, p.z);
+            max_x = std::max(max_x, p.x);
+            max_y = std::max(max_y, p.y);
+            max_z = std::max(max_z, p.z);
+        }
+
+        void expand(const Bounds &b) {
+            min_x = std::min(min_x, b.min_x);
+            min_y = std::min(min_y, b.min_y);
+            min_z = std::min(min_z, b.min_z);
+            max_x = std::max(max_x, b.max_x);
+            max_y = std::max(max_y, b.max_y);
+            max_z = std::max(max_z, b.max_z);
+        }
+    };
+
+    // Metadata carried by the top-level 'properties' object of a FeatureCollection
+    struct CollectionHeader {
+        CRS crs;
+        concord::Datum datum;
+        concord::Euler heading;
+        std::unordered_map<std::string, std::string> global_properties;
+    };
+
 } // namespace geoson
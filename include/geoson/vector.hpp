@@ -2,26 +2,569 @@
 
 #include "geoson.hpp"
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <optional>
+#include <ranges>
+#include <mutex>
 #include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 
 namespace geoson {
 
     struct Element {
         Geometry geometry;
-        std::unordered_map<std::string, std::string> properties;
+        Properties properties;
         std::string type;
 
-        Element(const Geometry &geom, const std::unordered_map<std::string, std::string> &props = {},
-                const std::string &elem_type = "")
-            : geometry(geom), properties(props), type(elem_type) {}
+        Element(Geometry geom, Properties props = {}, std::string elem_type = "")
+            : geometry(std::move(geom)), properties(std::move(props)), type(std::move(elem_type)) {}
     };
 
+    /// Stable reference to an element of a Vector, as returned by `addElement`. Unlike a position it survives
+    /// the removal of other elements; once its own element is removed it never matches again, even after the
+    /// slot is reused.
+    struct ElementHandle {
+        std::uint32_t slot = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t generation = 0;
+
+        bool operator==(const ElementHandle &) const = default;
+    };
+
+    /// Lazily filtered, non-owning range over a Vector's elements: yields `const Element &` for every element
+    /// that satisfies `Pred`, without copying or allocating. Valid until the Vector's elements change.
+    template <typename Pred> class ElementView : public std::ranges::view_interface<ElementView<Pred>> {
+      public:
+        class iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Element;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Element *;
+            using reference = const Element &;
+
+            iterator() = default;
+            iterator(const ElementView *view, std::size_t pos) : view_(view), pos_(pos) { skip(); }
+
+            reference operator*() const { return (*view_->elements_)[pos_]; }
+            pointer operator->() const { return &**this; }
+
+            /// position of the current element in the Vector, as taken by `getElement`
+            std::size_t index() const { return pos_; }
+
+            iterator &operator++() {
+                ++pos_;
+                skip();
+                return *this;
+            }
+            iterator operator++(int) {
+                iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const iterator &o) const { return pos_ == o.pos_; }
+
+          private:
+            const ElementView *view_ = nullptr;
+            std::size_t pos_ = 0;
+
+            void skip() {
+                while (pos_ < view_->elements_->size() && !view_->pred_((*view_->elements_)[pos_]))
+                    ++pos_;
+            }
+        };
+
+        ElementView(const std::vector<Element> &elements, Pred pred) : elements_(&elements), pred_(std::move(pred)) {}
+
+        iterator begin() const { return iterator{this, 0}; }
+        iterator end() const { return iterator{this, elements_->size()}; }
+
+        /// matching elements, counted with one pass
+        std::size_t count() const { return static_cast<std::size_t>(std::distance(begin(), end())); }
+
+      private:
+        const std::vector<Element> *elements_;
+        Pred pred_;
+    };
+
+    namespace op {
+        /// Hash index from `Element::type`, and from the text of chosen property keys, to element positions in
+        /// ascending order. Built on the first lookup and kept current from then on: appends, removals and
+        /// single-element edits each touch only the buckets of the elements involved. Every element remembers
+        /// where it sits in its buckets, so taking it out is a swap with the bucket's last entry; a bucket left out
+        /// of order that way is sorted again on its next lookup. Lookups are serialised, so concurrent const queries
+        /// are safe; copies keep the chosen keys and rebuild on first use.
+        class ElementIndex {
+          public:
+            ElementIndex() = default;
+            ElementIndex(const ElementIndex &other) : keys_(other.keys()) {}
+            ElementIndex &operator=(const ElementIndex &other) {
+                auto keys = other.keys();
+                std::lock_guard<std::mutex> lock(mutex_);
+                keys_ = std::move(keys);
+                valid_ = false;
+                return *this;
+            }
+
+            /// also index the text of property `key`
+            void watch(const std::string &key) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (std::find(keys_.begin(), keys_.end(), key) == keys_.end()) {
+                    keys_.push_back(key);
+                    valid_ = false;
+                }
+            }
+
+            bool watches(std::string_view key) const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return std::find(keys_.begin(), keys_.end(), key) != keys_.end();
+            }
+
+            /// `elements.back()` was just appended
+            void appended(const std::vector<Element> &elements) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (valid_)
+                    attach(elements.size() - 1, elements.back());
+            }
+
+            /// the element at `pos` may have a new type or new property values
+            void changed(std::size_t pos, const Element &e) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!valid_)
+                    return;
+                detach(pos);
+                attach(pos, e);
+            }
+
+            /// the element at `pos` was replaced by the last one
+            void swapRemoved(std::size_t pos) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!valid_)
+                    return;
+                const std::size_t last = count() - 1;
+                detach(pos);
+                if (pos != last)
+                    relabel(last, pos, false);
+                refs_.resize(last * stride());
+            }
+
+            /// the element at `pos` was erased and the later ones shifted down
+            void erased(std::size_t pos) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!valid_)
+                    return;
+                const std::size_t n = count();
+                detach(pos);
+                for (std::size_t i = pos + 1; i < n; ++i)
+                    relabel(i, i - 1, true);
+                refs_.resize((n - 1) * stride());
+            }
+
+            /// the elements at the positions flagged in `gone` were erased and the rest shifted down
+            void erasedIf(const std::vector<bool> &gone) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!valid_)
+                    return;
+                const std::size_t n = count();
+                for (std::size_t i = 0; i < n; ++i)
+                    if (gone[i])
+                        detach(i);
+                std::size_t out = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (gone[i])
+                        continue;
+                    if (out != i)
+                        relabel(i, out, true);
+                    ++out;
+                }
+                refs_.resize(out * stride());
+            }
+
+            void invalidate() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                valid_ = false;
+            }
+
+            std::vector<std::size_t> ofType(const std::vector<Element> &elements, const std::string &type) const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ensure(elements);
+                auto it = types_.find(type);
+                return it == types_.end() ? std::vector<std::size_t>{} : sorted(it->second);
+            }
+
+            /// only for watched keys
+            std::vector<std::size_t> withProperty(const std::vector<Element> &elements, const std::string &key,
+                                                  const std::string &value) const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ensure(elements);
+                auto by_key = props_.find(key);
+                if (by_key == props_.end())
+                    return {};
+                auto it = by_key->second.find(value);
+                return it == by_key->second.end() ? std::vector<std::size_t>{} : sorted(it->second);
+            }
+
+          private:
+            struct Bucket {
+                std::vector<std::size_t> pos;
+                std::size_t field = 0; // 0 for a type bucket, 1 + k for one of watched key k
+                bool ordered = true;
+            };
+            // where one element sits in one bucket; the maps are node-based, so bucket addresses are stable
+            struct Ref {
+                Bucket *bucket = nullptr;
+                std::size_t at = 0;
+            };
+
+            mutable std::mutex mutex_;
+            mutable bool valid_ = false;
+            std::vector<std::string> keys_;
+            mutable std::unordered_map<std::string, Bucket> types_;
+            mutable std::unordered_map<std::string, std::unordered_map<std::string, Bucket>> props_;
+            // per element: its type bucket, then its bucket for each watched key (none without the key)
+            mutable std::vector<Ref> refs_;
+
+            std::vector<std::string> keys() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return keys_;
+            }
+
+            std::size_t stride() const { return keys_.size() + 1; }
+            std::size_t count() const { return refs_.size() / stride(); }
+
+            void attach(std::size_t i, const Element &e) const {
+                if (refs_.size() < (i + 1) * stride())
+                    refs_.resize((i + 1) * stride());
+                auto add = [&](Bucket &b, std::size_t field) {
+                    b.field = field;
+                    if (!b.pos.empty() && b.pos.back() > i)
+                        b.ordered = false;
+                    refs_[i * stride() + field] = Ref{&b, b.pos.size()};
+                    b.pos.push_back(i);
+                };
+                add(types_[e.type], 0);
+                for (std::size_t k = 0; k < keys_.size(); ++k) {
+                    auto it = e.properties.find(keys_[k]);
+                    if (it != e.properties.end())
+                        add(props_[keys_[k]][it->second.str()], k + 1);
+                }
+            }
+
+            void detach(std::size_t i) const {
+                for (std::size_t f = 0; f < stride(); ++f) {
+                    Ref &ref = refs_[i * stride() + f];
+                    if (!ref.bucket)
+                        continue;
+                    auto &pos = ref.bucket->pos;
+                    if (ref.at + 1 != pos.size()) {
+                        pos[ref.at] = pos.back();
+                        refs_[pos[ref.at] * stride() + f].at = ref.at;
+                        ref.bucket->ordered = false;
+                    }
+                    pos.pop_back();
+                    ref = Ref{};
+                }
+            }
+
+            /// the (attached) element at `from` now lives at the detached position `to`
+            void relabel(std::size_t from, std::size_t to, bool keeps_order) const {
+                for (std::size_t f = 0; f < stride(); ++f) {
+                    Ref &ref = refs_[from * stride() + f];
+                    if (ref.bucket) {
+                        ref.bucket->pos[ref.at] = to;
+                        ref.bucket->ordered = ref.bucket->ordered && keeps_order;
+                    }
+                    refs_[to * stride() + f] = ref;
+                    ref = Ref{};
+                }
+            }
+
+            std::vector<std::size_t> sorted(Bucket &b) const {
+                if (!b.ordered) {
+                    std::sort(b.pos.begin(), b.pos.end());
+                    for (std::size_t j = 0; j < b.pos.size(); ++j)
+                        refs_[b.pos[j] * stride() + b.field].at = j;
+                    b.ordered = true;
+                }
+                return b.pos;
+            }
+
+            void ensure(const std::vector<Element> &elements) const {
+                if (valid_)
+                    return;
+                types_.clear();
+                props_.clear();
+                refs_.assign(elements.size() * stride(), Ref{});
+                for (std::size_t i = 0; i < elements.size(); ++i)
+                    attach(i, elements[i]);
+                valid_ = true;
+            }
+        };
+
+        /// Slot map from ElementHandle to element position. Each live slot knows its element's position and each
+        /// position its slot, so lookups and swap-with-last removals are O(1). Freed slots are reused with a
+        /// bumped generation, which is what makes old handles to them stale.
+        class HandleTable {
+          public:
+            /// handle for an element just appended at position `size()`
+            ElementHandle push() {
+                std::uint32_t slot;
+                if (free_.empty()) {
+                    slot = static_cast<std::uint32_t>(slots_.size());
+                    slots_.emplace_back();
+                } else {
+                    slot = free_.back();
+                    free_.pop_back();
+                }
+                slots_[slot].pos = owners_.size();
+                owners_.push_back(slot);
+                return {slot, slots_[slot].generation};
+            }
+
+            std::optional<std::size_t> find(ElementHandle h) const {
+                if (h.slot >= slots_.size() || slots_[h.slot].generation != h.generation ||
+                    slots_[h.slot].pos == npos)
+                    return std::nullopt;
+                return slots_[h.slot].pos;
+            }
+
+            ElementHandle at(std::size_t pos) const { return {owners_[pos], slots_[owners_[pos]].generation}; }
+
+            std::size_t size() const { return owners_.size(); }
+
+            /// the element at `pos` was replaced by the last one
+            void swapRemove(std::size_t pos) {
+                release(owners_[pos]);
+                if (pos + 1 != owners_.size()) {
+                    owners_[pos] = owners_.back();
+                    slots_[owners_[pos]].pos = pos;
+                }
+                owners_.pop_back();
+            }
+
+            /// the element at `pos` was erased and the later ones shifted down
+            void erase(std::size_t pos) {
+                release(owners_[pos]);
+                owners_.erase(owners_.begin() + static_cast<std::ptrdiff_t>(pos));
+                for (std::size_t i = pos; i < owners_.size(); ++i)
+                    slots_[owners_[i]].pos = i;
+            }
+
+            /// the elements at the positions flagged in `gone` were erased and the rest shifted down, in one pass
+            void eraseIf(const std::vector<bool> &gone) {
+                std::size_t out = 0;
+                for (std::size_t i = 0; i < owners_.size(); ++i) {
+                    if (gone[i]) {
+                        release(owners_[i]);
+                        continue;
+                    }
+                    owners_[out] = owners_[i];
+                    slots_[owners_[out]].pos = out;
+                    ++out;
+                }
+                owners_.resize(out);
+            }
+
+            void clear() {
+                for (auto slot : owners_)
+                    release(slot);
+                owners_.clear();
+            }
+
+          private:
+            static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+            struct Slot {
+                std::size_t pos = npos;
+                std::uint32_t generation = 0;
+            };
+
+            std::vector<Slot> slots_;
+            std::vector<std::uint32_t> owners_; // position -> slot
+            std::vector<std::uint32_t> free_;
+
+            void release(std::uint32_t slot) {
+                slots_[slot].pos = npos;
+                ++slots_[slot].generation;
+                free_.push_back(slot);
+            }
+        };
+
+        /// The R-tree behind Vector's spatial queries, kept usable while elements come and go. The packed tree is
+        /// built on the first query over the elements as they are then, with each entry tagged by its element's
+        /// handle, which swap-removal does not change. After that, a removed element only tombstones its entry,
+        /// and an added one goes to a short side list that queries scan linearly. An edited element does both.
+        /// Once tombstones or side entries outgrow a fraction of the elements the tree is dropped and packed again
+        /// on the next query, so a stream of changes costs amortised O(log n) each instead of a rebuild apiece.
+        /// Building is serialised, so concurrent const queries are safe; copies start empty.
+        class ElementTree {
+          public:
+            ElementTree() = default;
+            ElementTree(const ElementTree &) {}
+            ElementTree &operator=(const ElementTree &) {
+                reset();
+                return *this;
+            }
+
+            void reset() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                drop();
+            }
+
+            /// element `h` was just added
+            void added(ElementHandle h, const Geometry &geometry) {
+                if (!built_)
+                    return;
+                const Bounds box = bounds(geometry);
+                if (!box.empty())
+                    extra_.push_back({box, h});
+                settle();
+            }
+
+            /// element `h` is about to be removed
+            void removed(ElementHandle h) {
+                if (!built_)
+                    return;
+                forget(h);
+                settle();
+            }
+
+            /// element `h` has a new geometry
+            void changed(ElementHandle h, const Geometry &geometry) {
+                if (!built_)
+                    return;
+                forget(h);
+                added(h, geometry);
+            }
+
+            /// calls `fn(pos)` for every element whose box overlaps [min_x, max_x] x [min_y, max_y]
+            template <typename Fn>
+            void search(const std::vector<Element> &elements, const HandleTable &handles, double min_x, double min_y,
+                        double max_x, double max_y, Fn &&fn) const {
+                ensure(elements, handles);
+                tree_.search(min_x, min_y, max_x, max_y, [&](std::size_t id) {
+                    if (!dead_[id])
+                        fn(*handles.find(owners_[id]));
+                });
+                for (auto const &[box, h] : extra_)
+                    if (box.min_x <= max_x && box.max_x >= min_x && box.min_y <= max_y && box.max_y >= min_y)
+                        fn(*handles.find(h));
+            }
+
+            /// positions of up to `k` elements by increasing `dist(pos)`, as SpatialIndex::nearest
+            template <typename Dist>
+            std::vector<std::size_t> nearest(const std::vector<Element> &elements, const HandleTable &handles,
+                                             double x, double y, std::size_t k, Dist &&dist) const {
+                ensure(elements, handles);
+                auto ids = tree_.nearest(x, y, k, [&](std::size_t id) {
+                    return dead_[id] ? std::numeric_limits<double>::infinity() : dist(*handles.find(owners_[id]));
+                });
+                std::vector<std::size_t> out;
+                out.reserve(ids.size());
+                for (std::size_t id : ids)
+                    out.push_back(*handles.find(owners_[id]));
+                if (extra_.empty() || k == 0)
+                    return out;
+
+                std::vector<std::pair<double, std::size_t>> hits;
+                hits.reserve(out.size() + extra_.size());
+                for (std::size_t pos : out)
+                    hits.emplace_back(dist(pos), pos);
+                for (auto const &entry : extra_) {
+                    const std::size_t pos = *handles.find(entry.handle);
+                    hits.emplace_back(dist(pos), pos);
+                }
+                std::stable_sort(hits.begin(), hits.end(), [](auto &a, auto &b) { return a.first < b.first; });
+                hits.resize(std::min(hits.size(), k));
+                out.clear();
+                for (auto const &hit : hits)
+                    out.push_back(hit.second);
+                return out;
+            }
+
+          private:
+            static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+            struct Extra {
+                Bounds box;
+                ElementHandle handle;
+            };
+
+            mutable std::mutex mutex_;
+            mutable bool built_ = false;
+            mutable SpatialIndex tree_;
+            mutable std::vector<ElementHandle> owners_;  // tree entry id -> element
+            mutable std::vector<std::size_t> entry_of_; // handle slot -> tree entry id, npos once gone
+            mutable std::vector<bool> dead_;            // tree entry id -> tombstoned
+            mutable std::size_t dead_count_ = 0;
+            mutable std::vector<Extra> extra_; // added since the tree was packed
+
+            void drop() const {
+                built_ = false;
+                tree_ = SpatialIndex{};
+                owners_.clear();
+                entry_of_.clear();
+                dead_.clear();
+                dead_count_ = 0;
+                extra_.clear();
+            }
+
+            void forget(ElementHandle h) {
+                if (h.slot < entry_of_.size() && entry_of_[h.slot] != npos) {
+                    dead_[entry_of_[h.slot]] = true;
+                    entry_of_[h.slot] = npos;
+                    ++dead_count_;
+                    return;
+                }
+                auto it = std::find_if(extra_.begin(), extra_.end(), [&](const Extra &e) { return e.handle == h; });
+                if (it != extra_.end()) {
+                    *it = extra_.back();
+                    extra_.pop_back();
+                }
+            }
+
+            /// repack on the next query once the tree has drifted too far from the elements
+            void settle() {
+                const std::size_t live = owners_.size() - dead_count_ + extra_.size();
+                const std::size_t slack = 64 + live / 16;
+                if (dead_count_ > slack || extra_.size() > slack)
+                    drop();
+            }
+
+            void ensure(const std::vector<Element> &elements, const HandleTable &handles) const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (built_)
+                    return;
+                std::vector<Bounds> boxes;
+                boxes.reserve(elements.size());
+                owners_.resize(elements.size());
+                std::uint32_t slots = 0;
+                for (std::size_t i = 0; i < elements.size(); ++i) {
+                    boxes.push_back(bounds(elements[i].geometry));
+                    owners_[i] = handles.at(i);
+                    slots = std::max(slots, owners_[i].slot + 1);
+                }
+                entry_of_.assign(slots, npos);
+                for (std::size_t i = 0; i < elements.size(); ++i)
+                    entry_of_[owners_[i].slot] = i;
+                dead_.assign(elements.size(), false);
+                tree_ = SpatialIndex(boxes);
+                built_ = true;
+            }
+        };
+    } // namespace op
+
     class Vector {
       private:
         concord::Polygon field_boundary_;
-        std::unordered_map<std::string, std::string> field_properties_;
+        Properties field_properties_;
         std::vector<Element> elements_;
 
         concord::Datum datum_;
@@ -31,98 +574,217 @@ namespace geoson {
         // Global properties for the entire vector collection
         std::unordered_map<std::string, std::string> global_properties_;
 
-      public:
-        Vector() = delete;
+        // R-tree over the element boxes; built on the first spatial query, then updated element by element
+        op::ElementTree spatial_;
+        // Type/property lookups; updated element by element once built
+        op::ElementIndex index_;
+        // ElementHandle -> position, kept in step with elements_
+        op::HandleTable handles_;
 
-        explicit Vector(const concord::Polygon &field_boundary,
-                        const concord::Datum &datum = concord::Datum{0.001, 0.001, 1.0},
-                        const concord::Euler &heading = concord::Euler{0, 0, 0}, CRS crs = CRS::ENU)
-            : field_boundary_(field_boundary), datum_(datum), heading_(heading), crs_(crs) {}
+        /// the element at `pos` was edited in place
+        void elementChanged(size_t pos) {
+            spatial_.changed(handles_.at(pos), elements_[pos].geometry);
+            index_.changed(pos, elements_[pos]);
+        }
 
-        static Vector fromFile(const std::filesystem::path &path) {
-            auto fc = geoson::read(path);
+        /// a reference handed out may change anything about any element, so both indexes start over
+        void elementsChanged() {
+            spatial_.reset();
+            index_.invalidate();
+        }
 
-            if (fc.features.empty()) {
-                throw std::runtime_error("Vector::fromFile: No features found in file");
+        template <typename Fn> void modifyAt(size_t pos, Fn &fn) {
+            try {
+                fn(elements_[pos]);
+            } catch (...) {
+                elementChanged(pos); // whatever `fn` got done before it threw
+                throw;
             }
+            elementChanged(pos);
+        }
+
+        template <typename... Args> ElementHandle append(Args &&...args) {
+            elements_.emplace_back(std::forward<Args>(args)...);
+            const ElementHandle handle = handles_.push();
+            spatial_.added(handle, elements_.back().geometry);
+            index_.appended(elements_);
+            return handle;
+        }
 
-            std::optional<std::pair<concord::Polygon, std::unordered_map<std::string, std::string>>> field_data;
+        /// the "type" key, interned once so lookups compare pointers
+        static const PropertyKey &typeKey() {
+            static const PropertyKey key("type");
+            return key;
+        }
 
-            // First, look for a feature explicitly marked as "field"
-            for (const auto &feature : fc.features) {
-                if (std::holds_alternative<concord::Polygon>(feature.geometry)) {
-                    auto it = feature.properties.find("type");
-                    if (it != feature.properties.end() && it->second == "field") {
-                        field_data = std::make_pair(std::get<concord::Polygon>(feature.geometry), feature.properties);
-                        break;
+        /// element type for a feature whose "type" property was found at `it` ("unknown" without one)
+        static std::string elementType(const Properties &props, Properties::const_iterator it) {
+            return it != props.end() ? it->second.str() : "unknown";
+        }
+
+        static Element elementFrom(Feature &&feature) {
+            std::string type = elementType(feature.properties, feature.properties.find(typeKey()));
+            return Element(std::move(feature.geometry), std::move(feature.properties), std::move(type));
+        }
+
+        /// One pass over the features `next(Feature &)` hands out, with a single "type" lookup per feature: the
+        /// field boundary is taken as soon as it shows up, and the first plain polygon is remembered as the
+        /// fallback in case none does.
+        template <typename Next>
+        static Vector build(const concord::Datum &datum, const concord::Euler &heading, size_t size_hint,
+                            Next &&next) {
+            Vector vector(concord::Polygon{}, datum, heading);
+            vector.elements_.reserve(size_hint);
+            bool any = false, explicit_field = false;
+            std::optional<size_t> first_polygon;
+
+            Feature feature;
+            while (next(feature)) {
+                any = true;
+                const bool polygon = std::holds_alternative<concord::Polygon>(feature.geometry);
+                auto type_it = feature.properties.find(typeKey());
+                if (type_it != feature.properties.end() && type_it->second == "field") {
+                    if (polygon && !explicit_field) {
+                        vector.field_boundary_ = std::get<concord::Polygon>(std::move(feature.geometry));
+                        vector.field_properties_ = std::move(feature.properties);
+                        explicit_field = true;
                     }
+                    continue;
                 }
+                if (polygon && !first_polygon)
+                    first_polygon = vector.elements_.size();
+                std::string type = elementType(feature.properties, type_it);
+                vector.append(std::move(feature.geometry), std::move(feature.properties), std::move(type));
             }
 
-            // If no explicit field found, use the first polygon
-            if (!field_data) {
-                for (const auto &feature : fc.features) {
-                    if (std::holds_alternative<concord::Polygon>(feature.geometry)) {
-                        field_data = std::make_pair(std::get<concord::Polygon>(feature.geometry), feature.properties);
-                        break;
-                    }
+            if (!any) {
+                throw std::runtime_error("Vector::fromFile: No features found in file");
+            }
+            if (!explicit_field) {
+                if (!first_polygon) {
+                    throw std::runtime_error("Vector::fromFile: No polygon found to use as field boundary");
                 }
+                // the fallback stays an element too, so it is copied
+                const auto &fallback = vector.elements_[*first_polygon];
+                vector.field_boundary_ = std::get<concord::Polygon>(fallback.geometry);
+                vector.field_properties_ = fallback.properties;
             }
+            return vector;
+        }
 
-            if (!field_data) {
-                throw std::runtime_error("Vector::fromFile: No polygon found to use as field boundary");
-            }
+        size_t positionOf(ElementHandle handle) const {
+            auto pos = handles_.find(handle);
+            if (!pos)
+                throw std::out_of_range("Element handle is no longer valid");
+            return *pos;
+        }
 
-            Vector vector(field_data->first, fc.datum, fc.heading);
-            vector.field_properties_ = field_data->second;
-            vector.global_properties_ = fc.global_properties;
+        std::vector<Element> elementsAt(const std::vector<size_t> &indices) const {
+            std::vector<Element> result;
+            result.reserve(indices.size());
+            for (size_t i : indices)
+                result.push_back(elements_[i]);
+            return result;
+        }
 
-            // Add all other features as elements (exclude the field boundary)
-            for (const auto &feature : fc.features) {
-                // Skip features that are explicitly marked as "field" type
-                auto type_it = feature.properties.find("type");
-                bool isExplicitField = (type_it != feature.properties.end() && type_it->second == "field");
+        template <typename T> auto viewHolding() const {
+            return view([](const Element &e) { return std::holds_alternative<T>(e.geometry); });
+        }
 
-                if (!isExplicitField) {
-                    std::string elem_type = "unknown";
-                    if (type_it != feature.properties.end()) {
-                        elem_type = type_it->second;
-                    }
+        template <typename View> static std::vector<Element> collect(const View &v) {
+            return std::vector<Element>(v.begin(), v.end());
+        }
 
-                    vector.elements_.emplace_back(feature.geometry, feature.properties, elem_type);
-                }
-            }
+      public:
+        Vector() = delete;
+
+        explicit Vector(concord::Polygon field_boundary,
+                        const concord::Datum &datum = concord::Datum{0.001, 0.001, 1.0},
+                        const concord::Euler &heading = concord::Euler{0, 0, 0}, CRS crs = CRS::ENU)
+            : field_boundary_(std::move(field_boundary)), datum_(datum), heading_(heading), crs_(crs) {}
 
+        /// Builds the Vector straight from the feature stream: no FeatureCollection is materialised, and each
+        /// feature is looked at once (see `fromFeatureCollection` for how the field boundary is picked).
+        static Vector fromFile(const std::filesystem::path &path) {
+            op::StatTimer timer(&Stats::read_ns);
+            op::KeyScope keys;
+            FeatureReader reader(path);
+            auto vector = build(reader.header().datum, reader.header().heading, 0,
+                                [&](Feature &feature) { return reader.next(feature); });
+            vector.global_properties_ = reader.header().global_properties;
+            return vector;
+        }
+
+        /// Field boundary: the first polygon typed "field", else the first polygon. Features typed "field" are
+        /// dropped and every other one becomes an element; their geometries and properties are moved, not copied.
+        static Vector fromFeatureCollection(FeatureCollection &&fc) {
+            size_t i = 0;
+            auto vector = build(fc.datum, fc.heading, fc.features.size(), [&](Feature &feature) {
+                if (i == fc.features.size())
+                    return false;
+                feature = std::move(fc.features[i++]);
+                return true;
+            });
+            vector.global_properties_ = std::move(fc.global_properties);
             return vector;
         }
 
-        void toFile(const std::filesystem::path &path, CRS outputCrs = CRS::ENU) const {
-            FeatureCollection fc;
-            fc.datum = datum_;
-            fc.heading = heading_;
-            fc.global_properties = global_properties_;
+        static Vector fromFeatureCollection(const FeatureCollection &fc) {
+            return fromFeatureCollection(FeatureCollection(fc));
+        }
+
+        /// streams the field boundary and the elements straight to the file, without a temporary FeatureCollection
+        void toFile(const std::filesystem::path &path, CRS outputCrs = CRS::ENU, const WriteOptions &opts = {}) const {
+            std::ofstream ofs(path, std::ios::binary);
+            if (!ofs)
+                throw std::runtime_error("Cannot open for write: " + path.string());
 
             auto field_props = field_properties_;
             field_props["type"] = "field";
-            fc.features.emplace_back(Feature{field_boundary_, field_props});
 
-            for (const auto &element : elements_) {
-                fc.features.emplace_back(Feature{element.geometry, element.properties});
-            }
+            op::OutputBuffer out(ofs);
+            op::JsonEmitter e(out, opts.indent);
+            op::emitCollection(e, datum_, heading_, global_properties_, outputCrs, opts, [&](auto &&emit) {
+                emit(field_boundary_, field_props);
+                for (const auto &element : elements_)
+                    emit(element.geometry, element.properties);
+            });
+            out.put('\n');
+        }
 
-            geoson::write(fc, path, outputCrs);
+        /// the same features `toFile` writes (field boundary first), laid out as coordinate columns
+        ColumnarCollection toColumnar() const {
+            ColumnarCollection cc;
+            cc.datum = datum_;
+            cc.heading = heading_;
+            cc.global_properties = global_properties_;
+            cc.reserve(elements_.size() + 1, 0);
+
+            auto field_props = field_properties_;
+            field_props["type"] = "field";
+            cc.push_back(field_boundary_, std::move(field_props));
+            for (const auto &element : elements_)
+                cc.push_back(element.geometry, element.properties);
+            return cc;
         }
 
         const concord::Polygon &getFieldBoundary() const { return field_boundary_; }
         void setFieldBoundary(const concord::Polygon &boundary) { field_boundary_ = boundary; }
 
-        const std::unordered_map<std::string, std::string> &getFieldProperties() const { return field_properties_; }
-        void setFieldProperty(const std::string &key, const std::string &value) { field_properties_[key] = value; }
+        const Properties &getFieldProperties() const { return field_properties_; }
+        void setFieldProperty(const std::string &key, PropertyValue value) {
+            field_properties_[key] = std::move(value);
+        }
         void removeFieldProperty(const std::string &key) { field_properties_.erase(key); }
 
         size_t elementCount() const { return elements_.size(); }
         bool hasElements() const { return !elements_.empty(); }
-        void clearElements() { elements_.clear(); }
+        void clearElements() {
+            elements_.clear();
+            handles_.clear();
+            spatial_.reset();
+            index_.invalidate();
+        }
 
         const Element &getElement(size_t index) const {
             if (index >= elements_.size())
@@ -130,106 +792,294 @@ namespace geoson {
             return elements_[index];
         }
 
+        const Element &getElement(ElementHandle handle) const { return elements_[positionOf(handle)]; }
+
+        /// Mutable access may change anything about the element, so it drops the spatial and type indexes, which
+        /// are rebuilt on the next query. `modifyElement` updates them for the one element instead.
         Element &getElement(size_t index) {
             if (index >= elements_.size())
                 throw std::out_of_range("Element index out of range");
+            elementsChanged();
+            return elements_[index];
+        }
+
+        Element &getElement(ElementHandle handle) {
+            const size_t index = positionOf(handle);
+            elementsChanged();
             return elements_[index];
         }
 
-        void addElement(const Geometry &geometry, const std::string &type = "",
-                        const std::unordered_map<std::string, std::string> &properties = {}) {
-            auto props = properties;
+        /// Edits one element through `fn(Element &)`, then brings the indexes up to date for that element alone:
+        /// the cheap way to change a few elements of an indexed Vector.
+        template <typename Fn> void modifyElement(size_t index, Fn &&fn) {
+            if (index >= elements_.size())
+                throw std::out_of_range("Element index out of range");
+            modifyAt(index, fn);
+        }
+
+        template <typename Fn> void modifyElement(ElementHandle handle, Fn &&fn) { modifyAt(positionOf(handle), fn); }
+
+        /// true while the element `handle` refers to has not been removed
+        bool contains(ElementHandle handle) const { return handles_.find(handle).has_value(); }
+
+        /// current position of the element, as taken by getElement(size_t); nullopt once it was removed
+        std::optional<size_t> indexOf(ElementHandle handle) const { return handles_.find(handle); }
+
+        ElementHandle handleAt(size_t index) const {
+            if (index >= elements_.size())
+                throw std::out_of_range("Element index out of range");
+            return handles_.at(index);
+        }
+
+        ElementHandle addElement(Geometry geometry, const std::string &type = "", Properties properties = {}) {
             if (!type.empty()) {
-                props["type"] = type;
+                properties["type"] = type;
+            }
+            return append(std::move(geometry), std::move(properties), type);
+        }
+
+        ElementHandle addElement(Element element) { return append(std::move(element)); }
+
+        /// typed like the elements of `fromFeatureCollection`
+        ElementHandle addElement(Feature feature) { return append(elementFrom(std::move(feature))); }
+
+        /// Appends every Element or Feature of `range`, moving them out when the range is passed as an rvalue.
+        /// Handles come back in range order.
+        template <std::ranges::input_range R> std::vector<ElementHandle> addElements(R &&range) {
+            std::vector<ElementHandle> handles;
+            if constexpr (std::ranges::sized_range<R>) {
+                elements_.reserve(elements_.size() + std::ranges::size(range));
+                handles.reserve(std::ranges::size(range));
+            }
+            for (auto &&item : range) {
+                if constexpr (std::is_lvalue_reference_v<R>)
+                    handles.push_back(addElement(item));
+                else
+                    handles.push_back(addElement(std::move(item)));
             }
-            elements_.emplace_back(geometry, props, type);
+            return handles;
         }
 
+        /// keeps the order of the remaining elements, so it shifts every later one: O(n)
         void removeElement(size_t index) {
             if (index < elements_.size()) {
+                spatial_.removed(handles_.at(index));
                 elements_.erase(elements_.begin() + index);
+                handles_.erase(index);
+                index_.erased(index);
+            }
+        }
+
+        /// O(1): the last element moves into the freed position (its handle still finds it). Returns false when
+        /// the handle was already stale.
+        bool removeElement(ElementHandle handle) {
+            auto pos = handles_.find(handle);
+            if (!pos)
+                return false;
+            spatial_.removed(handle);
+            if (*pos + 1 != elements_.size())
+                elements_[*pos] = std::move(elements_.back());
+            elements_.pop_back();
+            handles_.swapRemove(*pos);
+            index_.swapRemoved(*pos);
+            return true;
+        }
+
+        /// Replays a patch made by `diff` against the collection this Vector writes (see `toFile`): the field boundary
+        /// is the feature typed "field" and every element one feature. Elements are edited or erased in place
+        /// (handles to the others stay valid) and added features appended, except polygons typed "field": the first
+        /// one replaces a removed boundary, the rest are dropped as in `fromFile`. The indexes are updated for the
+        /// patched elements alone. Throws, leaving the Vector untouched, when the patch names a feature the Vector
+        /// does not have or would leave it without a field boundary.
+        void applyPatch(const FeaturePatch &patch) {
+            constexpr const char *who = "geoson::Vector::applyPatch()";
+            constexpr size_t field = std::numeric_limits<size_t>::max();
+
+            auto field_props = field_properties_;
+            field_props["type"] = "field";
+            op::FeatureIds ids(patch.id_key);
+            std::unordered_map<std::string, size_t> where;
+            where.reserve(elements_.size() + 1);
+            where.emplace(ids.next(field_boundary_, field_props), field);
+            for (size_t i = 0; i < elements_.size(); ++i)
+                where.emplace(ids.next(elements_[i].geometry, elements_[i].properties), i);
+
+            auto isField = [](const Geometry &geometry, const Properties &props) {
+                auto it = props.find(typeKey());
+                return std::holds_alternative<concord::Polygon>(geometry) && it != props.end() && it->second == "field";
+            };
+
+            std::vector<size_t> changed;
+            changed.reserve(patch.modified.size());
+            for (auto const &change : patch.modified) {
+                changed.push_back(op::patchTarget(where, change.id, who));
+                if (changed.back() == field && change.geometry &&
+                    !std::holds_alternative<concord::Polygon>(*change.geometry))
+                    throw std::runtime_error(std::string(who) + ": the field boundary must stay a polygon");
+            }
+            std::vector<bool> gone(elements_.size(), false);
+            bool field_gone = false;
+            for (auto const &id : patch.removed) {
+                size_t pos = op::patchTarget(where, id, who);
+                if (pos == field)
+                    field_gone = true;
+                else
+                    gone[pos] = true;
             }
+            const Feature *new_field = nullptr; // as in `build`, only the first field polygon counts
+            for (auto const &feature : patch.added)
+                if (field_gone && !new_field && isField(feature.geometry, feature.properties))
+                    new_field = &feature;
+            if (field_gone && !new_field)
+                throw std::runtime_error(std::string(who) + ": patch removes the field boundary");
+
+            for (size_t k = 0; k < changed.size(); ++k) {
+                if (changed[k] == field) {
+                    Geometry boundary = field_boundary_;
+                    op::applyChange(boundary, field_props, patch.modified[k]);
+                    field_boundary_ = std::get<concord::Polygon>(std::move(boundary));
+                    field_properties_ = field_props; // "type": "field" included, as `build` keeps it
+                    continue;
+                }
+                Element &element = elements_[changed[k]];
+                op::applyChange(element.geometry, element.properties, patch.modified[k]);
+                element.type = elementType(element.properties, element.properties.find(typeKey()));
+                elementChanged(changed[k]);
+            }
+            if (std::find(gone.begin(), gone.end(), true) != gone.end()) {
+                for (size_t i = 0; i < elements_.size(); ++i)
+                    if (gone[i])
+                        spatial_.removed(handles_.at(i));
+                size_t out = 0;
+                for (size_t i = 0; i < elements_.size(); ++i) {
+                    if (gone[i])
+                        continue;
+                    if (out != i)
+                        elements_[out] = std::move(elements_[i]);
+                    ++out;
+                }
+                elements_.erase(elements_.begin() + static_cast<std::ptrdiff_t>(out), elements_.end());
+                handles_.eraseIf(gone);
+                index_.erasedIf(gone);
+            }
+
+            for (auto const &feature : patch.added) {
+                if (&feature == new_field) {
+                    field_boundary_ = std::get<concord::Polygon>(feature.geometry);
+                    field_properties_ = feature.properties;
+                } else if (!isField(feature.geometry, feature.properties)) {
+                    append(elementFrom(Feature(feature)));
+                }
+            }
+            op::applyHeader(patch, datum_, heading_, global_properties_);
         }
 
-        void addPoint(const concord::Point &point, const std::string &type = "point",
-                      const std::unordered_map<std::string, std::string> &properties = {}) {
-            addElement(point, type, properties);
+        ElementHandle addPoint(const concord::Point &point, const std::string &type = "point",
+                               Properties properties = {}) {
+            return addElement(point, type, std::move(properties));
         }
 
-        void addLine(const concord::Line &line, const std::string &type = "line",
-                     const std::unordered_map<std::string, std::string> &properties = {}) {
-            addElement(line, type, properties);
+        ElementHandle addLine(const concord::Line &line, const std::string &type = "line",
+                              Properties properties = {}) {
+            return addElement(line, type, std::move(properties));
         }
 
-        void addPath(const concord::Path &path, const std::string &type = "path",
-                     const std::unordered_map<std::string, std::string> &properties = {}) {
-            addElement(path, type, properties);
+        ElementHandle addPath(const concord::Path &path, const std::string &type = "path",
+                              Properties properties = {}) {
+            return addElement(path, type, std::move(properties));
         }
 
-        void addPolygon(const concord::Polygon &polygon, const std::string &type = "polygon",
-                        const std::unordered_map<std::string, std::string> &properties = {}) {
-            addElement(polygon, type, properties);
+        ElementHandle addPolygon(const concord::Polygon &polygon, const std::string &type = "polygon",
+                                 Properties properties = {}) {
+            return addElement(polygon, type, std::move(properties));
         }
 
+        // Views: filter lazily and hand out references into the Vector; they stay valid until elements change.
+        // The get* functions below return copies of the same elements.
+
+        auto viewElementsByType(std::string type) const {
+            return view([type = std::move(type)](const Element &e) { return e.type == type; });
+        }
+        auto viewPoints() const { return viewHolding<concord::Point>(); }
+        auto viewLines() const { return viewHolding<concord::Line>(); }
+        auto viewPaths() const { return viewHolding<concord::Path>(); }
+        auto viewPolygons() const { return viewHolding<concord::Polygon>(); }
+
+        auto viewByProperty(std::string key, std::string value) const {
+            return view([key = std::move(key), value = std::move(value)](const Element &e) {
+                auto it = e.properties.find(key);
+                return it != e.properties.end() && it->second == value;
+            });
+        }
+
+        /// elements satisfying `pred(const Element &)`
+        template <typename Pred> ElementView<Pred> view(Pred pred) const {
+            return ElementView<Pred>(elements_, std::move(pred));
+        }
+
+        /// served from the type index: cost follows the number of matches, not of elements
         std::vector<Element> getElementsByType(const std::string &type) const {
-            std::vector<Element> result;
-            for (const auto &element : elements_) {
-                if (element.type == type) {
-                    result.push_back(element);
-                }
-            }
-            return result;
+            return elementsAt(index_.ofType(elements_, type));
         }
+        std::vector<Element> getPoints() const { return collect(viewPoints()); }
+        std::vector<Element> getLines() const { return collect(viewLines()); }
+        std::vector<Element> getPaths() const { return collect(viewPaths()); }
+        std::vector<Element> getPolygons() const { return collect(viewPolygons()); }
 
-        std::vector<Element> getPoints() const {
-            std::vector<Element> result;
-            for (const auto &element : elements_) {
-                if (std::holds_alternative<concord::Point>(element.geometry)) {
-                    result.push_back(element);
-                }
-            }
-            return result;
+        /// served from the index when `key` is indexed (see `indexProperty`), a scan otherwise
+        std::vector<Element> filterByProperty(const std::string &key, const std::string &value) const {
+            if (index_.watches(key))
+                return elementsAt(index_.withProperty(elements_, key, value));
+            return collect(viewByProperty(key, value));
         }
 
-        std::vector<Element> getLines() const {
-            std::vector<Element> result;
-            for (const auto &element : elements_) {
-                if (std::holds_alternative<concord::Line>(element.geometry)) {
-                    result.push_back(element);
-                }
-            }
+        // Index lookups: positions as taken by getElement, ascending
+
+        std::vector<size_t> indicesOfType(const std::string &type) const { return index_.ofType(elements_, type); }
+
+        std::vector<size_t> indicesWithProperty(const std::string &key, const std::string &value) const {
+            if (index_.watches(key))
+                return index_.withProperty(elements_, key, value);
+            std::vector<size_t> result;
+            auto v = viewByProperty(key, value);
+            for (auto it = v.begin(); it != v.end(); ++it)
+                result.push_back(it.index());
             return result;
         }
 
-        std::vector<Element> getPaths() const {
-            std::vector<Element> result;
-            for (const auto &element : elements_) {
-                if (std::holds_alternative<concord::Path>(element.geometry)) {
-                    result.push_back(element);
-                }
-            }
+        /// keep a hash index on the values (compared as text) of property `key`, for filterByProperty
+        void indexProperty(const std::string &key) { index_.watch(key); }
+
+        // Spatial queries (planar x/y, ENU metres). The first query builds an R-tree over the element bounding
+        // boxes, which adding, removing and modifying elements then update in place. Empty geometries never match.
+
+        /// indices of elements whose bounding box overlaps the box spanned by `lo` and `hi`, ascending
+        std::vector<size_t> elementsInBox(const concord::Point &lo, const concord::Point &hi) const {
+            std::vector<size_t> result;
+            spatial_.search(elements_, handles_, std::min(lo.x, hi.x), std::min(lo.y, hi.y), std::max(lo.x, hi.x),
+                            std::max(lo.y, hi.y), [&](size_t i) { result.push_back(i); });
+            std::sort(result.begin(), result.end());
             return result;
         }
 
-        std::vector<Element> getPolygons() const {
-            std::vector<Element> result;
-            for (const auto &element : elements_) {
-                if (std::holds_alternative<concord::Polygon>(element.geometry)) {
-                    result.push_back(element);
-                }
-            }
+        /// indices of elements within `radius` of `center` (distance to the geometry itself; 0 inside a
+        /// polygon), ascending
+        std::vector<size_t> elementsWithin(const concord::Point &center, double radius) const {
+            std::vector<size_t> result;
+            spatial_.search(elements_, handles_, center.x - radius, center.y - radius, center.x + radius,
+                            center.y + radius, [&](size_t i) {
+                                if (op::distance(elements_[i].geometry, center.x, center.y) <= radius)
+                                    result.push_back(i);
+                            });
+            std::sort(result.begin(), result.end());
             return result;
         }
 
-        std::vector<Element> filterByProperty(const std::string &key, const std::string &value) const {
-            std::vector<Element> result;
-            for (const auto &element : elements_) {
-                auto it = element.properties.find(key);
-                if (it != element.properties.end() && it->second == value) {
-                    result.push_back(element);
-                }
-            }
-            return result;
+        /// indices of the (up to) `k` elements closest to `point`, nearest first
+        std::vector<size_t> nearestElements(const concord::Point &point, size_t k) const {
+            return spatial_.nearest(elements_, handles_, point.x, point.y, k, [&](size_t i) {
+                return op::distance(elements_[i].geometry, point.x, point.y);
+            });
         }
 
         const concord::Datum &getDatum() const { return datum_; }
@@ -238,6 +1088,90 @@ namespace geoson {
         const concord::Euler &getHeading() const { return heading_; }
         void setHeading(const concord::Euler &heading) { heading_ = heading; }
 
+        // Bulk geometry operations over the field boundary and every element. The elements are split into
+        // contiguous ranges over `threads` workers (0: every hardware thread; small Vectors stay on the calling
+        // thread), and each range's coordinates go through the kernel as one contiguous buffer. Types and
+        // properties are untouched; the spatial index is rebuilt on the next query.
+
+        /// Runs `kernel(concord::Point *points, size_t n)` over every coordinate; it is called concurrently.
+        template <typename Kernel> void transformPoints(Kernel &&kernel, unsigned threads = 0) {
+            Geometry boundary = field_boundary_; // a copy, so a throwing kernel leaves the boundary as it was
+            op::transformGeometries(1, 1, [&](size_t) -> Geometry & { return boundary; }, kernel);
+            field_boundary_ = std::get<concord::Polygon>(std::move(boundary));
+            spatial_.reset(); // first: a throwing kernel can leave the elements partly moved
+            op::transformGeometries(
+                elements_.size(), threads, [&](size_t i) -> Geometry & { return elements_[i].geometry; }, kernel);
+        }
+
+        /// shifts every coordinate by (dx, dy, dz) metres
+        void translate(double dx, double dy, double dz = 0.0, unsigned threads = 0) {
+            transformPoints(
+                [=](concord::Point *p, size_t n) {
+                    for (size_t i = 0; i < n; ++i) {
+                        p[i].x += dx;
+                        p[i].y += dy;
+                        p[i].z += dz;
+                    }
+                },
+                threads);
+        }
+
+        /// Re-heading: turns every coordinate `yaw` radians counter-clockwise about the datum (in the x/y plane)
+        /// and adds `yaw` to the heading.
+        void rotate(double yaw, unsigned threads = 0) {
+            const double c = std::cos(yaw), s = std::sin(yaw);
+            transformPoints(
+                [=](concord::Point *p, size_t n) {
+                    for (size_t i = 0; i < n; ++i) {
+                        const double x = p[i].x, y = p[i].y;
+                        p[i].x = c * x - s * y;
+                        p[i].y = s * x + c * y;
+                    }
+                },
+                threads);
+            heading_.yaw += yaw;
+        }
+
+        /// Moves the Vector to `datum`, re-expressing every coordinate in the new ENU frame so the features stay
+        /// where they are on the ground (`setDatum` only relabels them). One exact affine map per point.
+        void reproject(const concord::Datum &datum, unsigned threads = 0) {
+            const auto from = DatumTransform::shared(datum_), to = DatumTransform::shared(datum);
+            transformPoints([&](concord::Point *p, size_t n) { from->toFrame(*to, p, n); }, threads);
+            datum_ = datum;
+        }
+
+        /// box around the field boundary and every element
+        Bounds bounds(unsigned threads = 0) const {
+            Bounds b;
+            for (auto const &p : field_boundary_.getPoints())
+                b.expand(p);
+            auto parts = op::forRanges(elements_.size(), threads, op::bulk_grain, [&](size_t begin, size_t end) {
+                Bounds part;
+                for (size_t i = begin; i < end; ++i)
+                    op::forEachPosition(elements_[i].geometry, [&](const concord::Point &p) { part.expand(p); });
+                return part;
+            });
+            for (auto const &part : parts)
+                b.expand(part);
+            return b;
+        }
+
+        /// Douglas-Peucker on every path and polygon, field boundary included: drops the vertices within
+        /// `tolerance` metres (x/y) of the simplified outline. Points and lines are left alone.
+        void simplify(double tolerance, unsigned threads = 0) {
+            field_boundary_ = concord::Polygon{op::simplify(field_boundary_.getPoints(), tolerance, true)};
+            op::forRanges(elements_.size(), threads, op::bulk_grain, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    Geometry &g = elements_[i].geometry;
+                    if (auto *path = std::get_if<concord::Path>(&g))
+                        g = concord::Path{op::simplify(path->getPoints(), tolerance, false)};
+                    else if (auto *polygon = std::get_if<concord::Polygon>(&g))
+                        g = concord::Polygon{op::simplify(polygon->getPoints(), tolerance, true)};
+                }
+            });
+            spatial_.reset();
+        }
+
         CRS getCRS() const { return crs_; }
         void setCRS(CRS crs) { crs_ = crs; }
 
@@ -250,8 +1184,15 @@ namespace geoson {
         const std::unordered_map<std::string, std::string> &getGlobalProperties() const { return global_properties_; }
         void removeGlobalProperty(const std::string &key) { global_properties_.erase(key); }
 
-        auto begin() { return elements_.begin(); }
-        auto end() { return elements_.end(); }
+        // mutable iteration drops the indexes like getElement; edit through modifyElement to keep them
+        auto begin() {
+            elementsChanged();
+            return elements_.begin();
+        }
+        auto end() {
+            elementsChanged();
+            return elements_.end();
+        }
         auto begin() const { return elements_.begin(); }
         auto end() const { return elements_.end(); }
         auto cbegin() const { return elements_.cbegin(); }
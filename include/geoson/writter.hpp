@@ -1,27 +1,49 @@
 #pragma once
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <ostream>
+#include <string_view>
+#include <vector>
 
+#include "geoson/stats.hpp"
+#include "geoson/transform.hpp"
 #include "geoson/types.hpp"
 
 namespace geoson {
 
+    namespace op {
+        /// the points of one ring/path as they will be written: untouched for ENU, or converted in one batch to
+        /// lon/lat/alt (held in x/y/z) for WGS
+        inline const std::vector<concord::Point> &outputPoints(std::vector<concord::Point> const &pts,
+                                                               const DatumTransform &tf, geoson::CRS outputCrs,
+                                                               std::vector<concord::Point> &scratch) {
+            if (outputCrs == geoson::CRS::ENU)
+                return pts;
+            scratch.assign(pts.begin(), pts.end());
+            tf.toWGS(scratch.data(), scratch.size());
+            return scratch;
+        }
+    } // namespace op
+
     /// helper to turn a single Geometry into its GeoJSON object
-    inline nlohmann::json geometryToJson(Geometry const &geom, const concord::Datum &datum, geoson::CRS outputCrs) {
-        // Helper to build coordinates based on desired output CRS
-        // Internal representation is always in Point coordinates (ENU/local system)
-        auto ptCoords = [&](concord::Point const &p) {
-            if (outputCrs == geoson::CRS::ENU) {
-                // ENU output: coordinates are already in local system, output directly as x,y,z
-                return nlohmann::json::array({p.x, p.y, p.z});
-            } else {
-                // WGS output: convert Point to ENU with datum, then to WGS
-                concord::ENU enu{p, datum};
-                concord::WGS wgs = enu.toWGS();
-                return nlohmann::json::array({wgs.lon, wgs.lat, wgs.alt});
-            }
+    inline nlohmann::json geometryToJson(Geometry const &geom, const DatumTransform &tf, geoson::CRS outputCrs) {
+        // Internal representation is always in Point coordinates (ENU/local system); for WGS output the
+        // points arrive here already converted, with lon/lat/alt in x/y/z
+        auto ptCoords = [](concord::Point const &p) { return nlohmann::json::array({p.x, p.y, p.z}); };
+        std::vector<concord::Point> scratch;
+        auto ringCoords = [&](std::vector<concord::Point> const &pts) {
+            nlohmann::json arr = nlohmann::json::array();
+            for (auto const &p : op::outputPoints(pts, tf, outputCrs, scratch))
+                arr.push_back(ptCoords(p));
+            return arr;
         };
 
         return std::visit(
@@ -30,41 +52,57 @@ namespace geoson {
                 nlohmann::json j;
                 if constexpr (std::is_same_v<T, concord::Point>) {
                     j["type"] = "Point";
-                    j["coordinates"] = ptCoords(shape);
+                    j["coordinates"] = ringCoords({shape})[0];
                 } else if constexpr (std::is_same_v<T, concord::Line>) {
                     j["type"] = "LineString";
-                    j["coordinates"] = nlohmann::json::array({ptCoords(shape.getStart()), ptCoords(shape.getEnd())});
+                    j["coordinates"] = ringCoords({shape.getStart(), shape.getEnd()});
                 } else if constexpr (std::is_same_v<T, concord::Path>) {
                     j["type"] = "LineString";
-                    nlohmann::json arr = nlohmann::json::array();
-                    for (auto const &p : shape.getPoints())
-                        arr.push_back(ptCoords(p));
-                    j["coordinates"] = std::move(arr);
+                    j["coordinates"] = ringCoords(shape.getPoints());
                 } else if constexpr (std::is_same_v<T, concord::Polygon>) {
                     j["type"] = "Polygon";
-                    nlohmann::json rings = nlohmann::json::array();
-                    nlohmann::json ring = nlohmann::json::array();
-                    for (auto const &p : shape.getPoints())
-                        ring.push_back(ptCoords(p));
-                    rings.push_back(std::move(ring));
-                    j["coordinates"] = std::move(rings);
+                    j["coordinates"] = nlohmann::json::array({ringCoords(shape.getPoints())});
                 }
                 return j;
             },
             geom);
     }
 
+    inline nlohmann::json geometryToJson(Geometry const &geom, const concord::Datum &datum, geoson::CRS outputCrs) {
+        return geometryToJson(geom, *DatumTransform::shared(datum), outputCrs);
+    }
+
+    /// one property value as JSON of its own type
+    inline nlohmann::json propertyToJson(PropertyValue const &v) {
+        switch (v.kind()) {
+        case PropertyValue::Kind::String:
+            return v.asString();
+        case PropertyValue::Kind::Integer:
+            return v.asInt();
+        case PropertyValue::Kind::Number:
+            return v.asDouble();
+        case PropertyValue::Kind::Boolean:
+            return v.asBool();
+        default:
+            return nlohmann::json::parse(v.str());
+        }
+    }
+
     /// turn one Feature into its GeoJSON object
-    inline nlohmann::json featureToJson(Feature const &f, const concord::Datum &datum, geoson::CRS outputCrs) {
+    inline nlohmann::json featureToJson(Feature const &f, const DatumTransform &tf, geoson::CRS outputCrs) {
         nlohmann::json j;
         j["type"] = "Feature";
         j["properties"] = nlohmann::json::object();
-        for (auto const &kv : f.properties)
-            j["properties"][kv.first] = kv.second;
-        j["geometry"] = geometryToJson(f.geometry, datum, outputCrs);
+        for (auto const &[key, value] : f.properties)
+            j["properties"][key.str()] = propertyToJson(value);
+        j["geometry"] = geometryToJson(f.geometry, tf, outputCrs);
         return j;
     }
 
+    inline nlohmann::json featureToJson(Feature const &f, const concord::Datum &datum, geoson::CRS outputCrs) {
+        return featureToJson(f, *DatumTransform::shared(datum), outputCrs);
+    }
+
     /// serialize a full FeatureCollection to GeoJSON with specified output CRS
     inline nlohmann::json toJson(FeatureCollection const &fc, geoson::CRS outputCrs) {
         nlohmann::json j;
@@ -98,9 +136,10 @@ namespace geoson {
         }
 
         // features (use output CRS for coordinate conversion)
+        const auto tf = DatumTransform::shared(fc.datum);
         j["features"] = nlohmann::json::array();
         for (auto const &f : fc.features)
-            j["features"].push_back(featureToJson(f, fc.datum, outputCrs));
+            j["features"].push_back(featureToJson(f, *tf, outputCrs));
 
         return j;
     }
@@ -108,14 +147,513 @@ namespace geoson {
     /// serialize a full FeatureCollection to GeoJSON (defaults to ENU output format)
     inline nlohmann::json toJson(FeatureCollection const &fc) { return toJson(fc, geoson::CRS::ENU); }
 
-    /// write GeoJSON out to disk with specified output CRS (pretty‐printed)
+    /// Output formatting knobs for the streaming writers. The defaults reproduce `toJson(fc).dump(2)`, numbers
+    /// aside: those are the shortest round-trip digits (see `op::formatNumber`).
+    struct WriteOptions {
+        /// spaces per nesting level; negative writes compact single-line output (as `nlohmann::json::dump`)
+        int indent = 2;
+        /// digits after the decimal point for metre values (ENU x/y/z, WGS altitude); negative keeps full precision
+        int decimals = -1;
+        /// digits after the decimal point for WGS lon/lat; 7 gives fixed 1e-7 degree (~1cm) steps
+        int degree_decimals = -1;
+        /// write the third coordinate even when it is 0; when false, a geometry drops it only if all of its
+        /// (rounded) z values are 0, so every position of one geometry has the same dimension
+        bool emit_zero_z = true;
+
+        /// single-line output at full precision, laid out as `toJson(fc).dump()`
+        static WriteOptions compact() {
+            WriteOptions opts;
+            opts.indent = -1;
+            return opts;
+        }
+    };
+
+    namespace op {
+        /// `v` rounded to `decimals` digits after the decimal point; negative `decimals` leaves it untouched
+        inline double roundTo(double v, int decimals) {
+            static constexpr double scale[] = {1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                               1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+            if (decimals < 0 || decimals > 15 || !std::isfinite(v))
+                return v;
+            double r = std::round(v * scale[decimals]) / scale[decimals];
+            if (!std::isfinite(r))
+                return v;
+            return r == 0.0 ? 0.0 : r; // no "-0.0"
+        }
+
+        /// Writes finite `v` to `buf` (32 bytes are enough) and returns the end: the shortest round-trip digits
+        /// from `std::to_chars`, laid out as `dump()` lays out numbers -- a plain decimal when the point falls
+        /// within 15 digits of them (`12.5`, `3000.0`, `0.0001`), else `d.ddde+XX`. nlohmann's Grisu2 digits
+        /// agree except for about one full-precision value in a thousand, where its are a digit longer or differ
+        /// in the last place; both read back to the same double.
+        inline char *formatNumber(char *buf, double v) {
+            char sci[32];
+            const char *p = sci, *end = std::to_chars(sci, sci + sizeof(sci), v, std::chars_format::scientific).ptr;
+            if (*p == '-')
+                *buf++ = *p++;
+            char digits[20];
+            int len = 0;
+            for (; *p != 'e'; ++p)
+                if (*p != '.')
+                    digits[len++] = *p;
+            int exp = 0;
+            std::from_chars(p + (p[1] == '+' ? 2 : 1), end, exp);
+            const int point = exp + 1; // digits before the decimal point
+
+            auto put = [&](const char *from, int n) { buf = std::copy(from, from + n, buf); };
+            if (len <= point && point <= 15) {
+                put(digits, len);
+                buf = std::fill_n(buf, point - len, '0');
+                put(".0", 2);
+            } else if (0 < point && point <= 15) {
+                put(digits, point);
+                *buf++ = '.';
+                put(digits + point, len - point);
+            } else if (-4 < point && point <= 0) {
+                put("0.", 2);
+                buf = std::fill_n(buf, -point, '0');
+                put(digits, len);
+            } else {
+                *buf++ = digits[0];
+                if (len > 1) {
+                    *buf++ = '.';
+                    put(digits + 1, len - 1);
+                }
+                *buf++ = 'e';
+                *buf++ = exp < 0 ? '-' : '+';
+                if (exp < 0)
+                    exp = -exp;
+                if (exp < 10)
+                    *buf++ = '0';
+                buf = std::to_chars(buf, buf + 3, exp).ptr;
+            }
+            return buf;
+        }
+
+        /// Fixed-size output buffer in front of a std::ostream or FILE*, so the emitter below never allocates per
+        /// token and the underlying stream sees only large writes.
+        class OutputBuffer {
+          public:
+            explicit OutputBuffer(std::ostream &os) : os_(&os), buf_(1 << 16) {}
+            explicit OutputBuffer(std::FILE *fp) : fp_(fp), buf_(1 << 16) {}
+
+            OutputBuffer(const OutputBuffer &) = delete;
+            OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+            ~OutputBuffer() { flush(); }
+
+            void put(char c) {
+                if (len_ == buf_.size())
+                    flush();
+                buf_[len_++] = c;
+            }
+
+            void write(const char *s, std::size_t n) {
+                if (n > buf_.size() - len_) {
+                    flush();
+                    if (n >= buf_.size()) {
+                        sink(s, n);
+                        return;
+                    }
+                }
+                std::memcpy(buf_.data() + len_, s, n);
+                len_ += n;
+            }
+
+            void write(std::string_view s) { write(s.data(), s.size()); }
+
+            void flush() {
+                if (len_ > 0)
+                    sink(buf_.data(), len_);
+                len_ = 0;
+            }
+
+          private:
+            std::ostream *os_ = nullptr;
+            std::FILE *fp_ = nullptr;
+            std::vector<char> buf_;
+            std::size_t len_ = 0;
+
+            void sink(const char *s, std::size_t n) {
+                addStat(&Stats::bytes_written, n);
+                if (os_)
+                    os_->write(s, static_cast<std::streamsize>(n));
+                else
+                    std::fwrite(s, 1, n, fp_);
+            }
+        };
+
+        /// Writes JSON tokens straight to an OutputBuffer. The layout matches `nlohmann::json::dump(indent)`
+        /// byte for byte: compact for a negative indent, otherwise one member per line indented by `indent` spaces.
+        /// Callers are responsible for emitting object keys in sorted order, as nlohmann's std::map does.
+        class JsonEmitter {
+          public:
+            explicit JsonEmitter(OutputBuffer &out, int indent = -1) : out_(out), indent_(indent) {}
+
+            void beginObject() { open('{'); }
+            void endObject() { close('}'); }
+            void beginArray() { open('['); }
+            void endArray() { close(']'); }
+
+            void key(std::string_view k) {
+                separator();
+                quoted(k);
+                out_.put(':');
+                if (indent_ >= 0)
+                    out_.put(' ');
+                after_key_ = true;
+            }
+
+            void value(std::string_view s) {
+                prefix();
+                quoted(s);
+            }
+
+            void value(double v) {
+                prefix();
+                if (!std::isfinite(v)) {
+                    out_.write("null", 4);
+                    return;
+                }
+                char buf[32];
+                out_.write(buf, static_cast<std::size_t>(formatNumber(buf, v) - buf));
+            }
+
+            /// a scalar written as is: `true`, `null`, an integer
+            void literal(std::string_view token) {
+                prefix();
+                out_.write(token.data(), token.size());
+            }
+
+          private:
+            OutputBuffer &out_;
+            int indent_;
+            std::vector<bool> first_; // one entry per open container: no member written yet
+            bool after_key_ = false;
+
+            void newline() {
+                out_.put('\n');
+                for (std::size_t i = 0, n = first_.size() * static_cast<std::size_t>(indent_); i < n; ++i)
+                    out_.put(' ');
+            }
+
+            void separator() {
+                if (first_.empty())
+                    return;
+                if (!first_.back())
+                    out_.put(',');
+                first_.back() = false;
+                if (indent_ >= 0)
+                    newline();
+            }
+
+            void prefix() {
+                if (after_key_)
+                    after_key_ = false;
+                else
+                    separator();
+            }
+
+            void open(char c) {
+                prefix();
+                out_.put(c);
+                first_.push_back(true);
+            }
+
+            void close(char c) {
+                bool empty = first_.back();
+                first_.pop_back();
+                if (!empty && indent_ >= 0)
+                    newline();
+                out_.put(c);
+            }
+
+            void quoted(std::string_view s) {
+                for (unsigned char c : s) {
+                    if (c >= 0x80) {
+                        // leave UTF-8 validation and its error reporting to nlohmann
+                        out_.write(nlohmann::json(std::string(s)).dump());
+                        return;
+                    }
+                }
+                out_.put('"');
+                for (unsigned char c : s) {
+                    switch (c) {
+                    case '"':
+                        out_.write("\\\"", 2);
+                        break;
+                    case '\\':
+                        out_.write("\\\\", 2);
+                        break;
+                    case '\b':
+                        out_.write("\\b", 2);
+                        break;
+                    case '\f':
+                        out_.write("\\f", 2);
+                        break;
+                    case '\n':
+                        out_.write("\\n", 2);
+                        break;
+                    case '\r':
+                        out_.write("\\r", 2);
+                        break;
+                    case '\t':
+                        out_.write("\\t", 2);
+                        break;
+                    default:
+                        if (c < 0x20) {
+                            char esc[7];
+                            std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+                            out_.write(esc, 6);
+                        } else {
+                            out_.put(static_cast<char>(c));
+                        }
+                    }
+                }
+                out_.put('"');
+            }
+        };
+
+        /// whether the positions of one geometry, `z(0)` ... `z(n - 1)` their heights, are written with a z
+        template <typename Z> bool emitsZ(std::size_t n, Z &&z, const WriteOptions &opts) {
+            if (opts.emit_zero_z)
+                return true;
+            for (std::size_t i = 0; i < n; ++i)
+                if (roundTo(z(i), opts.decimals) != 0.0)
+                    return true;
+            return false;
+        }
+
+        /// one position, already in output coordinates (see `outputPoints`); `with_z` comes from `emitsZ`
+        inline void emitCoords(JsonEmitter &e, concord::Point const &p, geoson::CRS outputCrs,
+                               const WriteOptions &opts, bool with_z) {
+            const int planar = outputCrs == geoson::CRS::ENU ? opts.decimals : opts.degree_decimals;
+            e.beginArray();
+            e.value(roundTo(p.x, planar));
+            e.value(roundTo(p.y, planar));
+            if (with_z)
+                e.value(roundTo(p.z, opts.decimals));
+            e.endArray();
+        }
+
+        /// streaming counterpart of `geometryToJson`; `scratch` is reused across calls for the WGS conversion
+        inline void emitGeometry(JsonEmitter &e, Geometry const &geom, const DatumTransform &tf,
+                                 geoson::CRS outputCrs, const WriteOptions &opts,
+                                 std::vector<concord::Point> &scratch) {
+            auto ring = [&](std::vector<concord::Point> const &pts) {
+                addStat(&Stats::coordinates, pts.size());
+                auto const &out = outputPoints(pts, tf, outputCrs, scratch);
+                const bool with_z = emitsZ(out.size(), [&](std::size_t i) { return out[i].z; }, opts);
+                e.beginArray();
+                for (auto const &p : out)
+                    emitCoords(e, p, outputCrs, opts, with_z);
+                e.endArray();
+            };
+
+            e.beginObject();
+            e.key("coordinates");
+            const char *type = std::visit(
+                [&](auto const &shape) -> const char * {
+                    using T = std::decay_t<decltype(shape)>;
+                    if constexpr (std::is_same_v<T, concord::Point>) {
+                        addStat(&Stats::coordinates, 1);
+                        const concord::Point p = outputPoints({shape}, tf, outputCrs, scratch)[0];
+                        emitCoords(e, p, outputCrs, opts, emitsZ(1, [&](std::size_t) { return p.z; }, opts));
+                        return "Point";
+                    } else if constexpr (std::is_same_v<T, concord::Line>) {
+                        ring({shape.getStart(), shape.getEnd()});
+                        return "LineString";
+                    } else if constexpr (std::is_same_v<T, concord::Path>) {
+                        ring(shape.getPoints());
+                        return "LineString";
+                    } else {
+                        e.beginArray();
+                        ring(shape.getPoints());
+                        e.endArray();
+                        return "Polygon";
+                    }
+                },
+                geom);
+            e.key("type");
+            e.value(type);
+            e.endObject();
+        }
+
+        /// any json value, laid out as its dump() would be
+        inline void emitJson(JsonEmitter &e, nlohmann::json const &j) {
+            switch (j.type()) {
+            case nlohmann::json::value_t::object:
+                e.beginObject();
+                for (auto const &[key, value] : j.items()) {
+                    e.key(key);
+                    emitJson(e, value);
+                }
+                e.endObject();
+                break;
+            case nlohmann::json::value_t::array:
+                e.beginArray();
+                for (auto const &value : j)
+                    emitJson(e, value);
+                e.endArray();
+                break;
+            case nlohmann::json::value_t::string:
+                e.value(j.get_ref<const std::string &>());
+                break;
+            case nlohmann::json::value_t::number_float:
+                e.value(j.get<double>());
+                break;
+            default:
+                e.literal(j.dump());
+            }
+        }
+
+        inline void emitPropertyValue(JsonEmitter &e, PropertyValue const &v) {
+            switch (v.kind()) {
+            case PropertyValue::Kind::String:
+                e.value(v.asString());
+                break;
+            case PropertyValue::Kind::Number:
+                e.value(v.asDouble());
+                break;
+            case PropertyValue::Kind::Json:
+                emitJson(e, nlohmann::json::parse(v.str()));
+                break;
+            default:
+                e.literal(v.str());
+            }
+        }
+
+        /// emit a property bag as a JSON object with keys in nlohmann's (sorted) order
+        inline void emitProperties(JsonEmitter &e, Properties const &props) {
+            std::vector<Properties::value_type const *> sorted;
+            sorted.reserve(props.size());
+            for (auto const &kv : props)
+                sorted.push_back(&kv);
+            std::sort(sorted.begin(), sorted.end(), [](auto a, auto b) { return a->first < b->first; });
+
+            e.beginObject();
+            for (auto kv : sorted) {
+                e.key(kv->first.str());
+                emitPropertyValue(e, kv->second);
+            }
+            e.endObject();
+        }
+
+        /// streaming counterpart of `featureToJson`, for a geometry and properties held outside a Feature
+        inline void emitFeature(JsonEmitter &e, Geometry const &geometry, Properties const &properties,
+                                const DatumTransform &tf, geoson::CRS outputCrs, const WriteOptions &opts,
+                                std::vector<concord::Point> &scratch) {
+            e.beginObject();
+            e.key("geometry");
+            emitGeometry(e, geometry, tf, outputCrs, opts, scratch);
+            e.key("properties");
+            emitProperties(e, properties);
+            e.key("type");
+            e.value("Feature");
+            e.endObject();
+        }
+
+        inline void emitFeature(JsonEmitter &e, Feature const &f, const DatumTransform &tf, geoson::CRS outputCrs,
+                                const WriteOptions &opts, std::vector<concord::Point> &scratch) {
+            emitFeature(e, f.geometry, f.properties, tf, outputCrs, opts, scratch);
+        }
+
+        /// streaming counterpart of the top-level 'properties' built by `toJson`
+        inline void emitHeader(JsonEmitter &e, const concord::Datum &datum, const concord::Euler &heading,
+                               std::unordered_map<std::string, std::string> const &globals, geoson::CRS outputCrs) {
+            // built-in members, replaced by a global property of the same name exactly as in toJson
+            std::vector<std::pair<std::string_view, std::string const *>> members;
+            members.reserve(globals.size() + 3);
+            for (auto const &[key, value] : globals)
+                members.emplace_back(key, &value);
+            for (std::string_view builtin : {"crs", "datum", "heading"})
+                if (!globals.count(std::string(builtin)))
+                    members.emplace_back(builtin, nullptr);
+            std::sort(members.begin(), members.end(), [](auto &a, auto &b) { return a.first < b.first; });
+
+            e.beginObject();
+            for (auto const &[key, value] : members) {
+                e.key(key);
+                if (value) {
+                    e.value(*value);
+                } else if (key == "crs") {
+                    e.value(outputCrs == geoson::CRS::WGS ? "EPSG:4326" : "ENU");
+                } else if (key == "datum") {
+                    e.beginArray();
+                    e.value(datum.lat);
+                    e.value(datum.lon);
+                    e.value(datum.alt);
+                    e.endArray();
+                } else {
+                    e.value(heading.yaw);
+                }
+            }
+            e.endObject();
+        }
+
+        /// the FeatureCollection layout around features that need not live in one: `features(emit)` calls
+        /// `emit(geometry, properties)` once per feature, in order
+        template <typename Features>
+        void emitCollection(JsonEmitter &e, const concord::Datum &datum, const concord::Euler &heading,
+                            std::unordered_map<std::string, std::string> const &globals, geoson::CRS outputCrs,
+                            const WriteOptions &opts, Features &&features) {
+            StatTimer timer(&Stats::serialize_ns);
+            e.beginObject();
+            const auto tf = DatumTransform::shared(datum);
+            std::vector<concord::Point> scratch;
+            e.key("features");
+            e.beginArray();
+            features([&](Geometry const &geometry, Properties const &properties) {
+                addStat(&Stats::features, 1);
+                emitFeature(e, geometry, properties, *tf, outputCrs, opts, scratch);
+            });
+            e.endArray();
+            e.key("properties");
+            emitHeader(e, datum, heading, globals, outputCrs);
+            e.key("type");
+            e.value("FeatureCollection");
+            e.endObject();
+        }
+
+        /// streaming counterpart of `toJson(fc, outputCrs).dump(indent)`
+        inline void emitFeatureCollection(JsonEmitter &e, FeatureCollection const &fc, geoson::CRS outputCrs,
+                                          const WriteOptions &opts = {}) {
+            emitCollection(e, fc.datum, fc.heading, fc.global_properties, outputCrs, opts, [&](auto &&emit) {
+                for (auto const &f : fc.features)
+                    emit(f.geometry, f.properties);
+            });
+        }
+    } // namespace op
+
+    /// write GeoJSON straight into a stream; by default compact and laid out as `toJson(fc, outputCrs).dump()`,
+    /// without building it
+    inline void WriteFeatureCollection(FeatureCollection const &fc, std::ostream &os,
+                                       geoson::CRS outputCrs = geoson::CRS::ENU,
+                                       const WriteOptions &opts = WriteOptions::compact()) {
+        op::OutputBuffer out(os);
+        op::JsonEmitter e(out, opts.indent);
+        op::emitFeatureCollection(e, fc, outputCrs, opts);
+    }
+
+    /// write GeoJSON straight into a C stream (compact by default)
+    inline void WriteFeatureCollection(FeatureCollection const &fc, std::FILE *fp,
+                                       geoson::CRS outputCrs = geoson::CRS::ENU,
+                                       const WriteOptions &opts = WriteOptions::compact()) {
+        op::OutputBuffer out(fp);
+        op::JsonEmitter e(out, opts.indent);
+        op::emitFeatureCollection(e, fc, outputCrs, opts);
+    }
+
+    /// write GeoJSON out to disk with specified output CRS (pretty‐printed unless `opts` says otherwise)
     inline void WriteFeatureCollection(FeatureCollection const &fc, std::filesystem::path const &outPath,
-                                       geoson::CRS outputCrs) {
-        auto j = toJson(fc, outputCrs);
-        std::ofstream ofs(outPath);
+                                       geoson::CRS outputCrs, const WriteOptions &opts = {}) {
+        std::ofstream ofs(outPath, std::ios::binary);
         if (!ofs)
             throw std::runtime_error("Cannot open for write: " + outPath.string());
-        ofs << j.dump(2) << "\n";
+        op::OutputBuffer out(ofs);
+        op::JsonEmitter e(out, opts.indent);
+        op::emitFeatureCollection(e, fc, outputCrs, opts);
+        out.put('\n');
     }
 
     /// write GeoJSON out to disk (pretty‐printed) - defaults to ENU output format
@@ -123,4 +661,102 @@ namespace geoson {
         WriteFeatureCollection(fc, outPath, geoson::CRS::ENU);
     }
 
+    /// Incremental GeoJSON writer: the collection header goes out on construction, each `write` appends one
+    /// Feature, and `finish` closes the document. Only the feature being written is held in memory.
+    ///
+    /// Unlike `WriteFeatureCollection` the header ("type", "properties") precedes "features", so readers tailing the
+    /// file can interpret features as they arrive; `header.crs` selects the output CRS.
+    class FeatureWriter {
+      public:
+        /// Pretty-printed by default, like `WriteFeatureCollection(fc, path)`.
+        FeatureWriter(const std::filesystem::path &file, CollectionHeader header, const WriteOptions &opts = {})
+            : file_(file, std::ios::binary), out_(opened(file)), emitter_(out_, opts.indent),
+              header_(std::move(header)), tf_(DatumTransform::shared(header_.datum)), opts_(opts), newline_(true) {
+            begin();
+        }
+
+        /// Compact by default; writes into an existing stream, which must outlive the writer.
+        FeatureWriter(std::ostream &os, CollectionHeader header, const WriteOptions &opts = WriteOptions::compact())
+            : out_(os), emitter_(out_, opts.indent), header_(std::move(header)),
+              tf_(DatumTransform::shared(header_.datum)), opts_(opts), newline_(false), os_(&os) {
+            begin();
+        }
+
+        FeatureWriter(const FeatureWriter &) = delete;
+        FeatureWriter &operator=(const FeatureWriter &) = delete;
+
+        /// Closes the document if `finish` was not called; errors are swallowed here, call `finish` to see them.
+        ~FeatureWriter() {
+            try {
+                finish();
+            } catch (...) {
+            }
+        }
+
+        const CollectionHeader &header() const { return header_; }
+
+        /// Number of features written so far.
+        std::size_t count() const { return count_; }
+
+        void write(const Feature &feature) {
+            if (finished_)
+                throw std::runtime_error("geoson::FeatureWriter::write(): writer already finished");
+            op::emitFeature(emitter_, feature, *tf_, header_.crs, opts_, scratch_);
+            ++count_;
+        }
+
+        /// Pushes everything written so far through to the underlying stream.
+        void flush() {
+            out_.flush();
+            sink().flush();
+        }
+
+        /// Terminates the features array and the document. Further calls are no-ops.
+        void finish() {
+            if (finished_)
+                return;
+            finished_ = true;
+            emitter_.endArray();
+            emitter_.endObject();
+            if (newline_)
+                out_.put('\n');
+            flush();
+            if (file_.is_open())
+                file_.close();
+            if (!sink())
+                throw std::runtime_error("geoson::FeatureWriter::finish(): write failed");
+        }
+
+      private:
+        std::ofstream file_;
+        op::OutputBuffer out_;
+        op::JsonEmitter emitter_;
+        CollectionHeader header_;
+        std::shared_ptr<const DatumTransform> tf_;
+        WriteOptions opts_;
+        bool newline_;
+        bool finished_ = false;
+        std::size_t count_ = 0;
+        std::ostream *os_ = nullptr;
+        std::vector<concord::Point> scratch_;
+
+        std::ostream &opened(const std::filesystem::path &file) {
+            if (!file_)
+                throw std::runtime_error("Cannot open for write: " + file.string());
+            return file_;
+        }
+
+        std::ostream &sink() { return os_ ? *os_ : file_; }
+
+        void begin() {
+            emitter_.beginObject();
+            emitter_.key("type");
+            emitter_.value("FeatureCollection");
+            emitter_.key("properties");
+            op::emitHeader(emitter_, header_.datum, header_.heading, header_.global_properties, header_.crs);
+            emitter_.key("features");
+            emitter_.beginArray();
+        }
+    };
+
 } // namespace geoson
@@ -0,0 +1,172 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "geoson/binary.hpp"
+#include "geoson/geoson.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+
+namespace {
+    geoson::FeatureCollection sample() {
+        geoson::FeatureCollection fc;
+        fc.datum = concord::Datum{52.0, 5.0, 3.0};
+        fc.heading = concord::Euler{0.0, 0.0, 1.5};
+        fc.global_properties["name"] = "sample";
+        fc.global_properties["owner"] = "farm";
+
+        geoson::Properties a;
+        a["name"] = "pt";
+        a["n"] = 7;
+        a["tags"] = geoson::PropertyValue::fromJson(R"(["a","b"])");
+        fc.features.push_back({concord::Point{1.5, -2.0, 0.0}, a});
+        fc.features.push_back({concord::Line{concord::Point{0, 0, 0}, concord::Point{10, 5, 1}}, {}});
+        fc.features.push_back({concord::Path{std::vector<concord::Point>{{0, 0, 0}, {1, 1, 0}, {2, 0, 0.5}}}, a});
+        geoson::Properties b;
+        b["area"] = 12.25;
+        b["ok"] = true;
+        std::vector<concord::Point> ring{{-5, -5, 0}, {5, -5, 0}, {5, 5, 2}, {-5, 5, 0}, {-5, -5, 0}};
+        fc.features.push_back({concord::Polygon{ring}, b});
+        return fc;
+    }
+
+    std::string binary(const geoson::FeatureCollection &fc, const geoson::BinaryOptions &opts = {}) {
+        std::ostringstream os;
+        geoson::WriteBinaryCollection(fc, os, opts);
+        return os.str();
+    }
+
+    std::string geojson(const geoson::FeatureCollection &fc) {
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(fc, os);
+        return os.str();
+    }
+} // namespace
+
+TEST_CASE("Binary - Round trip") {
+    const auto fc = sample();
+
+    SUBCASE("Through a file") {
+        auto path = std::filesystem::temp_directory_path() / "geoson_binary_roundtrip.gsb";
+        geoson::WriteBinaryCollection(fc, path);
+        auto back = geoson::ReadBinaryCollection(path);
+        CHECK(back.datum.lat == fc.datum.lat);
+        CHECK(back.heading.yaw == fc.heading.yaw);
+        CHECK(back.global_properties == fc.global_properties);
+        CHECK(geojson(back) == geojson(fc));
+        std::filesystem::remove(path);
+    }
+
+    SUBCASE("From memory, aligned or not") {
+        const std::string bytes = binary(fc);
+        std::string shifted = " " + bytes;
+        auto bc = geoson::BinaryCollection::fromBuffer(std::string_view(shifted).substr(1));
+        CHECK(geojson(bc.toFeatureCollection()) == geojson(fc));
+        CHECK(geojson(bc.toColumnar().toFeatureCollection()) == geojson(fc));
+    }
+
+    SUBCASE("Empty collection") {
+        geoson::FeatureCollection empty;
+        empty.datum = concord::Datum{1.0, 2.0, 3.0};
+        auto bc = geoson::BinaryCollection::fromBuffer(binary(empty));
+        CHECK(bc.empty());
+        CHECK(bc.datum().alt == 3.0);
+        CHECK(bc.spatialIndex().empty());
+    }
+}
+
+TEST_CASE("Binary - In-place access") {
+    const auto fc = sample();
+    const std::string bytes = binary(fc);
+    auto bc = geoson::BinaryCollection::fromBuffer(bytes);
+
+    REQUIRE(bc.size() == 4);
+    CHECK(bc.pointCount() == 1 + 2 + 3 + 5);
+    CHECK(bc[0].kind == geoson::GeometryKind::Point);
+    CHECK(bc[3].kind == geoson::GeometryKind::Polygon);
+    CHECK(bc[3].size == 5);
+    CHECK(bc[3].point(2).z == 2.0);
+    CHECK(bc[0].properties == nullptr);
+
+    // the coordinates are read from the buffer itself
+    CHECK(reinterpret_cast<const char *>(bc.x()) > bytes.data());
+    CHECK(reinterpret_cast<const char *>(bc.x()) < bytes.data() + bytes.size());
+    CHECK(bc[2].x == bc.x() + 3);
+
+    auto props = bc.properties(0);
+    CHECK(props.at("name") == "pt");
+    CHECK(props.at("n").asInt() == 7);
+    CHECK(props.at("tags").kind() == geoson::PropertyValue::Kind::Json);
+    CHECK(bc.properties(1).empty());
+    CHECK(bc.properties(3).at("area").asDouble() == 12.25);
+    CHECK(bc.properties(3).at("ok").asBool());
+    CHECK(bc.global_properties().at("owner") == "farm");
+    CHECK_THROWS_AS(bc.at(4), std::out_of_range);
+}
+
+TEST_CASE("Binary - Spatial index") {
+    const auto fc = sample();
+
+    auto hits = [](const geoson::SpatialIndex &index, double x0, double y0, double x1, double y1) {
+        std::vector<size_t> out;
+        index.search(x0, y0, x1, y1, [&](size_t i) { out.push_back(i); });
+        std::sort(out.begin(), out.end());
+        return out;
+    };
+
+    const std::string with = binary(fc), without = binary(fc, geoson::BinaryOptions{false});
+    auto indexed = geoson::BinaryCollection::fromBuffer(with);
+    auto plain = geoson::BinaryCollection::fromBuffer(without);
+    CHECK(indexed.hasIndex());
+    CHECK_FALSE(plain.hasIndex());
+    CHECK(without.size() < with.size());
+
+    for (auto *bc : {&indexed, &plain}) {
+        auto index = bc->spatialIndex();
+        CHECK(index.size() == 4);
+        CHECK(hits(index, 1, -3, 2, -1) == std::vector<size_t>{0, 3});
+        CHECK(hits(index, 6, 1, 9, 4) == std::vector<size_t>{1});
+        CHECK(hits(index, 50, 50, 60, 60).empty());
+        CHECK(index.nearest(9.9, 5.0, 1, [](size_t) { return 0.0; }) == std::vector<size_t>{1});
+    }
+}
+
+TEST_CASE("Binary - Rejects bad input") {
+    const std::string bytes = binary(sample());
+
+    CHECK_THROWS_WITH(geoson::BinaryCollection::fromBuffer(bytes.substr(0, 16)),
+                      doctest::Contains("too short"));
+
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    CHECK_THROWS_WITH(geoson::BinaryCollection::fromBuffer(bad_magic), doctest::Contains("bad magic"));
+
+    CHECK_THROWS_WITH(geoson::BinaryCollection::fromBuffer(bytes.substr(0, bytes.size() / 2)),
+                      doctest::Contains("out of bounds"));
+
+    std::string bad_kind = bytes;
+    bad_kind[bad_kind.find(std::string("\x00\x01\x02\x03", 4))] = 9;
+    CHECK_THROWS_WITH(geoson::BinaryCollection::fromBuffer(bad_kind), doctest::Contains("corrupt"));
+
+    // counts in a section are checked against its size before anything is allocated from them
+    auto section = [&](std::string doc, std::size_t header_at, std::size_t at, std::uint64_t value,
+                       std::size_t width) {
+        std::uint64_t offset;
+        std::memcpy(&offset, doc.data() + header_at, 8);
+        std::memcpy(doc.data() + offset + at, &value, width);
+        return doc;
+    };
+    constexpr std::size_t keys_at = 144, props_at = 160, index_at = 192; // BinaryHeader section offsets
+    const std::uint64_t huge = std::uint64_t(1) << 60;
+    CHECK_THROWS_WITH(geoson::BinaryCollection::fromBuffer(section(bytes, keys_at, 0, 0xFFFFFFFFu, 4)),
+                      doctest::Contains("truncated section"));
+    auto records = geoson::BinaryCollection::fromBuffer(section(bytes, props_at, 8 * 5, 0xFFFFFFFFu, 4));
+    CHECK_THROWS_WITH(records.properties(0), doctest::Contains("truncated section"));
+    for (std::size_t at : {0, 8, 16}) {
+        auto index = geoson::BinaryCollection::fromBuffer(section(bytes, index_at, at, huge, 8));
+        CHECK_THROWS_WITH(index.spatialIndex(), doctest::Contains("truncated section"));
+    }
+
+    CHECK_THROWS(geoson::BinaryCollection::open("/nonexistent/file.gsb"));
+}
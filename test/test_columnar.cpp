@@ -0,0 +1,154 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "geoson/geoson.hpp"
+#include "geoson/vector.hpp"
+#include <sstream>
+
+namespace {
+    geoson::FeatureCollection sample() {
+        geoson::FeatureCollection fc;
+        fc.datum = concord::Datum{52.0, 5.0, 3.0};
+        fc.heading = concord::Euler{0.0, 0.0, 1.5};
+        fc.global_properties["name"] = "sample";
+
+        geoson::Properties a;
+        a["name"] = "pt";
+        a["n"] = 7;
+        fc.features.push_back({concord::Point{1.5, -2.0, 0.0}, a});
+        fc.features.push_back({concord::Line{concord::Point{0, 0, 0}, concord::Point{10, 5, 1}}, {}});
+        fc.features.push_back({concord::Path{std::vector<concord::Point>{{0, 0, 0}, {1, 1, 0}, {2, 0, 0.5}}}, a});
+        geoson::Properties b;
+        b["area"] = 12.25;
+        b["ok"] = true;
+        std::vector<concord::Point> ring{{-5, -5, 0}, {5, -5, 0}, {5, 5, 2}, {-5, 5, 0}, {-5, -5, 0}};
+        fc.features.push_back({concord::Polygon{ring}, b});
+        return fc;
+    }
+
+    std::string written(const geoson::FeatureCollection &fc, geoson::CRS crs, const geoson::WriteOptions &opts) {
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(fc, os, crs, opts);
+        return os.str();
+    }
+
+    std::string written(const geoson::ColumnarCollection &cc, geoson::CRS crs, const geoson::WriteOptions &opts) {
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(cc, os, crs, opts);
+        return os.str();
+    }
+} // namespace
+
+TEST_CASE("Columnar - Layout") {
+    auto fc = sample();
+    geoson::ColumnarCollection cc(fc);
+
+    CHECK(cc.size() == 4);
+    CHECK(cc.pointCount() == 1 + 2 + 3 + 5);
+    CHECK(cc.offsets == std::vector<std::size_t>{0, 1, 3, 6});
+    CHECK(cc.kinds[0] == geoson::GeometryKind::Point);
+    CHECK(cc.kinds[3] == geoson::GeometryKind::Polygon);
+    CHECK(cc.properties[0].sharesWith(fc.features[0].properties));
+
+    auto v = cc[2];
+    CHECK(v.kind == geoson::GeometryKind::Path);
+    CHECK(v.size == 3);
+    CHECK(v.x[2] == 2.0);
+    CHECK(v.z[2] == 0.5);
+    CHECK(v.properties->at("name") == "pt");
+    CHECK_THROWS_AS(cc.at(4), std::out_of_range);
+
+    SUBCASE("Round trip") {
+        auto back = cc.toFeatureCollection();
+        REQUIRE(back.features.size() == fc.features.size());
+        CHECK(back.global_properties == fc.global_properties);
+        CHECK(back.heading.yaw == fc.heading.yaw);
+        for (std::size_t i = 0; i < fc.features.size(); ++i) {
+            CHECK(back.features[i].geometry.index() == fc.features[i].geometry.index());
+            CHECK(back.features[i].properties == fc.features[i].properties);
+        }
+        auto line = std::get<concord::Line>(back.features[1].geometry);
+        CHECK(line.getEnd().x == 10.0);
+        CHECK(std::get<concord::Polygon>(back.features[3].geometry).getPoints().size() == 5);
+    }
+
+    SUBCASE("Bounds") {
+        auto all = cc.bounds();
+        CHECK(all.min_x == -5.0);
+        CHECK(all.max_x == 10.0);
+        CHECK(all.min_y == -5.0);
+        CHECK(all.max_y == 5.0);
+        CHECK(all.max_z == 2.0);
+
+        auto pt = cc.bounds(0);
+        CHECK(pt.min_x == 1.5);
+        CHECK(pt.max_x == 1.5);
+        CHECK(geoson::ColumnarCollection{}.bounds().empty());
+    }
+
+    SUBCASE("Translate") {
+        cc.translate(1.0, -1.0);
+        CHECK(cc[0].x[0] == 2.5);
+        CHECK(cc[0].y[0] == -3.0);
+        CHECK(cc[0].z[0] == 0.0);
+        CHECK(cc.bounds().max_x == 11.0);
+    }
+}
+
+TEST_CASE("Columnar - Output matches the row writer") {
+    auto fc = sample();
+    geoson::ColumnarCollection cc(fc);
+
+    geoson::WriteOptions rounded;
+    rounded.decimals = 2;
+    rounded.degree_decimals = 7;
+    rounded.emit_zero_z = false;
+
+    for (auto crs : {geoson::CRS::ENU, geoson::CRS::WGS}) {
+        CAPTURE(static_cast<int>(crs));
+        CHECK(written(cc, crs, geoson::WriteOptions::compact()) ==
+              written(fc, crs, geoson::WriteOptions::compact()));
+        CHECK(written(cc, crs, geoson::WriteOptions{}) == written(fc, crs, geoson::WriteOptions{}));
+        CHECK(written(cc, crs, rounded) == written(fc, crs, rounded));
+    }
+
+    SUBCASE("Empty collection") {
+        geoson::FeatureCollection none;
+        none.datum = fc.datum;
+        CHECK(written(geoson::ColumnarCollection(none), geoson::CRS::WGS, geoson::WriteOptions::compact()) ==
+              written(none, geoson::CRS::WGS, geoson::WriteOptions::compact()));
+    }
+}
+
+TEST_CASE("Columnar - Reading") {
+    auto fc = sample();
+    for (auto crs : {geoson::CRS::ENU, geoson::CRS::WGS}) {
+        CAPTURE(static_cast<int>(crs));
+        const auto text = written(fc, crs, geoson::WriteOptions::compact());
+
+        auto cc = geoson::ReadColumnarCollectionFromBuffer(text);
+        auto rows = geoson::ReadFeatureCollectionFromBuffer(text);
+        REQUIRE(cc.size() == rows.features.size());
+        CHECK(cc.global_properties.at("name") == "sample");
+        CHECK(cc.datum.lat == rows.datum.lat);
+        CHECK(written(cc, crs, geoson::WriteOptions::compact()) ==
+              written(rows, crs, geoson::WriteOptions::compact()));
+
+        std::istringstream is(text);
+        CHECK(geoson::ReadColumnarCollection(is).pointCount() == cc.pointCount());
+    }
+}
+
+TEST_CASE("Columnar - Vector export") {
+    geoson::Vector vec(concord::Polygon{std::vector<concord::Point>{{0, 0, 0}, {10, 0, 0}, {10, 10, 0}, {0, 0, 0}}});
+    vec.addPoint(concord::Point{1, 2, 0}, "tree");
+    vec.addPath(concord::Path{std::vector<concord::Point>{{0, 0, 0}, {3, 4, 0}}}, "track");
+
+    auto cc = vec.toColumnar();
+    REQUIRE(cc.size() == 3);
+    CHECK(cc.kinds[0] == geoson::GeometryKind::Polygon);
+    CHECK(cc.properties[0].at("type") == "field");
+    CHECK(cc.properties[1].at("type") == "tree");
+    CHECK(cc[2].size == 2);
+    CHECK_FALSE(vec.getFieldProperties().contains("type"));
+}
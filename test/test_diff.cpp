@@ -0,0 +1,203 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "geoson/geoson.hpp"
+#include "geoson/vector.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <sstream>
+
+namespace {
+    using Points = std::vector<concord::Point>;
+
+    geoson::FeatureCollection base() {
+        geoson::FeatureCollection fc;
+        fc.datum = concord::Datum{52.0, 5.0, 0.0};
+        fc.heading = concord::Euler{0, 0, 0.5};
+        fc.global_properties["name"] = "north";
+        fc.global_properties["season"] = "2025";
+        fc.features.push_back({concord::Polygon(Points{{0, 0, 0}, {100, 0, 0}, {100, 100, 0}, {0, 100, 0}}),
+                               {{"id", "f"}, {"type", "field"}}});
+        fc.features.push_back({concord::Path(Points{{0, 10, 0}, {100, 10, 0}, {100, 20, 0}}),
+                               {{"id", "r1"}, {"type", "row"}, {"crop", "wheat"}}});
+        fc.features.push_back({concord::Path(Points{{0, 30, 0}, {100, 30, 0}, {100, 40, 0}}),
+                               {{"id", "r2"}, {"type", "row"}, {"crop", "wheat"}}});
+        fc.features.push_back({concord::Point{50, 50, 0}, {{"id", "m1"}, {"type", "marker"}}});
+        fc.features.push_back({concord::Point{60, 60, 0}, {{"id", "m2"}, {"type", "marker"}}});
+        return fc;
+    }
+
+    /// r1 moves and changes crop, r2 loses its crop, m1 goes, o1 comes, the header changes
+    geoson::FeatureCollection edited() {
+        auto fc = base();
+        fc.heading = concord::Euler{0, 0, 0.75};
+        fc.global_properties.erase("season");
+        fc.global_properties["owner"] = "farm";
+        fc.features[1].geometry = concord::Path(Points{{0, 11, 0}, {100, 11, 0}, {100, 21, 0}});
+        fc.features[1].properties["crop"] = "barley";
+        fc.features[2].properties.erase("crop");
+        fc.features.erase(fc.features.begin() + 3);
+        fc.features.push_back({concord::Polygon(Points{{20, 20, 0}, {25, 20, 0}, {25, 25, 0}}),
+                               {{"id", "o1"}, {"type", "obstacle"}}});
+        return fc;
+    }
+
+    std::map<std::string, std::string> byId(const geoson::FeatureCollection &fc) {
+        std::map<std::string, std::string> out;
+        for (auto const &f : fc.features)
+            out[f.properties.at("id").str()] = geoson::featureToJson(f, fc.datum, geoson::CRS::ENU).dump();
+        return out;
+    }
+
+    std::string sortedGeoJson(geoson::FeatureCollection fc) {
+        std::vector<std::string> texts;
+        for (auto const &f : fc.features)
+            texts.push_back(geoson::featureToJson(f, fc.datum, geoson::CRS::ENU).dump());
+        std::sort(texts.begin(), texts.end());
+        std::string out;
+        for (auto const &t : texts)
+            out += t + '\n';
+        return out;
+    }
+} // namespace
+
+TEST_CASE("Diff - Keyed by property") {
+    const auto from = base(), to = edited();
+    auto patch = geoson::diff(from, to, {"id"});
+
+    CHECK(patch.removed == std::vector<std::string>{"m1"});
+    REQUIRE(patch.added.size() == 1);
+    CHECK(patch.added[0].properties.at("id") == "o1");
+    REQUIRE(patch.modified.size() == 2);
+    CHECK(patch.modified[0].id == "r1");
+    CHECK(patch.modified[0].geometry.has_value());
+    CHECK(patch.modified[0].set.at("crop") == "barley");
+    CHECK(patch.modified[0].set.size() == 1);
+    CHECK(patch.modified[1].id == "r2");
+    CHECK_FALSE(patch.modified[1].geometry.has_value());
+    CHECK(patch.modified[1].unset == std::vector<std::string>{"crop"});
+    CHECK_FALSE(patch.datum.has_value());
+    CHECK(patch.heading->yaw == 0.75);
+    CHECK(patch.set_global == std::unordered_map<std::string, std::string>{{"owner", "farm"}});
+    CHECK(patch.unset_global == std::vector<std::string>{"season"});
+
+    auto patched = from;
+    geoson::applyPatch(patched, patch);
+    CHECK(byId(patched) == byId(to));
+    CHECK(patched.global_properties == to.global_properties);
+    CHECK(patched.heading.yaw == to.heading.yaw);
+
+    CHECK(geoson::diff(to, to, {"id"}).empty());
+    CHECK(geoson::diff(patched, to, {"id"}).added.empty());
+}
+
+TEST_CASE("Diff - Content IDs and tolerance") {
+    auto from = base(), to = edited();
+    from.features.push_back(from.features.back()); // two identical markers
+    to.features.push_back(from.features.back());
+    to.features.push_back(from.features.back()); // and one more
+
+    auto patch = geoson::diff(from, to);
+    CHECK(patch.modified.empty()); // without a key an edit is a removal plus an addition
+    CHECK(patch.removed.size() == 3);
+    CHECK(patch.added.size() == 4);
+    for (auto const &id : patch.removed)
+        CHECK(id.front() == '#');
+
+    auto patched = from;
+    geoson::applyPatch(patched, patch);
+    CHECK(sortedGeoJson(patched) == sortedGeoJson(to));
+
+    auto nudged = base();
+    nudged.features[3].geometry = concord::Point{50.004, 50, 0};
+    CHECK(geoson::diff(base(), nudged, {"id", 0.01}).empty());
+    CHECK(geoson::diff(base(), nudged, {"id"}).modified.size() == 1);
+}
+
+TEST_CASE("Diff - Patch documents") {
+    const auto from = base(), to = edited();
+    auto patch = geoson::diff(from, to, {"id"});
+
+    std::stringstream ss;
+    geoson::WriteFeaturePatch(patch, ss);
+    CHECK(ss.str().find('\n') == ss.str().size() - 1); // compact
+    auto back = geoson::ReadFeaturePatch(ss);
+    CHECK(back.id_key == "id");
+    CHECK(back.removed == patch.removed);
+    CHECK(back.modified.size() == patch.modified.size());
+    CHECK(back.unset_global == patch.unset_global);
+
+    auto patched = from;
+    geoson::applyPatch(patched, back);
+    CHECK(byId(patched) == byId(to));
+
+    auto path = std::filesystem::temp_directory_path() / "geoson_diff.patch.json";
+    geoson::WriteFeaturePatch(patch, path);
+    CHECK(geoson::ReadFeaturePatch(path).added.size() == 1);
+    std::filesystem::remove(path);
+
+    std::istringstream not_a_patch(R"({"type": "FeatureCollection"})");
+    CHECK_THROWS_WITH(geoson::ReadFeaturePatch(not_a_patch), doctest::Contains("not a FeaturePatch"));
+}
+
+TEST_CASE("Diff - Patches that do not fit") {
+    auto patch = geoson::diff(base(), edited(), {"id"});
+    auto other = base();
+    other.features.erase(other.features.begin() + 1); // r1 is gone
+    const auto before = byId(other);
+    CHECK_THROWS_WITH(geoson::applyPatch(other, patch), doctest::Contains("\"r1\""));
+    CHECK(byId(other) == before);
+}
+
+TEST_CASE("Diff - Applying to a Vector") {
+    const auto from = base(), to = edited();
+    auto patch = geoson::diff(from, to, {"id"});
+
+    auto vector = geoson::Vector::fromFeatureCollection(from);
+    auto kept = vector.handleAt(1); // r2
+    auto dropped = vector.handleAt(2); // m1
+    CHECK(vector.elementsWithin(concord::Point{50, 50, 0}, 1.0).size() == 1);
+
+    vector.applyPatch(patch);
+    auto expected = geoson::Vector::fromFeatureCollection(to);
+    REQUIRE(vector.elementCount() == expected.elementCount());
+    for (size_t i = 0; i < vector.elementCount(); ++i) {
+        CHECK(vector.getElement(i).properties == expected.getElement(i).properties);
+        CHECK(vector.getElement(i).type == expected.getElement(i).type);
+    }
+    CHECK(vector.contains(kept));
+    CHECK_FALSE(vector.contains(dropped));
+    CHECK(vector.getElement(kept).properties.at("id") == "r2");
+    CHECK(vector.elementsWithin(concord::Point{50, 50, 0}, 1.0).empty()); // index updated
+    CHECK(vector.getElementsByType("obstacle").size() == 1);
+    CHECK(vector.getGlobalProperty("owner") == "farm");
+    for (size_t i = 0; i < vector.elementCount(); ++i) {
+        auto at = geoson::op::positions(vector.getElement(i).geometry).front();
+        auto hits = vector.elementsWithin(at, 0.0);
+        CHECK(std::find(hits.begin(), hits.end(), i) != hits.end());
+    }
+
+    SUBCASE("Field boundary edits") {
+        auto moved = to;
+        moved.features[0].geometry = concord::Polygon(Points{{0, 0, 0}, {120, 0, 0}, {120, 100, 0}, {0, 100, 0}});
+        moved.features[0].properties["crop_plan"] = "2026";
+        vector.applyPatch(geoson::diff(to, moved, {"id"}));
+        CHECK(vector.getFieldBoundary().getPoints()[1].x == 120.0);
+        CHECK(vector.getFieldProperties().at("crop_plan") == "2026");
+        // the same bag `fromFeatureCollection`/`fromFile` keep, "type": "field" included
+        CHECK(vector.getFieldProperties() == geoson::Vector::fromFeatureCollection(moved).getFieldProperties());
+
+        // without a key the boundary is removed and re-added
+        auto content = geoson::diff(moved, to);
+        REQUIRE(content.removed.size() == 1);
+        vector.applyPatch(content);
+        CHECK(vector.getFieldBoundary().getPoints()[1].x == 100.0);
+        CHECK(vector.getFieldProperties() == expected.getFieldProperties());
+        CHECK(vector.elementCount() == expected.elementCount());
+
+        geoson::FeaturePatch no_field;
+        no_field.removed = geoson::diff(to, moved).removed; // names the boundary the Vector has now
+        CHECK_THROWS_WITH(vector.applyPatch(no_field), doctest::Contains("field boundary"));
+    }
+}
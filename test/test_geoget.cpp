@@ -0,0 +1,191 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "geoget/geoget.hpp"
+#include <string>
+
+namespace {
+    std::string post(const std::string &path, const std::string &body, const std::string &extra = "") {
+        return "POST " + path + " HTTP/1.1\r\nHost: localhost\r\n" + extra +
+               "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+    }
+} // namespace
+
+TEST_CASE("Geoget - HTTP request framing") {
+    using geoget::http::Parse;
+    geoget::http::Request req;
+
+    SUBCASE("A request split across reads completes on its last byte") {
+        const std::string whole = post("/api/addpoint", R"({"lat":52.1,"lon":5.1})");
+        std::string in;
+        for (size_t i = 0; i + 1 < whole.size(); ++i) {
+            in += whole[i];
+            REQUIRE(geoget::http::take_request(in, req) == Parse::incomplete);
+        }
+        in += whole.back();
+        REQUIRE(geoget::http::take_request(in, req) == Parse::complete);
+        CHECK(req.method == "POST");
+        CHECK(req.path == "/api/addpoint");
+        CHECK(req.body == R"({"lat":52.1,"lon":5.1})");
+        CHECK(req.keep_alive);
+        CHECK(in.empty());
+    }
+
+    SUBCASE("Pipelined requests come off one at a time") {
+        std::string in = post("/api/addpoint", "{}") + "GET / HTTP/1.1\r\nHost: x\r\n\r\n" + post("/api/done", "");
+        REQUIRE(geoget::http::take_request(in, req) == Parse::complete);
+        CHECK(req.path == "/api/addpoint");
+        REQUIRE(geoget::http::take_request(in, req) == Parse::complete);
+        CHECK(req.method == "GET");
+        CHECK(req.body.empty());
+        REQUIRE(geoget::http::take_request(in, req) == Parse::complete);
+        CHECK(req.path == "/api/done");
+        CHECK(geoget::http::take_request(in, req) == Parse::incomplete);
+    }
+
+    SUBCASE("Connection handling") {
+        std::string in = post("/", "", "connection: Close\r\n");
+        REQUIRE(geoget::http::take_request(in, req) == Parse::complete);
+        CHECK_FALSE(req.keep_alive);
+
+        in = "GET / HTTP/1.0\r\n\r\n";
+        REQUIRE(geoget::http::take_request(in, req) == Parse::complete);
+        CHECK_FALSE(req.keep_alive);
+
+        in = "GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n";
+        REQUIRE(geoget::http::take_request(in, req) == Parse::complete);
+        CHECK(req.keep_alive);
+    }
+
+    SUBCASE("Malformed input") {
+        std::string in = "garbage\r\n\r\n";
+        CHECK(geoget::http::take_request(in, req) == Parse::bad);
+        in = std::string(64 * 1024, 'a');
+        CHECK(geoget::http::take_request(in, req) == Parse::bad);
+    }
+}
+
+TEST_CASE("Geoget - HTTP responses carry their length") {
+    auto out = geoget::http::Response::json(R"({"success":true})").serialize(true);
+    CHECK(out.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+    CHECK(out.find("Content-Length: 16\r\n") != std::string::npos);
+    CHECK(out.find("Connection: keep-alive\r\n\r\n{") != std::string::npos);
+
+    out = geoget::http::Response::error("404 Not Found", "Not Found").serialize(false);
+    CHECK(out.find("Connection: close\r\n") != std::string::npos);
+    CHECK(out.substr(out.size() - 9) == "Not Found");
+}
+
+TEST_CASE("Geoget - Sequencer restores post order") {
+    geoget::Sequencer<int> seq;
+    std::vector<int> applied;
+    auto apply = [&](int v) { applied.push_back(v); };
+
+    SUBCASE("Overtaken posts wait for the ones before them") {
+        seq.push("page", 2, 2, apply);
+        seq.push("page", 1, 1, apply);
+        CHECK(applied.empty());
+        CHECK(seq.waiting());
+        seq.push("page", 0, 0, apply);
+        CHECK(applied == std::vector<int>{0, 1, 2});
+        CHECK_FALSE(seq.waiting());
+        seq.push("page", 3, 3, apply);
+        CHECK(applied.back() == 3);
+    }
+
+    SUBCASE("A reloaded page starts over") {
+        seq.push("old", 0, 0, apply);
+        seq.push("old", 2, 2, apply);
+        seq.push("new", 0, 10, apply);
+        CHECK(applied == std::vector<int>{0, 2, 10});
+        CHECK_FALSE(seq.waiting());
+    }
+
+    SUBCASE("Flushing gives up on a gap") {
+        seq.push("page", 1, 1, apply);
+        seq.push("page", 3, 3, apply);
+        CHECK(seq.stalled(std::chrono::seconds(0)));
+        CHECK_FALSE(seq.stalled(std::chrono::hours(1)));
+        seq.flush(apply);
+        CHECK(applied == std::vector<int>{1, 3});
+        seq.push("page", 0, 0, apply); // a straggler is still applied
+        seq.push("page", 4, 4, apply);
+        CHECK(applied == std::vector<int>{1, 3, 0, 4});
+    }
+}
+
+TEST_CASE("Geoget - Static page responses") {
+    const std::string html = "<!DOCTYPE html><html><body>" + std::string(2000, 'x') + "</body></html>";
+    geoget::http::StaticPage page("text/html", html);
+    geoget::http::Request req;
+
+    std::string in = "GET / HTTP/1.1\r\nAccept-Encoding: gzip, deflate\r\nIf-None-Match: \"abc\"\r\n\r\n";
+    REQUIRE(geoget::http::take_request(in, req) == geoget::http::Parse::complete);
+    CHECK(req.accepts_gzip);
+    CHECK(req.if_none_match == "\"abc\"");
+
+    SUBCASE("Full response carries validators") {
+        req.accepts_gzip = false;
+        std::string out;
+        page.serve(req, true, out);
+        CHECK(out.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+        CHECK(out.find("ETag: " + page.etag() + "\r\n") != std::string::npos);
+        CHECK(out.find("Cache-Control: no-cache\r\n") != std::string::npos);
+        CHECK(out.find("Content-Encoding") == std::string::npos);
+        CHECK(out.substr(out.size() - html.size()) == html);
+    }
+
+    SUBCASE("Matching ETag is answered without a body") {
+        req.if_none_match = page.etag();
+        std::string out;
+        page.serve(req, false, out);
+        CHECK(out.rfind("HTTP/1.1 304 Not Modified\r\n", 0) == 0);
+        CHECK(out.find("Content-Length: 0\r\n") != std::string::npos);
+        CHECK(out.substr(out.size() - 4) == "\r\n\r\n"); // no body
+        CHECK(out.find("Connection: close\r\n") != std::string::npos);
+    }
+
+    SUBCASE("Accept-Encoding is read as a weighted list") {
+        using geoget::http::accepts_gzip;
+        CHECK(accepts_gzip("gzip"));
+        CHECK(accepts_gzip("deflate, GZIP;q=0.5"));
+        CHECK(accepts_gzip("br, *"));
+        CHECK(accepts_gzip("x-gzip"));
+        CHECK_FALSE(accepts_gzip("gzip;q=0"));
+        CHECK_FALSE(accepts_gzip("gzip; q=0.000, *"));
+        CHECK_FALSE(accepts_gzip("*, gzip;q=0"));
+        CHECK_FALSE(accepts_gzip("x-gzip-foo, deflate"));
+        CHECK_FALSE(accepts_gzip("identity"));
+        CHECK_FALSE(accepts_gzip("*;q=0"));
+        CHECK_FALSE(accepts_gzip(""));
+    }
+
+    SUBCASE("If-None-Match lists and weak tags") {
+        using geoget::http::matches_etag;
+        const std::string tag = page.etag();
+        CHECK(matches_etag(tag, tag));
+        CHECK(matches_etag("\"a,b\", W/" + tag, tag));
+        CHECK(matches_etag("W/" + tag, tag));
+        CHECK(matches_etag(" * ", tag));
+        CHECK_FALSE(matches_etag("\"other\"", tag));
+        CHECK_FALSE(matches_etag("\"x\"" + tag, tag));
+        CHECK_FALSE(matches_etag(tag.substr(0, tag.size() - 1), tag));
+
+        req.if_none_match = "\"stale\", W/" + tag;
+        std::string out;
+        page.serve(req, true, out);
+        CHECK(out.rfind("HTTP/1.1 304 Not Modified\r\n", 0) == 0);
+    }
+
+    SUBCASE("Gzip only when built with zlib") {
+        std::string out;
+        page.serve(req, true, out);
+#if GEOSON_USE_ZLIB
+        CHECK(out.find("Content-Encoding: gzip\r\n") != std::string::npos);
+        CHECK(out.size() < html.size());
+#else
+        CHECK(out.find("Content-Encoding") == std::string::npos);
+        CHECK(geoget::http::gzip(html).empty());
+#endif
+    }
+}
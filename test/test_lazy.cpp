@@ -0,0 +1,99 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "geoson/geoson.hpp"
+#include "geoson/lazy.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    // features before properties, as geoson writes them, plus a null geometry and a multi-geometry
+    const std::string document = R"({
+        "features": [
+            {"type": "Feature", "geometry": {"coordinates": [1, 2, 0], "type": "Point"},
+             "properties": {"type": "rock", "note": "a \"quoted\" {brace"}},
+            {"type": "Feature", "geometry": {"type": "MultiPoint", "coordinates": [[3, 4], [5, 6]]},
+             "properties": {"type": "tree", "id": 2}},
+            {"type": "Feature", "geometry": null, "properties": {"type": "ghost"}},
+            {"type": "Feature", "properties": {"type": "field", "area": 12.5},
+             "geometry": {"type": "Polygon", "coordinates": [[[0, 0], [4, 0], [4, 4], [0, 0]]]}}
+        ],
+        "properties": {"crs": "ENU", "datum": [52.0, 5.0, 0.0], "heading": 0.5, "field": "north"},
+        "type": "FeatureCollection"
+    })";
+} // namespace
+
+TEST_CASE("Lazy - Index without decoding") {
+    auto lc = geoson::LazyCollection::fromBuffer(document);
+
+    CHECK(lc.header().crs == geoson::CRS::ENU);
+    CHECK(lc.header().heading.yaw == doctest::Approx(0.5));
+    CHECK(lc.header().global_properties.at("field") == "north");
+
+    REQUIRE(lc.size() == 4);
+    CHECK(lc.geometryType(0) == "Point");
+    CHECK(lc.geometryType(1) == "MultiPoint");
+    CHECK(lc.geometryType(2).empty());
+    CHECK(lc.geometryType(3) == "Polygon");
+
+    for (size_t i = 0; i < lc.size(); ++i) {
+        REQUIRE(lc.offset(i).has_value());
+        CHECK(document.substr(*lc.offset(i), lc.text(i).size()) == lc.text(i));
+        CHECK(lc.text(i).front() == '{');
+        CHECK(lc.text(i).back() == '}');
+    }
+
+    CHECK(lc.property(0, "type") == "rock");
+    CHECK(lc.property(0, "note") == "a \"quoted\" {brace");
+    CHECK(lc.property(1, "id")->asInt() == 2);
+    CHECK(lc.property(3, "area")->asDouble() == 12.5);
+    CHECK_FALSE(lc.property(3, "missing").has_value());
+    CHECK(lc.properties(2).at("type") == "ghost");
+    CHECK_THROWS_AS(lc.text(4), std::out_of_range);
+}
+
+TEST_CASE("Lazy - Decoding on access") {
+    auto lc = geoson::LazyCollection::fromBuffer(document);
+
+    auto multi = lc.features(1);
+    REQUIRE(multi.size() == 2);
+    CHECK(std::get<concord::Point>(multi[1].geometry).x == 5.0);
+    CHECK(multi[0].properties.at("type") == "tree");
+    CHECK(lc.features(2).empty());
+    CHECK(std::holds_alternative<concord::Polygon>(lc.features(3).at(0).geometry));
+
+    auto all = lc.toFeatureCollection();
+    auto full = geoson::read_from_buffer(document);
+    std::ostringstream a, b;
+    geoson::WriteFeatureCollection(all, a);
+    geoson::WriteFeatureCollection(full, b);
+    CHECK(a.str() == b.str());
+}
+
+TEST_CASE("Lazy - Files") {
+    geoson::FeatureCollection fc;
+    fc.datum = concord::Datum{52.0, 5.0, 0.0};
+    fc.heading = concord::Euler{0, 0, 0};
+    fc.global_properties["name"] = "plot";
+    for (int i = 0; i < 50; ++i)
+        fc.features.push_back({concord::Point{double(i), 1.0, 0.0}, {{"id", i}}});
+
+    auto path = std::filesystem::temp_directory_path() / "geoson_lazy.geojson";
+    geoson::write(fc, path, geoson::CRS::WGS);
+
+    auto header = geoson::ReadCollectionHeader(path);
+    CHECK(header.crs == geoson::CRS::WGS);
+    CHECK(header.global_properties.at("name") == "plot");
+
+    auto lc = geoson::LazyCollection::open(path);
+    REQUIRE(lc.size() == 50);
+    CHECK(lc.geometryType(49) == "Point");
+    CHECK(lc.property(37, "id")->asInt() == 37);
+    auto moved = std::move(lc);
+    auto feature = moved.features(37).at(0);
+    CHECK(std::get<concord::Point>(feature.geometry).x == doctest::Approx(37.0).epsilon(1e-6));
+
+    std::filesystem::remove(path);
+    CHECK_THROWS(geoson::LazyCollection::open(path));
+}
@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <fstream>
 #include <nlohmann/json.hpp>
+#include <sstream>
 
 TEST_CASE("Parser - parseProperties") {
     SUBCASE("String properties") {
@@ -29,6 +30,23 @@ TEST_CASE("Parser - parseProperties") {
         CHECK(result["boolean"] == "true");
         CHECK(result["array"] == "[1,2,3]");
     }
+
+    SUBCASE("Values keep their JSON type") {
+        using Kind = geoson::PropertyValue::Kind;
+        auto props = nlohmann::json::parse(
+            R"({"s": "x", "i": -3, "u": 18446744073709551615, "d": 0.25, "b": false, "n": null, "o": {"k": 1}})");
+
+        auto result = geoson::parseProperties(props);
+
+        CHECK(result.at("s").kind() == Kind::String);
+        CHECK(result.at("i").asInt() == -3);
+        CHECK(result.at("u").kind() == Kind::Json); // beyond int64
+        CHECK(result.at("u") == "18446744073709551615");
+        CHECK(result.at("d").asDouble() == 0.25);
+        CHECK(result.at("b").kind() == Kind::Boolean);
+        CHECK(result.at("n") == "null");
+        CHECK(result.at("o") == R"({"k":1})");
+    }
 }
 
 TEST_CASE("Parser - parsePoint") {
@@ -239,3 +257,389 @@ TEST_CASE("Parser - File operations") {
         std::filesystem::remove(test_file);
     }
 }
+
+TEST_CASE("Parser - Streaming reader") {
+    const std::string header =
+        R"("properties": {"crs": "ENU", "datum": [52.0, 5.0, 0.0], "heading": 1.5, "owner": "wur"})";
+    const std::string features = R"("features": [
+        {"type": "Feature", "geometry": {"type": "Point", "coordinates": [1.0, 2.0, 3.0]}, "properties": {"id": 1}},
+        {"type": "Feature", "geometry": null, "properties": {"id": 2}},
+        {"type": "Feature", "geometry": {"type": "LineString", "coordinates": [[0, 0], [1, 1]]}, "properties": {}}
+    ])";
+
+    auto check = [](const geoson::FeatureCollection &fc) {
+        CHECK(fc.datum.lat == doctest::Approx(52.0));
+        CHECK(fc.heading.yaw == doctest::Approx(1.5));
+        CHECK(fc.global_properties.at("owner") == "wur");
+        REQUIRE(fc.features.size() == 2);
+        CHECK(std::get<concord::Point>(fc.features[0].geometry).z == doctest::Approx(3.0));
+        CHECK(fc.features[0].properties.at("id") == "1");
+        CHECK(std::holds_alternative<concord::Line>(fc.features[1].geometry));
+    };
+
+    SUBCASE("Header before features") {
+        std::istringstream is("{\"type\": \"FeatureCollection\", " + header + ", " + features + "}");
+        check(geoson::ReadFeatureCollection(is));
+    }
+
+    SUBCASE("Features before header (sorted keys, as written by geoson)") {
+        std::istringstream is("{" + features + ", " + header + ", \"type\": \"FeatureCollection\"}");
+        check(geoson::ReadFeatureCollection(is));
+    }
+
+    SUBCASE("Unknown top-level members are skipped") {
+        std::istringstream is("{\"bbox\": [0, 0, 1, 1], \"name\": \"a \\\"quoted\\\" }\", \"type\": "
+                              "\"FeatureCollection\", \"version\": 2, " +
+                              header + ", " + features + "}");
+        check(geoson::ReadFeatureCollection(is));
+    }
+
+    SUBCASE("Unseekable stream buffers out-of-order features") {
+        struct OneWay : std::streambuf {
+            std::string data;
+            explicit OneWay(std::string s) : data(std::move(s)) {
+                setg(data.data(), data.data(), data.data() + data.size());
+            }
+            pos_type seekoff(off_type, std::ios_base::seekdir, std::ios_base::openmode) override {
+                return pos_type(-1);
+            }
+        } buf("{" + features + ", " + header + ", \"type\": \"FeatureCollection\"}");
+        std::istream is(&buf);
+        check(geoson::ReadFeatureCollection(is));
+    }
+
+    SUBCASE("Large collections cross read-buffer boundaries") {
+        const std::filesystem::path test_file = "/tmp/test_streaming_large.geojson";
+        geoson::FeatureCollection fc{concord::Datum{52.0, 5.0, 0.0}, concord::Euler{0.0, 0.0, 0.0}, {}, {}};
+        for (int i = 0; i < 5000; ++i) {
+            fc.features.push_back(
+                geoson::Feature{concord::Point{i * 0.5, -i * 0.25, 1.0}, {{"id", std::to_string(i)}}});
+        }
+        geoson::WriteFeatureCollection(fc, test_file);
+        CHECK(std::filesystem::file_size(test_file) > (1 << 17));
+
+        auto loaded = geoson::ReadFeatureCollection(test_file);
+        REQUIRE(loaded.features.size() == 5000);
+        for (int i : {0, 1234, 4999}) {
+            CHECK(std::get<concord::Point>(loaded.features[i].geometry).x == doctest::Approx(i * 0.5));
+            CHECK(loaded.features[i].properties.at("id") == std::to_string(i));
+        }
+
+        std::filesystem::remove(test_file);
+    }
+
+    SUBCASE("Malformed feature surfaces a json parse error") {
+        std::istringstream is("{\"type\": \"FeatureCollection\", " + header +
+                              R"(, "features": [{"type": "Feature",}]})");
+        CHECK_THROWS_AS(geoson::ReadFeatureCollection(is), nlohmann::json::parse_error);
+    }
+
+    SUBCASE("Truncated document surfaces a json parse error") {
+        std::istringstream is("{\"type\": \"FeatureCollection\", " + header + ", \"features\": [");
+        CHECK_THROWS_AS(geoson::ReadFeatureCollection(is), nlohmann::json::parse_error);
+    }
+}
+
+TEST_CASE("Parser - Parallel reader") {
+    concord::Datum datum{52.0, 5.0, 0.0};
+    geoson::FeatureCollection fc{datum, concord::Euler{0.0, 0.0, 0.5}, {}, {{"owner", "wur"}}};
+    for (int i = 0; i < 20000; ++i) {
+        concord::Point p{i * 0.5, -i * 0.25, 1.0};
+        if (i % 3 == 0)
+            fc.features.push_back(geoson::Feature{p, {{"id", std::to_string(i)}}});
+        else
+            fc.features.push_back(
+                geoson::Feature{concord::Polygon{std::vector<concord::Point>{p, {p.x + 1, p.y, 0}, {p.x, p.y + 1, 0}}},
+                                {{"id", std::to_string(i)}}});
+    }
+    // header first (FeatureWriter) and features first (WriteFeatureCollection, sorted keys)
+    std::ostringstream header_first, sorted;
+    {
+        geoson::FeatureWriter writer(header_first, {geoson::CRS::WGS, datum, fc.heading, fc.global_properties});
+        for (auto const &f : fc.features)
+            writer.write(f);
+    }
+    geoson::WriteFeatureCollection(fc, sorted, geoson::CRS::WGS);
+    const std::string doc = header_first.str();
+
+    SUBCASE("Same result and order as the sequential read") {
+        for (auto const &text : {doc, sorted.str()}) {
+            std::istringstream seq_in(text), par_in(text);
+            auto seq = geoson::ReadFeatureCollection(seq_in);
+            auto par = geoson::ReadFeatureCollection(par_in, geoson::ReadOptions{4});
+            CHECK(par.global_properties == seq.global_properties);
+            REQUIRE(par.features.size() == seq.features.size());
+            bool same = true;
+            for (std::size_t i = 0; i < seq.features.size(); ++i) {
+                same = same && par.features[i].properties == seq.features[i].properties &&
+                       par.features[i].geometry.index() == seq.features[i].geometry.index();
+            }
+            CHECK(same);
+            CHECK(par.features.back().properties.at("id") == "19999");
+        }
+    }
+
+    SUBCASE("Zero threads uses the hardware concurrency") {
+        std::istringstream is(doc);
+        CHECK(geoson::ReadFeatureCollection(is, geoson::ReadOptions{0}).features.size() == 20000);
+    }
+
+    SUBCASE("Errors match the sequential read") {
+        // break one feature well inside the document, then truncate it further on
+        std::string bad = doc;
+        bad.replace(bad.find("\"id\":\"7000\""), 11, "\"id\":7000x");
+        std::istringstream is(bad);
+        CHECK_THROWS_AS(geoson::ReadFeatureCollection(is, geoson::ReadOptions{4}), nlohmann::json::parse_error);
+
+        std::istringstream truncated(doc.substr(0, doc.size() / 2));
+        CHECK_THROWS_AS(geoson::ReadFeatureCollection(truncated, geoson::ReadOptions{4}),
+                        nlohmann::json::parse_error);
+    }
+
+    SUBCASE("Feature errors surface before later scanning errors") {
+        std::string bad = doc.substr(0, doc.size() / 2);
+        bad.replace(bad.find("\"type\":\"Polygon\""), 16, "\"type\":17");
+        std::istringstream is(bad);
+        CHECK_THROWS_AS(geoson::ReadFeatureCollection(is, geoson::ReadOptions{4}), nlohmann::json::type_error);
+    }
+}
+
+TEST_CASE("Parser - Buffer and mapped-file input") {
+    const std::string doc = R"({"features": [
+        {"type": "Feature", "geometry": {"type": "Point", "coordinates": [1.0, 2.0, 3.0]}, "properties": {"id": 1}},
+        {"type": "Feature", "geometry": {"type": "MultiPoint", "coordinates": [[0, 0], [1, 1]]}, "properties": {}}
+    ], "properties": {"crs": "ENU", "datum": [52.0, 5.0, 0.0], "heading": 1.5}, "type": "FeatureCollection"})";
+
+    SUBCASE("read_from_buffer matches the stream reader") {
+        std::istringstream is(doc);
+        auto streamed = geoson::ReadFeatureCollection(is);
+        auto buffered = geoson::read_from_buffer(doc);
+        REQUIRE(buffered.features.size() == streamed.features.size());
+        REQUIRE(buffered.features.size() == 3);
+        CHECK(buffered.heading.yaw == doctest::Approx(1.5));
+        CHECK(std::get<concord::Point>(buffered.features[0].geometry).z == doctest::Approx(3.0));
+        CHECK(buffered.features[0].properties.at("id") == "1");
+        CHECK(geoson::read_from_buffer(doc, geoson::ReadOptions{2}).features.size() == 3);
+    }
+
+    SUBCASE("Buffer errors match the stream reader") {
+        CHECK_THROWS_AS(geoson::read_from_buffer(doc.substr(0, doc.size() - 20)), nlohmann::json::parse_error);
+        CHECK_THROWS_AS(geoson::read_from_buffer(""), nlohmann::json::parse_error);
+        CHECK_THROWS_WITH(geoson::read_from_buffer("[1, 2]"),
+                          "geoson::ReadFeatureCollection(): top-level object has no string 'type' field");
+    }
+
+    SUBCASE("Mapped files and the json loader") {
+        const std::filesystem::path test_file = "/tmp/test_mapped_input.geojson";
+        {
+            std::ofstream ofs(test_file, std::ios::binary);
+            ofs << doc;
+        }
+        CHECK(geoson::read(test_file).features.size() == 3);
+        CHECK(geoson::op::ReadFeatureCollection(test_file)["type"] == "FeatureCollection");
+
+        auto write = [&](const std::string &text) {
+            std::ofstream ofs(test_file, std::ios::binary | std::ios::trunc);
+            ofs << text;
+        };
+        const std::string point = R"({"type": "Point", "coordinates": [1, 2]})";
+        write(R"({"type": "Feature", "geometry": )" + point + R"(, "properties": {"n": 1}})");
+        auto feature = geoson::op::ReadFeatureCollection(test_file);
+        CHECK(feature["type"] == "FeatureCollection");
+        REQUIRE(feature["features"].size() == 1);
+        CHECK(feature["features"][0]["properties"]["n"] == 1);
+
+        write(point);
+        auto geometry = geoson::op::ReadFeatureCollection(test_file);
+        CHECK(geometry["type"] == "FeatureCollection");
+        REQUIRE(geometry["features"].size() == 1);
+        CHECK(geometry["features"][0]["geometry"]["type"] == "Point");
+
+        write("[1, 2, 3]");
+        CHECK_THROWS_WITH(geoson::op::ReadFeatureCollection(test_file),
+                          "geoson::ReadFeatureCollection(): top-level object has no string 'type' field");
+
+        std::ofstream(test_file, std::ios::trunc).close(); // empty files cannot be mapped and fall back to streaming
+        CHECK_THROWS_AS(geoson::read(test_file), nlohmann::json::parse_error);
+        std::filesystem::remove(test_file);
+    }
+}
+
+TEST_CASE("Parser - Split features share properties") {
+    concord::Datum datum{52.0, 5.0, 0.0};
+    nlohmann::json feat = {{"type", "Feature"},
+                           {"geometry", {{"type", "MultiPoint"}, {"coordinates", {{1, 2}, {3, 4}, {5, 6}}}}},
+                           {"properties", {{"sensor", "a"}, {"rate", 10}}}};
+
+    for (auto const &text : {std::string(), feat.dump()}) {
+        std::vector<geoson::Feature> out;
+        if (text.empty())
+            geoson::parseFeature(feat, datum, geoson::CRS::ENU, out);
+        else
+            geoson::parseFeatureText(text, *geoson::DatumTransform::shared(datum), geoson::CRS::ENU, out);
+        REQUIRE(out.size() == 3);
+        CHECK(out[1].properties.sharesWith(out[0].properties));
+        CHECK(out[2].properties.sharesWith(out[0].properties));
+        CHECK(out[2].properties.at("rate") == "10");
+
+        out[1].properties["sensor"] = "b"; // writing one sub-feature leaves its siblings alone
+        CHECK(out[0].properties.at("sensor") == "a");
+        CHECK(out[1].properties.at("sensor") == "b");
+        CHECK(out[2].properties.sharesWith(out[0].properties));
+    }
+}
+
+TEST_CASE("Parser - Feature text matches the json path") {
+    // holds for either parsing backend: the simdjson fast path must decode exactly what nlohmann decodes
+    geoson::DatumTransform tf(concord::Datum{52.0, 5.0, 0.0});
+
+    auto points = [](const geoson::Geometry &g) {
+        return std::visit(
+            [](auto const &v) -> std::vector<concord::Point> {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<T, concord::Point>)
+                    return {v};
+                else if constexpr (std::is_same_v<T, concord::Line>)
+                    return {v.getStart(), v.getEnd()};
+                else
+                    return v.getPoints();
+            },
+            g);
+    };
+
+    auto same = [&](const std::string &text, geoson::CRS crs) {
+        std::vector<geoson::Feature> fast, reference;
+        geoson::parseFeatureText(text, tf, crs, fast);
+        geoson::parseFeature(nlohmann::json::parse(text), tf, crs, reference);
+        REQUIRE(fast.size() == reference.size());
+        for (std::size_t i = 0; i < fast.size(); ++i) {
+            CHECK(fast[i].geometry.index() == reference[i].geometry.index());
+            CHECK(fast[i].properties == reference[i].properties);
+            auto a = points(fast[i].geometry), b = points(reference[i].geometry);
+            REQUIRE(a.size() == b.size());
+            for (std::size_t k = 0; k < a.size(); ++k) {
+                CHECK(a[k].x == b[k].x);
+                CHECK(a[k].y == b[k].y);
+                CHECK(a[k].z == b[k].z);
+            }
+        }
+    };
+
+    SUBCASE("Geometries and properties") {
+        const std::vector<std::string> docs = {
+            R"({"type":"Feature","geometry":{"type":"Point","coordinates":[5.01,52.01,3]},"properties":{"id":7}})",
+            R"({"geometry":{"coordinates":[[5,52],[5.1,52.1]],"type":"LineString"},"properties":{"n":-0,"f":1E2}})",
+            R"({"geometry":{"type":"LineString","coordinates":[[5,52],[5.1,52.1],[5.2,52]]},"properties":null})",
+            R"({"geometry":{"type":"Polygon","coordinates":[[[5,52],[5.1,52],[5.1,52.1]],[[0,0],[1,1]]]}})",
+            R"({"geometry":{"type":"MultiPoint","coordinates":[[5,52,1,9],[5.1,52.1]]},"properties":{"b":true}})",
+            R"({"geometry":{"type":"MultiLineString","coordinates":[[[5,52],[6,53]],[[5,52],[6,53],[7,54]]]}})",
+            R"({"geometry":{"type":"MultiPolygon","coordinates":[[[[5,52],[6,52],[6,53]]],[[[1,1],[2,2],[3,1]]]]}})",
+            R"({"geometry":{"type":"GeometryCollection","geometries":[{"type":"Point","coordinates":[1,2]}]}})",
+            R"({"geometry":{"type":"Point","coordinates":[1,2]},"properties":{"o":{"z":1,"a":[1.5,"x",null]}}})",
+            R"({"geometry":{"type":"Point","coordinates":[1,2]},"properties":{"s":"café \"q\"","k":"v","k":"w"}})",
+            R"({"geometry":{"type":"Point","coordinates":[1,2]},"geometry":{"type":"Point","coordinates":[3,4]}})",
+            R"({"geometry":{"type":"Point","coordinates":[18446744073709551616,2]}})",
+            R"({"geometry":{"type":"Curve","coordinates":"anything"},"properties":{"a":"b"}})",
+            R"({"geometry":null,"properties":{"a":"b"}})",
+            R"({"properties":{"a":"b"}})",
+            R"({"geometry":{"type":"Point","coordinates":[1,2]},"properties":"scalar"})",
+        };
+        for (auto const &doc : docs) {
+            CAPTURE(doc);
+            same(doc, geoson::CRS::ENU);
+            same(doc, geoson::CRS::WGS);
+        }
+    }
+
+    SUBCASE("Errors carry the json messages") {
+        const std::vector<std::string> docs = {
+            R"({"geometry":{"type":"Point","coordinates":[1,2]},)",
+            R"({"geometry":{"type":"Point","coordinates":[1,]}})",
+            R"({"geometry":{"type":"Point","coordinates":[1]}})",
+            R"({"geometry":{"type":"Point"}})",
+            R"({"geometry":{"coordinates":[1,2]}})",
+            R"({"geometry":{"type":"Point","coordinates":[1,2]},"properties":{"a":"\ud800"}})",
+            R"({"geometry":{"type":"Point","coordinates":[1e400,2]}})",
+            R"({"geometry":{"type":"Point","coordinates":[true,2]}})",
+            R"([1, 2])",
+        };
+        for (auto const &doc : docs) {
+            CAPTURE(doc);
+            std::string expected;
+            try {
+                std::vector<geoson::Feature> out;
+                geoson::parseFeature(nlohmann::json::parse(doc), tf, geoson::CRS::ENU, out);
+            } catch (const std::exception &e) {
+                expected = e.what();
+            }
+            REQUIRE_FALSE(expected.empty());
+            std::vector<geoson::Feature> out;
+            CHECK_THROWS_WITH(geoson::parseFeatureText(doc, tf, geoson::CRS::ENU, out), expected.c_str());
+            CHECK(out.empty());
+        }
+    }
+}
+
+TEST_CASE("Parser - Arena-backed reads") {
+    std::string doc = R"({"type": "FeatureCollection", "properties": {"crs": "ENU", "datum": [52.0, 5.0, 0.0],
+        "heading": 0.0}, "features": [)";
+    for (int i = 0; i < 3000; ++i) {
+        doc += (i ? "," : "");
+        doc += R"({"type": "Feature", "geometry": {"type": "MultiPoint", "coordinates": [[0, 0], [1, 1]]},
+            "properties": {"id": )" + std::to_string(i) + R"(, "name": "a name long enough to need the heap"}})";
+    }
+    doc += "]}";
+
+    auto plain = geoson::read_from_buffer(doc);
+    geoson::ReadOptions opts;
+    opts.arena = true;
+
+    SUBCASE("Same result as a heap read, sequential and parallel") {
+        for (unsigned threads : {1u, 3u}) {
+            opts.threads = threads;
+            auto fc = geoson::read_from_buffer(doc, opts);
+            REQUIRE(fc.features.size() == plain.features.size());
+            for (std::size_t i = 0; i < fc.features.size(); ++i)
+                CHECK(fc.features[i].properties == plain.features[i].properties);
+        }
+    }
+
+    SUBCASE("Features outlive their collection") {
+        for (unsigned threads : {1u, 3u}) {
+            opts.threads = threads;
+            geoson::Feature kept;
+            std::vector<geoson::Feature> moved;
+            {
+                auto fc = geoson::read_from_buffer(doc, opts);
+                kept = fc.features[4000];
+                moved.assign(std::make_move_iterator(fc.features.begin()),
+                             std::make_move_iterator(fc.features.begin() + 10));
+            }
+            CHECK(kept.properties.at("id").asInt() == 2000);
+            CHECK(moved[9].properties.at("id").asInt() == 4);
+            CHECK(moved[9].properties.at("name") == "a name long enough to need the heap");
+        }
+    }
+
+    SUBCASE("Modifying a feature afterwards moves its properties to the heap") {
+        geoson::Feature kept;
+        {
+            auto fc = geoson::read_from_buffer(doc, opts);
+            kept = fc.features[4000];
+            kept.properties["id"] = 7;
+            kept.properties["extra"] = "added after the read";
+            CHECK(fc.features[4000].properties.at("id").asInt() == 2000);
+        }
+        CHECK(kept.properties.at("id").asInt() == 7);
+        CHECK(kept.properties.size() == 3);
+        CHECK(kept.properties.at("name") == "a name long enough to need the heap");
+    }
+
+    SUBCASE("The calling thread goes back to the heap afterwards") {
+        geoson::read_from_buffer(doc, opts);
+        CHECK(geoson::op::currentArena() == nullptr);
+        geoson::Properties p;
+        p["k"] = "v";
+        CHECK(p.at("k") == "v");
+    }
+}
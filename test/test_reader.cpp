@@ -0,0 +1,154 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "geoson/geoson.hpp"
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+
+namespace {
+    const std::string header_first = R"({
+        "type": "FeatureCollection",
+        "properties": {"crs": "ENU", "datum": [52.0, 5.0, 0.0], "heading": 0.5, "field": "north"},
+        "features": [
+            {"type": "Feature", "geometry": {"type": "Point", "coordinates": [1, 2, 0]}, "properties": {"type": "rock"}},
+            {"type": "Feature", "geometry": {"type": "MultiPoint", "coordinates": [[3, 4], [5, 6]]},
+             "properties": {"type": "tree"}},
+            {"type": "Feature", "geometry": {"type": "Point", "coordinates": [7, 8]}, "properties": {"type": "rock"}}
+        ]
+    })";
+} // namespace
+
+TEST_CASE("Reader - FeatureReader") {
+    SUBCASE("Header is available before any feature") {
+        std::istringstream is(header_first);
+        geoson::FeatureReader reader(is);
+
+        CHECK(reader.header().crs == geoson::CRS::ENU);
+        CHECK(reader.header().datum.lat == doctest::Approx(52.0));
+        CHECK(reader.header().heading.yaw == doctest::Approx(0.5));
+        CHECK(reader.header().global_properties.at("field") == "north");
+    }
+
+    SUBCASE("Iterates features in file order, expanding multi-geometries") {
+        std::istringstream is(header_first);
+        geoson::FeatureReader reader(is);
+
+        std::vector<double> xs;
+        for (const auto &feature : reader) {
+            xs.push_back(std::get<concord::Point>(feature.geometry).x);
+        }
+        CHECK(xs == std::vector<double>{1, 3, 5, 7});
+    }
+
+    SUBCASE("next() pulls one feature at a time") {
+        std::istringstream is(header_first);
+        geoson::FeatureReader reader(is);
+
+        geoson::Feature feature;
+        REQUIRE(reader.next(feature));
+        CHECK(feature.properties.at("type") == "rock");
+        REQUIRE(reader.next(feature));
+        CHECK(feature.properties.at("type") == "tree");
+        REQUIRE(reader.next(feature));
+        REQUIRE(reader.next(feature));
+        CHECK_FALSE(reader.next(feature));
+    }
+
+    SUBCASE("Reads files written by WriteFeatureCollection") {
+        const std::filesystem::path test_file = "/tmp/test_reader_roundtrip.geojson";
+        geoson::FeatureCollection fc{concord::Datum{52.0, 5.0, 0.0}, concord::Euler{0.0, 0.0, 1.0}, {}, {}};
+        fc.features.push_back(geoson::Feature{concord::Point{1.0, 2.0, 3.0}, {{"name", "a"}}});
+        fc.features.push_back(geoson::Feature{concord::Point{4.0, 5.0, 6.0}, {{"name", "b"}}});
+        geoson::WriteFeatureCollection(fc, test_file);
+
+        geoson::FeatureReader reader(test_file);
+        CHECK(reader.header().heading.yaw == doctest::Approx(1.0));
+        std::vector<std::string> names;
+        for (const auto &feature : reader) {
+            names.push_back(feature.properties.at("name"));
+        }
+        CHECK(names == std::vector<std::string>{"a", "b"});
+
+        std::filesystem::remove(test_file);
+    }
+
+    SUBCASE("Nonexistent file throws") {
+        CHECK_THROWS_WITH(geoson::FeatureReader("/nonexistent/file.geojson"),
+                          doctest::Contains("geoson::FeatureReader(): cannot open"));
+    }
+
+    SUBCASE("Header validation matches ReadFeatureCollection") {
+        std::istringstream is(R"({"type": "FeatureCollection", "features": []})");
+        CHECK_THROWS_WITH(geoson::FeatureReader{is}, "missing top-level 'properties'");
+    }
+}
+
+TEST_CASE("Reader - for_each_feature") {
+    const std::filesystem::path test_file = "/tmp/test_for_each_feature.geojson";
+    std::ofstream ofs(test_file);
+    ofs << header_first;
+    ofs.close();
+
+    SUBCASE("Visits every feature") {
+        size_t count = 0;
+        geoson::for_each_feature(test_file, [&](const geoson::Feature &) { ++count; });
+        CHECK(count == 4);
+    }
+
+    SUBCASE("Returning false stops early") {
+        size_t visited = 0;
+        std::optional<concord::Point> first_tree;
+        geoson::for_each_feature(test_file, [&](const geoson::Feature &feature) {
+            ++visited;
+            if (feature.properties.at("type") == "tree") {
+                first_tree = std::get<concord::Point>(feature.geometry);
+                return false;
+            }
+            return true;
+        });
+        CHECK(visited == 2);
+        REQUIRE(first_tree.has_value());
+        CHECK(first_tree->x == doctest::Approx(3.0));
+    }
+
+    SUBCASE("Early exit does not read past the matching feature") {
+        // everything after the first feature is garbage; stopping early must never reach it
+        std::istringstream is(R"({"type": "FeatureCollection",
+            "properties": {"crs": "ENU", "datum": [52.0, 5.0, 0.0], "heading": 0.0},
+            "features": [{"type": "Feature", "geometry": {"type": "Point", "coordinates": [1, 2]}}, %%%%)");
+        size_t visited = 0;
+        CHECK_NOTHROW(geoson::ForEachFeature(is, [&](const geoson::Feature &) {
+            ++visited;
+            return false;
+        }));
+        CHECK(visited == 1);
+    }
+
+    std::filesystem::remove(test_file);
+}
+
+TEST_CASE("Reader - In-memory documents") {
+    const std::string doc = R"({"type": "FeatureCollection",
+        "properties": {"crs": "ENU", "datum": [52.0, 5.0, 0.0], "heading": 0.0},
+        "features": [
+            {"type": "Feature", "geometry": {"type": "Point", "coordinates": [1, 2, 3]}, "properties": {"id": "a"}},
+            {"type": "Feature", "geometry": {"type": "Point", "coordinates": [4, 5, 6]}, "properties": {"id": "b"}}
+        ]})";
+
+    SUBCASE("FeatureReader::fromBuffer") {
+        auto reader = geoson::FeatureReader::fromBuffer(doc);
+        CHECK(reader.header().crs == geoson::CRS::ENU);
+        std::vector<std::string> ids;
+        for (auto const &feature : reader)
+            ids.push_back(feature.properties.at("id"));
+        CHECK(ids == std::vector<std::string>{"a", "b"});
+    }
+
+    SUBCASE("ForEachFeatureInBuffer stops early") {
+        int seen = 0;
+        geoson::ForEachFeatureInBuffer(doc, [&](const geoson::Feature &) { return ++seen < 1; });
+        CHECK(seen == 1);
+    }
+}
@@ -0,0 +1,148 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "geoson/geoson.hpp"
+#include "geoson/vector.hpp"
+#include <filesystem>
+#include <sstream>
+
+namespace {
+    geoson::FeatureCollection sample() {
+        geoson::FeatureCollection fc;
+        fc.datum = concord::Datum{52.0, 5.0, 0.0};
+        fc.heading = concord::Euler{0, 0, 0};
+        fc.features.push_back(
+            {concord::Polygon({{0, 0, 0}, {10, 0, 0}, {10, 10, 0}, {0, 10, 0}}), {{"type", "field"}}});
+        for (int i = 0; i < 20; ++i)
+            fc.features.push_back({concord::Point{double(i), 1.0, 0.0}, {{"type", "marker"}, {"id", i}}});
+        fc.features.push_back({concord::Path({{0, 0, 0}, {1, 1, 0}, {2, 1, 0}}), {{"type", "row"}}});
+        return fc;
+    }
+
+    constexpr uint64_t sample_coordinates = 4 + 20 + 3;
+} // namespace
+
+TEST_CASE("Stats - Reading") {
+    const auto fc = sample();
+
+    SUBCASE("Counts and phases of a WGS read") {
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(fc, os, geoson::CRS::WGS);
+        const std::string text = os.str();
+
+        geoson::Stats stats;
+        {
+            geoson::StatsScope scope(stats);
+            auto back = geoson::read_from_buffer(text);
+            CHECK(back.features.size() == fc.features.size());
+        }
+        CHECK(stats.bytes_read == text.size());
+        CHECK(stats.features == fc.features.size());
+        CHECK(stats.coordinates == sample_coordinates);
+        CHECK(stats.read_ns > 0);
+        CHECK(stats.dom_ns > 0);
+        CHECK(stats.geometry_ns > 0);
+        CHECK(stats.crs_ns > 0);
+        CHECK(stats.geometry_ns >= stats.crs_ns);
+        CHECK(stats.properties_ns > 0);
+        CHECK(stats.bytes_written == 0);
+        CHECK(stats.serialize_ns == 0);
+    }
+
+    SUBCASE("Parallel reads add up the workers") {
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(fc, os);
+        geoson::ReadOptions opts;
+        opts.threads = 4;
+
+        geoson::Stats stats;
+        geoson::StatsScope scope(stats);
+        geoson::read_from_buffer(os.str(), opts);
+        CHECK(stats.features == fc.features.size());
+        CHECK(stats.coordinates == sample_coordinates);
+        CHECK(stats.crs_ns == 0); // ENU input needs no conversion
+        CHECK(stats.geometry_ns > 0);
+    }
+
+    SUBCASE("Vector::fromFile") {
+        auto path = std::filesystem::temp_directory_path() / "geoson_stats_vector.geojson";
+        geoson::write(fc, path);
+
+        geoson::Stats stats;
+        {
+            geoson::StatsScope scope(stats);
+            auto vector = geoson::Vector::fromFile(path);
+            CHECK(vector.elementCount() == fc.features.size() - 1);
+        }
+        CHECK(stats.bytes_read == std::filesystem::file_size(path) - 1); // all but the trailing newline
+        CHECK(stats.features == fc.features.size());
+        CHECK(stats.read_ns > 0);
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("Stats - Writing") {
+    const auto fc = sample();
+    geoson::Stats stats;
+    std::string text;
+    {
+        geoson::StatsScope scope(stats);
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(fc, os, geoson::CRS::WGS);
+        text = os.str();
+    }
+    CHECK(stats.bytes_written == text.size());
+    CHECK(stats.features == fc.features.size());
+    CHECK(stats.coordinates == sample_coordinates);
+    CHECK(stats.serialize_ns > 0);
+    CHECK(stats.serialize_ns >= stats.crs_ns);
+    CHECK(stats.crs_ns > 0);
+    CHECK(stats.bytes_read == 0);
+}
+
+TEST_CASE("Stats - Scopes") {
+    const auto fc = sample();
+    std::ostringstream os;
+    geoson::WriteFeatureCollection(fc, os);
+    const std::string text = os.str();
+
+    geoson::Stats outer, inner;
+    {
+        geoson::StatsScope a(outer);
+        geoson::read_from_buffer(text);
+        {
+            geoson::StatsScope b(inner);
+            geoson::read_from_buffer(text);
+            geoson::read_from_buffer(text);
+            geoson::countAllocation();
+        }
+        geoson::read_from_buffer(text);
+    }
+    geoson::read_from_buffer(text); // no scope: nothing recorded
+    geoson::countAllocation();
+
+    CHECK(outer.features == 2 * fc.features.size());
+    CHECK(inner.features == 2 * fc.features.size());
+    CHECK(inner.allocations == 1);
+    CHECK(outer.allocations == 0);
+
+    geoson::Stats sum = outer;
+    sum += inner;
+    CHECK(sum.bytes_read == 4 * text.size());
+}
+
+TEST_CASE("Stats - Conversions") {
+    const auto tf = geoson::DatumTransform::shared(concord::Datum{52.0, 5.0, 0.0});
+    geoson::Stats stats;
+    geoson::StatsScope scope(stats);
+
+    const concord::Point enu = tf->toENU(concord::WGS{52.001, 5.001, 2.0});
+    const concord::WGS back = tf->toWGS(enu);
+    CHECK(back.lat == doctest::Approx(52.001));
+    CHECK(back.lon == doctest::Approx(5.001));
+    CHECK(stats.crs_ns == 0); // single points are not worth two clock reads
+
+    std::vector<concord::Point> pts(1000, enu);
+    tf->toWGS(pts.data(), pts.size());
+    CHECK(stats.crs_ns > 0);
+}
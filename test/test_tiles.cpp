@@ -0,0 +1,148 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "geoson/geoson.hpp"
+#include <filesystem>
+
+namespace {
+    geoson::FeatureCollection sample() {
+        geoson::FeatureCollection fc;
+        fc.datum = concord::Datum{52.0, 5.0, 0.0};
+        fc.global_properties["name"] = "tiles";
+
+        geoson::Properties a;
+        a["name"] = "pt";
+        fc.features.push_back({concord::Point{10.0, 10.0, 0.0}, a});
+        fc.features.push_back({concord::Point{150.0, 30.0, 0.0}, {}});
+        // crosses x = 100 once
+        fc.features.push_back({concord::Line{concord::Point{50, 50, 0}, concord::Point{150, 50, 2}}, {}});
+        // out of (0, 0), through (1, 0), back into (0, 0)
+        fc.features.push_back(
+            {concord::Path{std::vector<concord::Point>{{50, 20, 0}, {150, 20, 0}, {150, 80, 0}, {50, 80, 0}}}, {}});
+        geoson::Properties b;
+        b["crop"] = "wheat";
+        std::vector<concord::Point> ring{{80, 80, 0}, {120, 80, 0}, {120, 120, 0}, {80, 120, 0}, {80, 80, 0}};
+        fc.features.push_back({concord::Polygon{ring}, b});
+        return fc;
+    }
+
+    std::filesystem::path scratch(const std::string &name) {
+        auto dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(dir);
+        return dir;
+    }
+
+    const geoson::TileInfo *find(const std::vector<geoson::TileInfo> &tiles, std::int64_t x, std::int64_t y) {
+        for (auto const &t : tiles)
+            if (t.x == x && t.y == y)
+                return &t;
+        return nullptr;
+    }
+} // namespace
+
+TEST_CASE("Tiles - ENU grid") {
+    const auto fc = sample();
+
+    SUBCASE("Duplicate writes straddling features whole to every tile they touch") {
+        auto dir = scratch("geoson_tiles_dup");
+        auto tiles = geoson::WriteTiles(fc, dir);
+        REQUIRE(tiles.size() == 4);
+        CHECK(find(tiles, 0, 0)->features == 4);
+        CHECK(find(tiles, 1, 0)->features == 4);
+        CHECK(find(tiles, 0, 1)->features == 1);
+        CHECK(find(tiles, 1, 1)->features == 1);
+        CHECK(find(tiles, 1, 0)->path == dir / "1_0.geojson");
+
+        auto back = geoson::ReadFeatureCollection(dir / "0_0.geojson");
+        CHECK(back.features.size() == 4);
+        CHECK(back.datum.lat == doctest::Approx(fc.datum.lat));
+        CHECK(back.global_properties.at("name") == "tiles");
+        REQUIRE(std::holds_alternative<concord::Polygon>(back.features.back().geometry));
+        CHECK(std::get<concord::Polygon>(back.features.back().geometry).getPoints().size() == 5);
+        std::filesystem::remove_all(dir);
+    }
+
+    SUBCASE("Clip cuts straddling features at the tile edges") {
+        auto dir = scratch("geoson_tiles_clip");
+        geoson::TileOptions opts;
+        opts.straddle = geoson::TileStraddle::Clip;
+        opts.threads = 4;
+        auto tiles = geoson::WriteTiles(fc, dir, opts);
+        REQUIRE(tiles.size() == 4);
+
+        auto origin = geoson::ReadFeatureCollection(find(tiles, 0, 0)->path);
+        // point, line half, two path pieces, polygon quarter
+        REQUIRE(origin.features.size() == 5);
+        CHECK(origin.features[0].properties.at("name").asString() == "pt");
+        auto const &line = std::get<concord::Line>(origin.features[1].geometry);
+        CHECK(line.getEnd().x == doctest::Approx(100.0));
+        CHECK(line.getEnd().z == doctest::Approx(1.0));
+        // two-point LineStrings read back as Lines
+        CHECK(std::get<concord::Line>(origin.features[2].geometry).getEnd().x == doctest::Approx(100.0));
+        CHECK(std::get<concord::Line>(origin.features[3].geometry).getStart().x == doctest::Approx(100.0));
+        auto const &quarter = std::get<concord::Polygon>(origin.features[4].geometry).getPoints();
+        REQUIRE(quarter.size() == 5);
+        for (auto const &p : quarter) {
+            CHECK(p.x >= 80.0 - 1e-6);
+            CHECK(p.x <= 100.0 + 1e-6);
+            CHECK(p.y >= 80.0 - 1e-6);
+            CHECK(p.y <= 100.0 + 1e-6);
+        }
+        CHECK(origin.features[4].properties.at("crop").asString() == "wheat");
+
+        // the second point, the line's other half, one three-point path piece and a polygon quarter
+        auto east = geoson::ReadFeatureCollection(find(tiles, 1, 0)->path);
+        REQUIRE(east.features.size() == 4);
+        CHECK(std::get<concord::Line>(east.features[1].geometry).getStart().x == doctest::Approx(100.0));
+        CHECK(std::get<concord::Path>(east.features[2].geometry).getPoints().size() == 4);
+        std::filesystem::remove_all(dir);
+    }
+
+    SUBCASE("Binary tiles read back") {
+        auto dir = scratch("geoson_tiles_bin");
+        geoson::TileOptions opts;
+        opts.tile_size = 1000.0;
+        opts.format = geoson::TileFormat::Binary;
+        auto tiles = geoson::WriteTiles(fc, dir, opts);
+        REQUIRE(tiles.size() == 1);
+        CHECK(tiles[0].path == dir / "0_0.gsb");
+        auto back = geoson::ReadBinaryCollection(tiles[0].path);
+        CHECK(back.features.size() == fc.features.size());
+        std::filesystem::remove_all(dir);
+    }
+
+    SUBCASE("Rejects a non-positive tile size") {
+        geoson::TileOptions opts;
+        opts.tile_size = 0.0;
+        CHECK_THROWS_AS(geoson::WriteTiles(fc, scratch("geoson_tiles_bad"), opts), std::invalid_argument);
+    }
+
+    SUBCASE("Rejects a feature without positions, naming it, before writing anything") {
+        auto holed = fc;
+        holed.features.insert(holed.features.begin() + 2, geoson::Feature{concord::Path{}, {}});
+        auto dir = scratch("geoson_tiles_empty");
+        CHECK_THROWS_AS(geoson::WriteTiles(holed, dir), std::invalid_argument);
+        CHECK_THROWS_WITH(geoson::WriteTiles(holed, dir), "geoson::WriteTiles(): feature 2 has no positions");
+        CHECK_FALSE(std::filesystem::exists(dir));
+    }
+}
+
+TEST_CASE("Tiles - Web Mercator z/x/y") {
+    geoson::FeatureCollection fc;
+    fc.datum = concord::Datum{52.0, 5.0, 0.0};
+    fc.features.push_back({concord::Point{0.0, 0.0, 0.0}, {}});
+
+    auto dir = scratch("geoson_tiles_xyz");
+    geoson::TileOptions opts;
+    opts.scheme = geoson::TileScheme::WebMercator;
+    opts.zoom = 10;
+    auto tiles = geoson::WriteTiles(fc, dir, opts);
+    REQUIRE(tiles.size() == 1);
+    // lon 5, lat 52 at zoom 10
+    CHECK(tiles[0].z == 10);
+    CHECK(tiles[0].x == 526);
+    CHECK(tiles[0].y == 338);
+    CHECK(tiles[0].path == dir / "10" / "526" / "338.geojson");
+    CHECK(std::filesystem::exists(tiles[0].path));
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,123 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "geoson/geoson.hpp"
+#include <cmath>
+#include <vector>
+
+TEST_CASE("Transform - DatumTransform batch conversion") {
+    const std::vector<concord::Datum> datums = {
+        {52.0, 5.0, 0.0}, {-33.9, 151.2, 40.0}, {0.0, 179.99, 0.0}, {78.2, 15.6, -20.0}};
+
+    for (auto const &datum : datums) {
+        geoson::DatumTransform tf(datum);
+
+        // a few hundred points, more than one internal block, spread over ~10 km around the datum
+        std::vector<double> lon, lat, alt;
+        for (int i = 0; i < 300; ++i) {
+            lon.push_back(datum.lon + 0.05 * std::sin(i * 0.37));
+            lat.push_back(datum.lat + 0.05 * std::cos(i * 0.11));
+            alt.push_back(datum.alt + 10.0 * std::sin(i * 0.05));
+        }
+        const std::size_t n = lon.size();
+
+        SUBCASE("Matches concord per point") {
+            std::vector<double> x(n), y(n), z(n);
+            tf.toENU(n, lon.data(), lat.data(), alt.data(), x.data(), y.data(), z.data());
+            for (std::size_t i = 0; i < n; ++i) {
+                concord::ENU enu = concord::WGS{lat[i], lon[i], alt[i]}.toENU(datum);
+                CHECK(x[i] == doctest::Approx(enu.x).epsilon(1e-9).scale(1.0));
+                CHECK(y[i] == doctest::Approx(enu.y).epsilon(1e-9).scale(1.0));
+                CHECK(z[i] == doctest::Approx(enu.z).epsilon(1e-9).scale(1.0));
+            }
+        }
+
+        SUBCASE("Round trip in place") {
+            std::vector<concord::Point> pts;
+            for (std::size_t i = 0; i < n; ++i)
+                pts.emplace_back(lon[i], lat[i], alt[i]);
+            tf.toENU(pts.data(), pts.size());
+            tf.toWGS(pts.data(), pts.size());
+            for (std::size_t i = 0; i < n; ++i) {
+                CHECK(std::abs(pts[i].x - lon[i]) < 1e-10);
+                CHECK(std::abs(pts[i].y - lat[i]) < 1e-10);
+                CHECK(std::abs(pts[i].z - alt[i]) < 1e-6);
+            }
+        }
+    }
+
+    SUBCASE("Datum maps to the origin") {
+        concord::Datum datum{52.0, 5.0, 12.0};
+        geoson::DatumTransform tf(datum);
+        concord::Point p{datum.lon, datum.lat, datum.alt};
+        tf.toENU(&p, 1);
+        CHECK(std::abs(p.x) < 1e-6);
+        CHECK(std::abs(p.y) < 1e-6);
+        CHECK(std::abs(p.z) < 1e-6);
+    }
+
+    SUBCASE("Empty batch") {
+        geoson::DatumTransform tf(concord::Datum{52.0, 5.0, 0.0});
+        tf.toENU(nullptr, 0);
+        tf.toWGS(0, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+    }
+}
+
+TEST_CASE("Transform - Shared DatumTransform") {
+    concord::Datum datum{52.0, 5.0, 0.0};
+
+    SUBCASE("Same datum shares one instance") {
+        auto a = geoson::DatumTransform::shared(datum);
+        auto b = geoson::DatumTransform::shared(concord::Datum{52.0, 5.0, 0.0});
+        auto c = geoson::DatumTransform::shared(concord::Datum{52.0, 5.0, 1.0});
+        CHECK(a == b);
+        CHECK(a != c);
+        CHECK(a->is(datum));
+        CHECK_FALSE(c->is(datum));
+    }
+
+    SUBCASE("Cache keeps working past its capacity") {
+        auto first = geoson::DatumTransform::shared(datum);
+        for (int i = 0; i < 20; ++i)
+            CHECK(geoson::DatumTransform::shared(concord::Datum{10.0 + i, 5.0, 0.0})->datum().lat == 10.0 + i);
+        auto again = geoson::DatumTransform::shared(datum);
+        CHECK(again->is(datum));
+        CHECK(first->is(datum)); // evicted instances stay valid for their holders
+    }
+
+    SUBCASE("Point conversions match the batch calls") {
+        auto tf = geoson::DatumTransform::shared(datum);
+        concord::WGS wgs{52.1, 5.1, 10.0};
+        concord::Point p = tf->toENU(wgs);
+        concord::ENU enu = wgs.toENU(datum);
+        CHECK(p.x == doctest::Approx(enu.x).epsilon(1e-9).scale(1.0));
+        CHECK(p.y == doctest::Approx(enu.y).epsilon(1e-9).scale(1.0));
+        CHECK(p.z == doctest::Approx(enu.z).epsilon(1e-9).scale(1.0));
+
+        concord::WGS back = tf->toWGS(p);
+        CHECK(back.lat == doctest::Approx(52.1).epsilon(1e-12));
+        CHECK(back.lon == doctest::Approx(5.1).epsilon(1e-12));
+        CHECK(back.alt == doctest::Approx(10.0).epsilon(1e-9));
+    }
+}
+
+TEST_CASE("Transform - Frame change between datums") {
+    const geoson::DatumTransform from(concord::Datum{52.0, 5.0, 10.0}), to(concord::Datum{51.9, 5.3, -20.0});
+    std::vector<concord::Point> pts{{0, 0, 0}, {1500.0, -250.0, 3.5}, {-40000.0, 25000.0, 100.0}};
+
+    // reference: through geodetic coordinates and back
+    auto expected = pts;
+    from.toWGS(expected.data(), expected.size());
+    to.toENU(expected.data(), expected.size());
+
+    from.toFrame(to, pts.data(), pts.size());
+    for (size_t i = 0; i < pts.size(); ++i) {
+        CHECK(pts[i].x == doctest::Approx(expected[i].x).epsilon(1e-9).scale(1.0));
+        CHECK(pts[i].y == doctest::Approx(expected[i].y).epsilon(1e-9).scale(1.0));
+        CHECK(pts[i].z == doctest::Approx(expected[i].z).epsilon(1e-6).scale(1.0));
+    }
+
+    to.toFrame(from, pts.data(), pts.size());
+    CHECK(pts[1].x == doctest::Approx(1500.0).epsilon(1e-9));
+    CHECK(pts[2].y == doctest::Approx(25000.0).epsilon(1e-9));
+}
@@ -134,3 +134,130 @@ TEST_CASE("Types - FeatureCollection") {
     CHECK(std::holds_alternative<concord::Line>(fc.features[1].geometry));
     CHECK(fc.features[1].properties["name"] == "test_line");
 }
+
+TEST_CASE("Types - Properties") {
+    SUBCASE("Copies share until written") {
+        geoson::Properties a{{"name", "field"}, {"id", "1"}};
+        geoson::Properties b = a;
+        CHECK(b.sharesWith(a));
+        CHECK(b == a);
+        CHECK(b.at("name") == "field"); // reads never detach
+        CHECK(b.find("id") != b.end());
+        CHECK(b.sharesWith(a));
+
+        b["name"] = "row";
+        CHECK_FALSE(b.sharesWith(a));
+        CHECK(a.at("name") == "field");
+        CHECK(b.at("name") == "row");
+        CHECK_FALSE(b == a);
+    }
+
+    SUBCASE("A reference from operator[] never reaches a later copy") {
+        geoson::Properties p{{"a", "1"}};
+        auto &r = p["a"];
+        geoson::Properties q = p;
+        geoson::Properties s;
+        s = p;
+        r = "changed";
+        CHECK(p.at("a") == "changed");
+        CHECK(q.at("a") == "1");
+        CHECK(s.at("a") == "1");
+        CHECK_FALSE(q.sharesWith(p));
+
+        // copies of the copy share again, and so does the original once cleared
+        geoson::Properties t = q;
+        CHECK(t.sharesWith(q));
+        p.clear();
+        p.insert_or_assign("b", 2);
+        geoson::Properties u = p;
+        CHECK(u.sharesWith(p));
+    }
+
+    SUBCASE("Behaves like the string map it wraps") {
+        geoson::Properties p;
+        CHECK(p.empty());
+        CHECK(p.find("x") == p.end());
+        p.insert({"x", "1"});
+        p.emplace("y", "2");
+        p.insert_or_assign("x", "3");
+        CHECK(p.size() == 2);
+        CHECK(p.contains("x"));
+        CHECK(p.count("y") == 1);
+        CHECK(p.erase("y") == 1);
+
+        std::unordered_map<std::string, std::string> m = p;
+        CHECK(m == std::unordered_map<std::string, std::string>{{"x", "3"}});
+        CHECK(p == geoson::Properties(m));
+
+        geoson::Properties q = p;
+        q.clear();
+        CHECK(q.empty());
+        CHECK(p.size() == 1);
+    }
+}
+
+TEST_CASE("Types - Property values and keys") {
+    using Kind = geoson::PropertyValue::Kind;
+
+    SUBCASE("Kinds and text form") {
+        CHECK(geoson::PropertyValue("a").kind() == Kind::String);
+        CHECK(geoson::PropertyValue(3).kind() == Kind::Integer);
+        CHECK(geoson::PropertyValue(2.5).kind() == Kind::Number);
+        CHECK(geoson::PropertyValue(true).kind() == Kind::Boolean);
+        CHECK(geoson::PropertyValue::fromJson("[1,2]").kind() == Kind::Json);
+
+        CHECK(geoson::PropertyValue(3).str() == "3");
+        CHECK(geoson::PropertyValue(2.0).str() == "2.0");
+        CHECK(geoson::PropertyValue(false).str() == "false");
+        CHECK(geoson::PropertyValue(3) == "3"); // text comparison, as with the untyped map
+        CHECK_FALSE(geoson::PropertyValue(3) == geoson::PropertyValue("3"));
+    }
+
+    SUBCASE("Typed access") {
+        CHECK(geoson::PropertyValue(3).asInt() == 3);
+        CHECK(geoson::PropertyValue(3).asDouble() == 3.0);
+        CHECK(geoson::PropertyValue(true).asBool());
+        CHECK(geoson::PropertyValue("x").asString() == "x");
+        CHECK_THROWS_AS(geoson::PropertyValue("x").asInt(), std::runtime_error);
+        CHECK_THROWS_AS(geoson::PropertyValue(1.5).asBool(), std::runtime_error);
+    }
+
+    SUBCASE("Keys are interned") {
+        geoson::PropertyKey a("crop"), b(std::string("crop"));
+        CHECK(&a.str() == &b.str());
+        CHECK(a == b);
+        CHECK(a == "crop");
+        CHECK_FALSE(a == geoson::PropertyKey("crops"));
+
+        geoson::Properties p{{"crop", "wheat"}};
+        CHECK(p.find(a) != p.end());
+        CHECK(p.find(geoson::PropertyKey("crops")) == p.end());
+    }
+
+    SUBCASE("Keys are freed once unused") {
+        const std::string name = "geoson-test-transient-key";
+        const std::string *first;
+        {
+            geoson::PropertyKey k(name);
+            geoson::PropertyKey copy = k;
+            first = &copy.str();
+            CHECK(&geoson::PropertyKey(name).str() == first);
+        }
+        // a fresh string now; holding a sentinel key keeps the allocator from handing back the same block
+        geoson::PropertyKey other("geoson-test-other-key");
+        geoson::PropertyKey again(name);
+        CHECK(again.str() == name);
+        {
+            geoson::op::KeyScope scope;
+            geoson::PropertyKey a1("scoped"), a2("scoped");
+            CHECK(&a1.str() == &a2.str());
+        }
+        geoson::PropertyKey after("scoped");
+        CHECK(after == "scoped");
+    }
+
+    SUBCASE("Missing keys throw") {
+        geoson::Properties p{{"a", 1}};
+        CHECK_THROWS_AS(p.at("b"), std::out_of_range);
+    }
+}
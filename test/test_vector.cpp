@@ -2,8 +2,11 @@
 #include <doctest/doctest.h>
 
 #include "geoson/vector.hpp"
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <utility>
 
 TEST_CASE("Vector - Basic Construction") {
     concord::Datum datum{52.0, 5.0, 0.0};
@@ -86,7 +89,35 @@ TEST_CASE("Vector - Element Management") {
         auto blueItems = vector.filterByProperty("color", "blue");
         CHECK(blueItems.size() == 1);
     }
-    
+
+    SUBCASE("Views reference the stored elements") {
+        vector.addPoint({10.0, 10.0, 0.0}, "marker", {{"color", "red"}});
+        vector.addPolygon(concord::Polygon{std::vector<concord::Point>{{0, 0, 0}, {1, 0, 0}, {1, 1, 0}}}, "zone",
+                          {{"color", "red"}});
+        vector.addPoint({30.0, 30.0, 0.0}, "waypoint", {{"color", "blue"}});
+
+        static_assert(std::ranges::forward_range<decltype(vector.viewPoints())>);
+        const auto points = vector.viewPoints();
+        CHECK(points.count() == 2);
+        CHECK(&points.front() == &vector.getElement(0));
+
+        std::vector<size_t> red;
+        auto reds = vector.viewByProperty("color", "red");
+        for (auto it = reds.begin(); it != reds.end(); ++it)
+            red.push_back(it.index());
+        CHECK(red == std::vector<size_t>{0, 1});
+
+        CHECK(vector.viewPolygons().begin()->type == "zone");
+        CHECK(vector.viewElementsByType("marker").count() == 1);
+        CHECK(vector.viewLines().empty());
+        CHECK(vector.viewPaths().begin() == vector.viewPaths().end());
+        CHECK(vector.view([](const geoson::Element &e) { return e.type.size() > 6; }).count() == 1);
+        CHECK(std::ranges::count_if(vector.viewPoints(), [](const geoson::Element &e) {
+                  return e.properties.at("color") == "blue";
+              }) == 1);
+        CHECK(vector.getPoints().size() == points.count());
+    }
+
     SUBCASE("Remove elements") {
         vector.addPoint({10.0, 10.0, 0.0}, "marker");
         vector.addPoint({20.0, 20.0, 0.0}, "waypoint");
@@ -184,6 +215,93 @@ TEST_CASE("Vector - File I/O") {
         
         std::filesystem::remove(testFile);
     }
+
+    SUBCASE("Writes the same bytes as the equivalent FeatureCollection") {
+        geoson::FeatureCollection fc{datum, originalVector.getHeading(), {}, {}};
+        auto fieldProps = originalVector.getFieldProperties();
+        fieldProps["type"] = "field";
+        fc.features.push_back({originalVector.getFieldBoundary(), fieldProps});
+        for (const auto &element : originalVector)
+            fc.features.push_back({element.geometry, element.properties});
+
+        auto slurp = [](const std::filesystem::path &p) {
+            std::ifstream in(p, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(in), {});
+        };
+        std::filesystem::path expected = std::filesystem::temp_directory_path() / "test_vector_expected.geojson";
+        for (auto crs : {geoson::CRS::ENU, geoson::CRS::WGS}) {
+            originalVector.toFile(testFile, crs);
+            geoson::write(fc, expected, crs);
+            CHECK(slurp(testFile) == slurp(expected));
+        }
+        std::filesystem::remove(testFile);
+        std::filesystem::remove(expected);
+    }
+
+    SUBCASE("From an in-memory FeatureCollection") {
+        geoson::FeatureCollection fc{datum, {}, {}, {{"owner", "farm"}}};
+        fc.features.push_back({concord::Point{1.0, 2.0, 0.0}, {{"type", "tree"}}});
+        fc.features.push_back({fieldBoundary, {{"type", "field"}, {"name", "North"}}});
+        fc.features.push_back({concord::Point{3.0, 4.0, 0.0}, {}});
+
+        auto copied = geoson::Vector::fromFeatureCollection(fc);
+        auto moved = geoson::Vector::fromFeatureCollection(std::move(fc));
+        for (auto *v : {&copied, &moved}) {
+            CHECK(v->elementCount() == 2);
+            CHECK(v->getFieldProperties().at("name") == "North");
+            CHECK(v->getFieldBoundary().getPoints().size() == 4);
+            CHECK(v->getGlobalProperty("owner") == "farm");
+            CHECK(v->getElementsByType("tree").size() == 1);
+            CHECK(v->getElementsByType("unknown").size() == 1);
+        }
+    }
+}
+
+TEST_CASE("Vector - Field boundary selection") {
+    concord::Polygon plot{std::vector<concord::Point>{{0, 0, 0}, {1, 0, 0}, {1, 1, 0}}};
+    concord::Polygon field{std::vector<concord::Point>{{0, 0, 0}, {9, 0, 0}, {9, 9, 0}, {0, 9, 0}}};
+    auto loaded = [](geoson::FeatureCollection fc) {
+        std::filesystem::path file = std::filesystem::temp_directory_path() / "test_vector_boundary.geojson";
+        geoson::write(fc, file);
+        auto fromFile = geoson::Vector::fromFile(file);
+        std::filesystem::remove(file);
+        auto fromMemory = geoson::Vector::fromFeatureCollection(std::move(fc));
+        CHECK(fromFile.elementCount() == fromMemory.elementCount());
+        CHECK(fromFile.getFieldBoundary().getPoints().size() == fromMemory.getFieldBoundary().getPoints().size());
+        return fromFile;
+    };
+
+    SUBCASE("A field declared after the elements wins") {
+        geoson::FeatureCollection fc{{52.0, 5.0, 0.0}, {}, {}, {}};
+        fc.features.push_back({plot, {{"type", "plot"}}});
+        fc.features.push_back({concord::Point{1.0, 1.0, 0.0}, {{"type", "field"}}});
+        fc.features.push_back({field, {{"type", "field"}, {"name", "A"}}});
+        fc.features.push_back({field, {{"type", "field"}, {"name", "B"}}});
+        auto vector = loaded(fc);
+        CHECK(vector.getFieldProperties().at("name") == "A");
+        CHECK(vector.getFieldBoundary().getPoints().size() == 4);
+        CHECK(vector.elementCount() == 1);
+        CHECK(vector.getElement(size_t{0}).type == "plot");
+    }
+
+    SUBCASE("Without a field the first polygon is used and kept") {
+        geoson::FeatureCollection fc{{52.0, 5.0, 0.0}, {}, {}, {}};
+        fc.features.push_back({concord::Point{1.0, 1.0, 0.0}, {}});
+        fc.features.push_back({plot, {{"type", "plot"}}});
+        fc.features.push_back({field, {}});
+        auto vector = loaded(fc);
+        CHECK(vector.getFieldBoundary().getPoints().size() == 3);
+        CHECK(vector.getFieldProperties().at("type") == "plot");
+        CHECK(vector.elementCount() == 3);
+    }
+
+    SUBCASE("No polygon at all") {
+        geoson::FeatureCollection fc{{52.0, 5.0, 0.0}, {}, {}, {}};
+        fc.features.push_back({concord::Point{1.0, 1.0, 0.0}, {}});
+        CHECK_THROWS_WITH(geoson::Vector::fromFeatureCollection(fc), doctest::Contains("No polygon"));
+        CHECK_THROWS_WITH(geoson::Vector::fromFeatureCollection(geoson::FeatureCollection{}),
+                          doctest::Contains("No features"));
+    }
 }
 
 TEST_CASE("Vector - Error Handling") {
@@ -234,4 +352,406 @@ TEST_CASE("Vector - Iterators") {
         ++it;
         CHECK(it == vector.end());
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Vector - Spatial queries") {
+    std::vector<concord::Point> fieldPoints = {{0.0, 0.0, 0.0}, {1000.0, 0.0, 0.0}, {1000.0, 1000.0, 0.0}};
+    geoson::Vector vector(concord::Polygon{fieldPoints});
+
+    // a deterministic scatter of points, short lines, paths and squares; enough for a three-level tree
+    for (int i = 0; i < 2000; ++i) {
+        const double x = std::fmod(i * 37.3, 1000.0), y = std::fmod(i * 91.7, 1000.0);
+        switch (i % 4) {
+        case 0:
+            vector.addPoint({x, y, 0.0});
+            break;
+        case 1:
+            vector.addLine(concord::Line{concord::Point{x, y, 0.0}, concord::Point{x + 3.0, y + 1.0, 0.0}});
+            break;
+        case 2:
+            vector.addPath(
+                concord::Path{std::vector<concord::Point>{{x, y, 0.0}, {x + 2.0, y, 0.0}, {x, y + 2.0, 0.0}}});
+            break;
+        default:
+            vector.addPolygon(concord::Polygon{std::vector<concord::Point>{
+                {x, y, 0.0}, {x + 4.0, y, 0.0}, {x + 4.0, y + 4.0, 0.0}, {x, y + 4.0, 0.0}}});
+        }
+    }
+
+    auto distanceTo = [&](size_t i, const concord::Point &p) {
+        return geoson::op::distance(vector.getElement(i).geometry, p.x, p.y);
+    };
+    const std::vector<concord::Point> probes = {{500.0, 500.0, 0.0}, {0.0, 0.0, 0.0}, {-50.0, 1200.0, 0.0}};
+
+    SUBCASE("Box matches a full scan") {
+        concord::Point lo{200.0, 300.0, 0.0}, hi{260.0, 420.0, 0.0};
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < vector.elementCount(); ++i) {
+            auto b = geoson::op::bounds(vector.getElement(i).geometry);
+            if (b.min_x <= hi.x && b.max_x >= lo.x && b.min_y <= hi.y && b.max_y >= lo.y)
+                expected.push_back(i);
+        }
+        CHECK_FALSE(expected.empty());
+        CHECK(vector.elementsInBox(lo, hi) == expected);
+        CHECK(vector.elementsInBox(hi, lo) == expected); // corners in any order
+    }
+
+    SUBCASE("Radius matches a full scan") {
+        for (auto const &p : probes) {
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < vector.elementCount(); ++i)
+                if (distanceTo(i, p) <= 25.0)
+                    expected.push_back(i);
+            CHECK(vector.elementsWithin(p, 25.0) == expected);
+        }
+    }
+
+    SUBCASE("Nearest matches a full scan") {
+        for (auto const &p : probes) {
+            auto nearest = vector.nearestElements(p, 10);
+            REQUIRE(nearest.size() == 10);
+            std::vector<double> all;
+            for (size_t i = 0; i < vector.elementCount(); ++i)
+                all.push_back(distanceTo(i, p));
+            std::sort(all.begin(), all.end());
+            for (size_t j = 0; j < nearest.size(); ++j)
+                CHECK(distanceTo(nearest[j], p) == all[j]);
+        }
+        CHECK(vector.nearestElements(probes[0], 0).empty());
+        CHECK(vector.nearestElements(probes[0], 5000).size() == vector.elementCount());
+    }
+
+    SUBCASE("Polygon interiors are at distance zero") {
+        auto inside = vector.elementsWithin({3.0 * 37.3 + 2.0, 3.0 * 91.7 + 2.0, 0.0}, 0.0);
+        CHECK(std::find(inside.begin(), inside.end(), size_t{3}) != inside.end());
+    }
+
+    SUBCASE("Index follows changes") {
+        concord::Point far{5000.0, 5000.0, 0.0};
+        CHECK(vector.elementsWithin(far, 1.0).empty());
+        vector.addPoint(far, "beacon");
+        auto hit = vector.elementsWithin(far, 1.0);
+        REQUIRE(hit.size() == 1);
+        CHECK(vector.getElement(hit[0]).type == "beacon");
+
+        vector.modifyElement(hit[0], [](geoson::Element &e) { e.geometry = concord::Point{-5000.0, 0.0, 0.0}; });
+        CHECK(vector.elementsWithin(far, 1.0).empty());
+        vector.removeElement(0);
+        CHECK(vector.nearestElements({-5000.0, 0.0, 0.0}, 1) == std::vector<size_t>{vector.elementCount() - 1});
+        vector.clearElements();
+        CHECK(vector.elementsInBox({-1e9, -1e9, 0.0}, {1e9, 1e9, 0.0}).empty());
+    }
+
+    SUBCASE("Pruning and adding between queries matches a full scan") {
+        std::vector<geoson::ElementHandle> handles;
+        for (size_t i = 0; i < vector.elementCount(); ++i)
+            handles.push_back(vector.handleAt(i));
+        concord::Point lo{100.0, 100.0, 0.0}, hi{600.0, 700.0, 0.0};
+        for (int round = 0; round < 40; ++round) {
+            // enough changes over the rounds to go through several repacks
+            for (int j = 0; j < 25; ++j)
+                vector.removeElement(handles[size_t(round * 25 + j) * 7 % handles.size()]);
+            for (int j = 0; j < 10; ++j)
+                vector.addPoint({std::fmod(round * 53.1 + j * 11.0, 1000.0), std::fmod(j * 97.3, 1000.0), 0.0});
+            vector.modifyElement(size_t(round) % vector.elementCount(),
+                                 [&](geoson::Element &e) { e.geometry = concord::Point{300.0 + round, 400.0, 0.0}; });
+
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < vector.elementCount(); ++i) {
+                auto b = geoson::op::bounds(vector.getElement(i).geometry);
+                if (b.min_x <= hi.x && b.max_x >= lo.x && b.min_y <= hi.y && b.max_y >= lo.y)
+                    expected.push_back(i);
+            }
+            REQUIRE(vector.elementsInBox(lo, hi) == expected);
+
+            auto nearest = vector.nearestElements(probes[0], 5);
+            std::vector<double> all;
+            for (size_t i = 0; i < vector.elementCount(); ++i)
+                all.push_back(distanceTo(i, probes[0]));
+            std::sort(all.begin(), all.end());
+            REQUIRE(nearest.size() == 5);
+            for (size_t j = 0; j < nearest.size(); ++j)
+                REQUIRE(distanceTo(nearest[j], probes[0]) == all[j]);
+        }
+    }
+}
+
+TEST_CASE("Vector - Type and property index") {
+    geoson::Vector vector(concord::Polygon{std::vector<concord::Point>{{0, 0, 0}, {10, 0, 0}, {10, 10, 0}}});
+    for (int i = 0; i < 30; ++i)
+        vector.addPoint({double(i), 0.0, 0.0}, i % 3 == 0 ? "obstacle" : "marker",
+                        {{"color", i % 2 ? "red" : "blue"}, {"id", i}});
+
+    auto scanType = [&](const std::string &type) {
+        std::vector<size_t> r;
+        for (size_t i = 0; i < vector.elementCount(); ++i)
+            if (std::as_const(vector).getElement(i).type == type)
+                r.push_back(i);
+        return r;
+    };
+
+    CHECK(vector.indicesOfType("obstacle") == scanType("obstacle"));
+    CHECK(vector.getElementsByType("obstacle").size() == 10);
+    CHECK(vector.indicesOfType("nothing").empty());
+
+    SUBCASE("Appends extend the index") {
+        vector.addPoint({99.0, 0.0, 0.0}, "obstacle");
+        CHECK(vector.indicesOfType("obstacle").back() == 30);
+        CHECK(vector.indicesOfType("obstacle") == scanType("obstacle"));
+    }
+
+    SUBCASE("Removal and mutation update it in place") {
+        vector.removeElement(0);
+        CHECK(vector.indicesOfType("obstacle") == scanType("obstacle"));
+        vector.modifyElement(0, [](geoson::Element &e) { e.type = "obstacle"; });
+        CHECK(vector.indicesOfType("obstacle").front() == 0);
+        vector.clearElements();
+        CHECK(vector.indicesOfType("obstacle").empty());
+        vector.addPoint({1.0, 1.0, 0.0}, "obstacle");
+        CHECK(vector.indicesOfType("obstacle") == std::vector<size_t>{0});
+    }
+
+    SUBCASE("Property index agrees with the scan") {
+        auto scanned = vector.indicesWithProperty("color", "red");
+        auto scannedId = vector.indicesWithProperty("id", "7");
+        vector.indexProperty("color");
+        vector.indexProperty("id");
+        CHECK(vector.indicesWithProperty("color", "red") == scanned);
+        CHECK(vector.indicesWithProperty("id", "7") == scannedId);
+        CHECK(scannedId == std::vector<size_t>{7});
+        CHECK(vector.filterByProperty("color", "blue").size() == 15);
+        CHECK(vector.filterByProperty("color", "green").empty());
+
+        vector.addPoint({0.0, 5.0, 0.0}, "marker", {{"color", "red"}});
+        CHECK(vector.indicesWithProperty("color", "red").size() == 16);
+
+        auto copy = vector;
+        copy.removeElement(1);
+        CHECK(copy.indicesWithProperty("color", "red").size() == 15);
+        CHECK(vector.indicesWithProperty("color", "red").size() == 16);
+    }
+
+    SUBCASE("Interleaved edits keep agreeing with the scan") {
+        vector.indexProperty("color");
+        auto scanColor = [&](const std::string &color) {
+            std::vector<size_t> r;
+            for (size_t i = 0; i < vector.elementCount(); ++i) {
+                auto const &props = vector.getElement(i).properties;
+                if (props.find("color") != props.end() && props.at("color") == color)
+                    r.push_back(i);
+            }
+            return r;
+        };
+        std::vector<geoson::ElementHandle> handles;
+        for (size_t i = 0; i < vector.elementCount(); ++i)
+            handles.push_back(vector.handleAt(i));
+        for (int step = 0; step < 60; ++step) {
+            switch (step % 4) {
+            case 0:
+                vector.removeElement(handles[(step * 7) % handles.size()]);
+                break;
+            case 1:
+                handles.push_back(vector.addPoint({double(step), 1.0, 0.0}, step % 8 == 1 ? "obstacle" : "marker",
+                                                  {{"color", "red"}}));
+                break;
+            case 2:
+                if (vector.elementCount() > 0)
+                    vector.modifyElement(size_t(step) % vector.elementCount(), [&](geoson::Element &e) {
+                        e.type = e.type == "obstacle" ? "marker" : "obstacle";
+                        e.properties["color"] = step % 3 ? "blue" : "red";
+                    });
+                break;
+            default:
+                if (vector.elementCount() > 3)
+                    vector.removeElement(size_t{3});
+            }
+            REQUIRE(vector.indicesOfType("obstacle") == scanType("obstacle"));
+            REQUIRE(vector.indicesOfType("marker") == scanType("marker"));
+            REQUIRE(vector.indicesWithProperty("color", "red") == scanColor("red"));
+            REQUIRE(vector.indicesWithProperty("color", "blue") == scanColor("blue"));
+        }
+    }
+
+    SUBCASE("Edits through mutable references are picked up") {
+        CHECK(vector.indicesOfType("obstacle") == scanType("obstacle")); // built
+        vector.getElement(2).type = "obstacle";
+        CHECK(vector.indicesOfType("obstacle") == scanType("obstacle"));
+        vector.getElement(vector.handleAt(4)).type = "obstacle";
+        CHECK(vector.indicesOfType("obstacle") == scanType("obstacle"));
+
+        CHECK(vector.elementsWithin({1e6, 1e6, 0.0}, 1.0).empty());
+        for (auto &element : vector)
+            if (element.type == "obstacle")
+                element.geometry = concord::Point{1e6, 1e6, 0.0};
+        CHECK(vector.elementsWithin({1e6, 1e6, 0.0}, 1.0) == scanType("obstacle"));
+        for (auto &element : vector)
+            element.type = "marker";
+        CHECK(vector.indicesOfType("obstacle").empty());
+    }
+
+    SUBCASE("A throwing edit is still indexed") {
+        CHECK_THROWS_AS(vector.modifyElement(1,
+                                             [](geoson::Element &e) {
+                                                 e.type = "obstacle";
+                                                 throw std::runtime_error("half done");
+                                             }),
+                        std::runtime_error);
+        CHECK(vector.indicesOfType("obstacle") == scanType("obstacle"));
+    }
+}
+
+TEST_CASE("Vector - Element handles") {
+    geoson::Vector vector(concord::Polygon{std::vector<concord::Point>{{0, 0, 0}, {10, 0, 0}, {10, 10, 0}}});
+    std::vector<geoson::ElementHandle> handles;
+    for (int i = 0; i < 10; ++i)
+        handles.push_back(vector.addPoint({double(i), 0.0, 0.0}, i % 2 ? "odd" : "even", {{"id", i}}));
+
+    SUBCASE("Handles survive removal of other elements") {
+        CHECK(vector.removeElement(handles[2]));
+        CHECK(vector.elementCount() == 9);
+        CHECK_FALSE(vector.contains(handles[2]));
+        CHECK_FALSE(vector.removeElement(handles[2]));
+        CHECK_THROWS_AS(vector.getElement(handles[2]), std::out_of_range);
+        for (int i = 0; i < 10; ++i) {
+            if (i == 2)
+                continue;
+            CHECK(vector.getElement(handles[i]).properties.at("id") == i);
+            CHECK(vector.handleAt(*vector.indexOf(handles[i])) == handles[i]);
+        }
+        CHECK(vector.indicesOfType("even").size() == 4);
+    }
+
+    SUBCASE("Removal by position keeps handles in step") {
+        vector.removeElement(size_t{0});
+        CHECK_FALSE(vector.contains(handles[0]));
+        CHECK(vector.indexOf(handles[9]) == 8u);
+        CHECK(vector.getElement(handles[9]).properties.at("id") == 9);
+    }
+
+    SUBCASE("Reused slots do not revive old handles") {
+        vector.removeElement(handles[4]);
+        auto fresh = vector.addPoint({50.0, 0.0, 0.0});
+        CHECK(fresh.slot == handles[4].slot);
+        CHECK_FALSE(vector.contains(handles[4]));
+        CHECK(vector.contains(fresh));
+        CHECK(vector.getElement(fresh).type == "point");
+    }
+
+    SUBCASE("Pruning everything") {
+        for (auto h : handles)
+            CHECK(vector.removeElement(h));
+        CHECK_FALSE(vector.hasElements());
+        vector.addPoint({1.0, 1.0, 0.0});
+        vector.clearElements();
+        CHECK(vector.elementsInBox({-1e9, -1e9, 0.0}, {1e9, 1e9, 0.0}).empty());
+    }
+}
+
+TEST_CASE("Vector - Bulk insert") {
+    geoson::Vector vector(concord::Polygon{std::vector<concord::Point>{{0, 0, 0}, {10, 0, 0}, {10, 10, 0}}});
+    vector.addPoint({0.0, 0.0, 0.0}, "marker");
+    auto obstacles = vector.indicesOfType("obstacle");
+    CHECK(obstacles.empty());
+
+    SUBCASE("Elements") {
+        std::vector<geoson::Element> batch;
+        for (int i = 0; i < 5; ++i)
+            batch.emplace_back(concord::Point{double(i), 1.0, 0.0}, geoson::Properties{{"id", i}}, "obstacle");
+
+        auto copied = vector.addElements(batch);
+        CHECK(batch.front().properties.size() == 1);
+        auto moved = vector.addElements(std::move(batch));
+        CHECK(copied.size() == 5);
+        CHECK(moved.size() == 5);
+        CHECK(vector.elementCount() == 11);
+        CHECK(vector.indicesOfType("obstacle").size() == 10);
+        CHECK(vector.getElement(moved[3]).properties.at("id") == 3);
+        CHECK(vector.elementsInBox({0.5, 0.5, 0.0}, {1.5, 1.5, 0.0}).size() == 2);
+    }
+
+    SUBCASE("Features") {
+        std::vector<geoson::Feature> batch{{concord::Point{1.0, 1.0, 0.0}, {{"type", "obstacle"}}},
+                                           {concord::Line{{0, 0, 0}, {1, 1, 0}}, {}}};
+        auto handles = vector.addElements(batch);
+        CHECK(vector.getElement(handles[0]).type == "obstacle");
+        CHECK(vector.getElement(handles[1]).type == "unknown");
+        CHECK(vector.getLines().size() == 1);
+    }
+}
+
+TEST_CASE("Vector - Bulk geometry operations") {
+    const concord::Datum datum{52.0, 5.0, 10.0};
+    geoson::Vector vector(concord::Polygon{std::vector<concord::Point>{{0, 0, 0}, {100, 0, 0}, {100, 80, 0}, {0, 80, 0}}},
+                          datum);
+    // enough elements to be split over several workers
+    for (int i = 0; i < 5000; ++i)
+        vector.addPoint({double(i % 100), double(i / 100), 1.0}, "marker");
+    vector.addPath(concord::Path{std::vector<concord::Point>{{0, 0, 0}, {10, 0.01, 0}, {20, 0, 0}, {30, 5, 0}}},
+                   "row");
+    vector.addLine(concord::Line{{0, 0, 0}, {1, 1, 1}}, "edge");
+    auto row = vector.handleAt(vector.elementCount() - 2);
+
+    SUBCASE("Bounds") {
+        auto b = vector.bounds();
+        CHECK(b.min_x == 0.0);
+        CHECK(b.max_x == 100.0);
+        CHECK(b.max_y == 80.0);
+        CHECK(b.max_z == 1.0);
+        auto serial = vector.bounds(1);
+        CHECK(serial.max_y == b.max_y);
+        CHECK(serial.min_z == b.min_z);
+    }
+
+    SUBCASE("Translate and rotate") {
+        vector.translate(5.0, -2.0, 1.0);
+        CHECK(vector.getFieldBoundary().getPoints()[1].x == 105.0);
+        CHECK(std::get<concord::Point>(vector.getElement(4999).geometry).y == 47.0);
+        CHECK(vector.getElement(row).type == "row");
+        CHECK(vector.elementsWithin({104.0, 47.0, 2.0}, 0.1).size() == 1); // index follows
+
+        vector.rotate(M_PI / 2);
+        auto p = std::get<concord::Point>(vector.getElement(4999).geometry);
+        CHECK(p.x == doctest::Approx(-47.0));
+        CHECK(p.y == doctest::Approx(104.0));
+        CHECK(vector.getHeading().yaw == doctest::Approx(M_PI / 2));
+    }
+
+    SUBCASE("Reproject keeps positions on the ground") {
+        const concord::Datum shifted{52.001, 5.002, 12.0};
+        const auto before = geoson::DatumTransform(datum).toWGS(std::get<concord::Point>(vector.getElement(4321).geometry));
+        vector.reproject(shifted);
+        CHECK(vector.getDatum().lat == shifted.lat);
+
+        const auto moved = std::get<concord::Point>(vector.getElement(4321).geometry);
+        const auto after = geoson::DatumTransform(shifted).toWGS(moved);
+        CHECK(after.lat == doctest::Approx(before.lat).epsilon(1e-12));
+        CHECK(after.lon == doctest::Approx(before.lon).epsilon(1e-12));
+        CHECK(after.alt == doctest::Approx(before.alt).epsilon(1e-6));
+        CHECK(moved.y == doctest::Approx(43.0 - 111.3).epsilon(0.01)); // the datum is 0.001 deg further north
+
+        vector.reproject(datum);
+        auto back = std::get<concord::Point>(vector.getElement(4321).geometry);
+        CHECK(back.x == doctest::Approx(21.0).epsilon(1e-9));
+        CHECK(back.y == doctest::Approx(43.0).epsilon(1e-9));
+        CHECK(back.z == doctest::Approx(1.0).epsilon(1e-6));
+    }
+
+    SUBCASE("A throwing kernel keeps the field boundary") {
+        const auto boundary = vector.getFieldBoundary().getPoints();
+        CHECK_THROWS_AS(vector.transformPoints([](concord::Point *, size_t) { throw std::runtime_error("no"); }),
+                        std::runtime_error);
+        const auto kept = vector.getFieldBoundary().getPoints();
+        REQUIRE(kept.size() == boundary.size());
+        for (size_t i = 0; i < kept.size(); ++i)
+            CHECK((kept[i].x == boundary[i].x && kept[i].y == boundary[i].y));
+        CHECK(vector.elementsWithin({21.0, 43.0, 1.0}, 0.1).size() == 1);
+    }
+
+    SUBCASE("Simplify") {
+        vector.simplify(0.1);
+        auto path = std::get<concord::Path>(vector.getElement(row).geometry).getPoints();
+        CHECK(path.size() == 3); // the 1 cm bump goes
+        CHECK(path[1].x == 20.0);
+        CHECK(vector.getFieldBoundary().getPoints().size() == 4);
+        CHECK(std::holds_alternative<concord::Line>(vector.getElement(vector.elementCount() - 1).geometry));
+    }
+}
@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <fstream>
 #include <nlohmann/json.hpp>
+#include <sstream>
 
 TEST_CASE("Writer - geometryToJson") {
     concord::Datum datum{52.0, 5.0, 0.0};
@@ -247,3 +248,271 @@ TEST_CASE("Writer - WriteFeatureCollection") {
         CHECK_THROWS_AS(geoson::WriteFeatureCollection(fc, "/invalid/path/file.geojson"), std::runtime_error);
     }
 }
+
+TEST_CASE("Writer - Streaming output matches dump") {
+    concord::Datum datum{52.0, 5.0, 0.0};
+    concord::Euler heading{0.0, 0.0, 0.1};
+
+    std::vector<geoson::Feature> features;
+    features.emplace_back(geoson::Feature{concord::Point{1.5, -0.0, 1e-5}, {{"name", "quote \" and \\ slash/"}}});
+    features.emplace_back(geoson::Feature{concord::Line{concord::Point{0, 0, 0}, concord::Point{1e20, 2.25, 0}},
+                                          {{"ctrl", "tab\tnl\n\x01"}, {"b", "1"}, {"a", "2"}}});
+    features.emplace_back(geoson::Feature{concord::Path{}, {}});
+    std::vector<concord::Point> ring{{0, 0, 0}, {10, 0, 0}, {0.1, 0.2, 0}};
+    features.emplace_back(geoson::Feature{concord::Polygon{ring}, {{"utf8", "caf\xc3\xa9"}}});
+    features.emplace_back(geoson::Feature{
+        concord::Point{0, 0, 0},
+        {{"n", -42}, {"x", 1.5}, {"ok", false},
+         {"nested", geoson::PropertyValue::fromJson(R"({"b":[1,{"c":null}],"a":2.0,"s":"t"})")}}});
+
+    geoson::FeatureCollection fc{datum, heading, std::move(features), {{"field", "north"}, {"heading", "override"}}};
+
+    SUBCASE("Compact stream, both CRS") {
+        for (auto crs : {geoson::CRS::ENU, geoson::CRS::WGS}) {
+            std::ostringstream os;
+            geoson::WriteFeatureCollection(fc, os, crs);
+            CHECK(os.str() == geoson::toJson(fc, crs).dump());
+        }
+    }
+
+    SUBCASE("FILE* output") {
+        std::FILE *fp = std::tmpfile();
+        REQUIRE(fp != nullptr);
+        geoson::WriteFeatureCollection(fc, fp, geoson::CRS::WGS);
+        std::string got(static_cast<std::size_t>(std::ftell(fp)), '\0');
+        std::rewind(fp);
+        CHECK(std::fread(got.data(), 1, got.size(), fp) == got.size());
+        std::fclose(fp);
+        CHECK(got == geoson::toJson(fc, geoson::CRS::WGS).dump());
+    }
+
+    SUBCASE("File output is pretty-printed dump") {
+        const std::filesystem::path test_file = "/tmp/test_stream_output.geojson";
+        geoson::WriteFeatureCollection(fc, test_file, geoson::CRS::ENU);
+        std::ifstream ifs(test_file, std::ios::binary);
+        std::string got((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        CHECK(got == geoson::toJson(fc, geoson::CRS::ENU).dump(2) + "\n");
+        ifs.close();
+        std::filesystem::remove(test_file);
+    }
+
+    SUBCASE("Empty collection") {
+        geoson::FeatureCollection empty{datum, heading, {}, {}};
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(empty, os);
+        CHECK(os.str() == geoson::toJson(empty).dump());
+    }
+
+    SUBCASE("Invalid UTF-8 is rejected like dump") {
+        geoson::FeatureCollection bad{datum, heading, {}, {{"name", "\xff"}}};
+        std::ostringstream os;
+        CHECK_THROWS_AS(geoson::WriteFeatureCollection(bad, os), nlohmann::json::type_error);
+    }
+}
+
+TEST_CASE("Writer - Number formatting") {
+    auto format = [](double v) {
+        char buf[32];
+        return std::string(buf, geoson::op::formatNumber(buf, v));
+    };
+    // the layouts of dump()
+    for (double v : {0.0, -0.0, 1.0, -12.5, 3000.0, 0.1, 0.0001, 0.00001, 123456789012345.0, 1e15, 1e16, 1e21,
+                     -2.5e-7, 1e100, 1.7976931348623157e308, 5e-324})
+        CHECK(format(v) == nlohmann::json(v).dump());
+    CHECK(format(0.0001) == "0.0001");
+    CHECK(format(0.00001) == "1e-05");
+    CHECK(format(1e15) == "1e+15");
+    CHECK(format(3000.0) == "3000.0");
+    CHECK(format(-1.25e-300) == "-1.25e-300");
+
+    // shortest digits that read back exactly, where Grisu2 can be a digit longer
+    for (double v : {564705354642731.2, 2.705999613401443e+16, 123.45678901234567, 52.0000001, -179.9999999}) {
+        const std::string s = format(v);
+        CHECK(std::stod(s) == v);
+        CHECK(s.size() <= nlohmann::json(v).dump().size());
+    }
+}
+
+TEST_CASE("Writer - FeatureWriter") {
+    concord::Datum datum{52.0, 5.0, 0.0};
+    geoson::CollectionHeader header{geoson::CRS::ENU, datum, concord::Euler{0.0, 0.0, 1.5}, {{"field", "north"}}};
+
+    SUBCASE("Header is written before any feature") {
+        std::ostringstream os;
+        geoson::FeatureWriter writer(os, header);
+        writer.flush();
+        CHECK(os.str().rfind("{\"type\":\"FeatureCollection\",\"properties\":{", 0) == 0);
+        CHECK(os.str().find("\"features\":[") != std::string::npos);
+        CHECK(writer.count() == 0);
+    }
+
+    SUBCASE("Features stream out and read back") {
+        std::stringstream ss;
+        {
+            geoson::FeatureWriter writer(ss, header);
+            for (int i = 0; i < 1000; ++i)
+                writer.write(geoson::Feature{concord::Point{double(i), 2.0, 0.0}, {{"id", std::to_string(i)}}});
+            CHECK(writer.count() == 1000);
+            writer.finish();
+            CHECK_THROWS_AS(writer.write(geoson::Feature{concord::Point{}, {}}), std::runtime_error);
+        }
+
+        ss.seekg(0);
+        auto fc = geoson::ReadFeatureCollection(ss);
+        REQUIRE(fc.features.size() == 1000);
+        CHECK(fc.heading.yaw == doctest::Approx(1.5));
+        CHECK(fc.global_properties["field"] == "north");
+        CHECK(fc.features[999].properties["id"] == "999");
+        CHECK(std::get<concord::Point>(fc.features[999].geometry).x == doctest::Approx(999.0));
+    }
+
+    SUBCASE("Destructor closes the document") {
+        std::ostringstream os;
+        {
+            geoson::FeatureWriter writer(os, header);
+            writer.write(geoson::Feature{concord::Point{1.0, 2.0, 3.0}, {}});
+        }
+        auto j = nlohmann::json::parse(os.str());
+        CHECK(j["features"].size() == 1);
+        CHECK(j["properties"]["crs"] == "ENU");
+    }
+
+    SUBCASE("File output in WGS") {
+        const std::filesystem::path test_file = "/tmp/test_feature_writer.geojson";
+        header.crs = geoson::CRS::WGS;
+        concord::ENU enu = concord::WGS{52.1, 5.1, 0.0}.toENU(datum);
+        {
+            geoson::FeatureWriter writer(test_file, header);
+            writer.write(geoson::Feature{concord::Point{enu.x, enu.y, enu.z}, {{"name", "p"}}});
+        }
+        auto fc = geoson::read(test_file);
+        REQUIRE(fc.features.size() == 1);
+        auto &p = std::get<concord::Point>(fc.features[0].geometry);
+        CHECK(p.x == doctest::Approx(enu.x));
+        CHECK(p.y == doctest::Approx(enu.y));
+        std::filesystem::remove(test_file);
+    }
+
+    SUBCASE("Write to invalid path throws") {
+        CHECK_THROWS_AS(geoson::FeatureWriter("/invalid/path/file.geojson", header), std::runtime_error);
+    }
+}
+
+TEST_CASE("Writer - WriteOptions") {
+    concord::Datum datum{52.0, 5.0, 0.0};
+    concord::Euler heading{0.0, 0.0, 0.0};
+    std::vector<geoson::Feature> features;
+    features.emplace_back(geoson::Feature{concord::Point{1.23456789, -0.0000004, 0.0}, {}});
+    features.emplace_back(geoson::Feature{concord::Point{10.0, 20.0, 3.14159}, {}});
+    geoson::FeatureCollection fc{datum, heading, std::move(features), {}};
+
+    auto write = [&](geoson::CRS crs, const geoson::WriteOptions &opts) {
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(fc, os, crs, opts);
+        return nlohmann::json::parse(os.str());
+    };
+
+    SUBCASE("Defaults match pretty dump, compact matches dump") {
+        std::ostringstream pretty, compact;
+        geoson::WriteFeatureCollection(fc, pretty, geoson::CRS::ENU, geoson::WriteOptions{});
+        geoson::WriteFeatureCollection(fc, compact, geoson::CRS::ENU, geoson::WriteOptions::compact());
+        CHECK(pretty.str() == geoson::toJson(fc).dump(2));
+        CHECK(compact.str() == geoson::toJson(fc).dump());
+    }
+
+    SUBCASE("ENU decimals") {
+        geoson::WriteOptions opts = geoson::WriteOptions::compact();
+        opts.decimals = 3;
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(fc, os, geoson::CRS::ENU, opts);
+        CHECK(os.str().find("[1.235,0.0,0.0]") != std::string::npos);
+        CHECK(os.str().find("[10.0,20.0,3.142]") != std::string::npos);
+    }
+
+    SUBCASE("WGS degree decimals") {
+        geoson::WriteOptions opts;
+        opts.degree_decimals = 7;
+        opts.decimals = 2;
+        auto j = write(geoson::CRS::WGS, opts);
+        for (auto &f : j["features"]) {
+            for (int i = 0; i < 2; ++i) {
+                double v = f["geometry"]["coordinates"][i].get<double>();
+                CHECK(v * 1e7 == doctest::Approx(std::round(v * 1e7)));
+            }
+        }
+    }
+
+    SUBCASE("Omit zero z") {
+        geoson::WriteOptions opts;
+        opts.emit_zero_z = false;
+        auto j = write(geoson::CRS::ENU, opts);
+        CHECK(j["features"][0]["geometry"]["coordinates"].size() == 2);
+        CHECK(j["features"][1]["geometry"]["coordinates"].size() == 3);
+
+        const std::filesystem::path test_file = "/tmp/test_write_options.geojson";
+        geoson::write(fc, test_file, opts);
+        auto back = geoson::read(test_file);
+        REQUIRE(back.features.size() == 2);
+        CHECK(std::get<concord::Point>(back.features[0].geometry).z == 0.0);
+        CHECK(std::get<concord::Point>(back.features[1].geometry).z == doctest::Approx(3.14159));
+        std::filesystem::remove(test_file);
+    }
+
+    SUBCASE("Omit zero z per geometry") {
+        geoson::FeatureCollection mixed{fc.datum, fc.heading, {}, {}};
+        mixed.features.push_back(
+            geoson::Feature{concord::Path{std::vector<concord::Point>{{0, 0, 0}, {1, 1, 0.5}, {2, 0, 0}}}, {}});
+        mixed.features.push_back(
+            geoson::Feature{concord::Path{std::vector<concord::Point>{{0, 0, 0}, {1, 1, 0.001}}}, {}});
+        geoson::WriteOptions opts;
+        opts.emit_zero_z = false;
+        opts.decimals = 2;
+        for (auto crs : {geoson::CRS::ENU, geoson::CRS::WGS}) {
+            std::ostringstream os;
+            geoson::WriteFeatureCollection(mixed, os, crs, opts);
+            auto j = nlohmann::json::parse(os.str());
+            if (crs == geoson::CRS::ENU) {
+                for (auto &pos : j["features"][0]["geometry"]["coordinates"])
+                    CHECK(pos.size() == 3); // one non-zero z keeps z on every position
+                for (auto &pos : j["features"][1]["geometry"]["coordinates"])
+                    CHECK(pos.size() == 2); // rounds to 0
+            }
+            CHECK(os.str() == [&] {
+                std::ostringstream cs;
+                geoson::WriteFeatureCollection(geoson::ColumnarCollection(mixed), cs, crs, opts);
+                return cs.str();
+            }());
+        }
+    }
+}
+
+TEST_CASE("Writer - Typed properties") {
+    concord::Datum datum{52.0, 5.0, 0.0};
+    geoson::FeatureCollection fc{datum, concord::Euler{0, 0, 0}, {}, {}};
+    fc.features.push_back(geoson::Feature{concord::Point{1, 2, 0},
+                                          {{"id", 7},
+                                           {"area", 2.5},
+                                           {"irrigated", true},
+                                           {"name", "plot"},
+                                           {"tags", geoson::PropertyValue::fromJson(R"(["a","b"])")}}});
+
+    SUBCASE("Values keep their JSON type") {
+        auto j = geoson::toJson(fc, geoson::CRS::ENU);
+        auto &props = j["features"][0]["properties"];
+        CHECK(props["id"] == 7);
+        CHECK(props["area"] == 2.5);
+        CHECK(props["irrigated"] == true);
+        CHECK(props["name"] == "plot");
+        CHECK(props["tags"] == nlohmann::json::array({"a", "b"}));
+    }
+
+    SUBCASE("Round trip keeps the kinds") {
+        std::ostringstream os;
+        geoson::WriteFeatureCollection(fc, os, geoson::CRS::ENU);
+        auto back = geoson::read_from_buffer(os.str());
+        REQUIRE(back.features.size() == 1);
+        CHECK(back.features[0].properties == fc.features[0].properties);
+        CHECK(back.features[0].properties.at("id").kind() == geoson::PropertyValue::Kind::Integer);
+        CHECK(back.features[0].properties.at("tags") == R"(["a","b"])");
+    }
+}